@@ -25,6 +25,17 @@
 #include <quadmath.h>
 #endif
 
+//
+// Precision (in bits) from which division and square root use Newton iteration rather than
+// long division and the bit by bit integer square root:
+//
+#ifndef BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVISION_CUTOFF
+#  define BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVISION_CUTOFF 4000
+#endif
+#ifndef BOOST_MP_CPP_BIN_FLOAT_NEWTON_SQRT_CUTOFF
+#  define BOOST_MP_CPP_BIN_FLOAT_NEWTON_SQRT_CUTOFF 64
+#endif
+
 namespace boost{ namespace multiprecision{ namespace backends{
 
 enum digit_base_type
@@ -834,6 +845,115 @@ inline void eval_subtract(cpp_bin_float<Digits, DigitBase, Allocator, Exponent,
    return eval_subtract(res, res, a);
 }
 
+namespace detail{
+
+//
+// Returns true if the bits [first, last) of p are neither all zeros nor all ones, in which case
+// adding anything less than 2^first to p can neither carry past bit last, nor turn bits below
+// last which are not all zero into all zeros.
+//
+inline bool guard_bits_are_mixed(const limb_type* p, unsigned first, unsigned last)
+{
+   bool any_set = false;
+   bool any_clear = false;
+   for(unsigned i = first / bits_per_limb; i <= (last - 1) / bits_per_limb; ++i)
+   {
+      limb_type mask = ~static_cast<limb_type>(0u);
+      if(i == first / bits_per_limb)
+         mask &= mask << (first % bits_per_limb);
+      if((i == (last - 1) / bits_per_limb) && (last % bits_per_limb))
+         mask &= (static_cast<limb_type>(1u) << (last % bits_per_limb)) - 1;
+      if(p[i] & mask)
+         any_set = true;
+      if((p[i] & mask) != mask)
+         any_clear = true;
+   }
+   return any_set && any_clear;
+}
+//
+// Forms the short product of a and b in r's limbs, taking the scratch space from r's allocator for
+// variable precision types, and from the stack or std::allocator for fixed ones, as the cpp_int
+// multiplication routines do:
+//
+template <class DoubleInt>
+limb_type multiply_short(DoubleInt& r, const limb_type* a, const limb_type* b, unsigned n, unsigned c, const mpl::false_&)
+{
+   unsigned storage_size = multiply_short_storage(n, c);
+   if(!storage_size)
+      return multiply_short_limbs(r.limbs(), a, b, n, c, 0);
+   scoped_limb_storage<typename DoubleInt::allocator_type> storage(r.allocator(), storage_size);
+   return multiply_short_limbs(r.limbs(), a, b, n, c, storage.data());
+}
+template <class DoubleInt>
+limb_type multiply_short(DoubleInt& r, const limb_type* a, const limb_type* b, unsigned n, unsigned c, const mpl::true_&)
+{
+   static const unsigned stack_size = 10 * DoubleInt::internal_limb_count + 64 > 4096 ? 4096 : 10 * DoubleInt::internal_limb_count + 64;
+   unsigned storage_size = multiply_short_storage(n, c);
+   if(storage_size > stack_size)
+   {
+      scoped_limb_storage<std::allocator<limb_type> > storage(std::allocator<limb_type>(), storage_size);
+      return multiply_short_limbs(r.limbs(), a, b, n, c, storage.data());
+   }
+   limb_type storage[stack_size];
+   return multiply_short_limbs(r.limbs(), a, b, n, c, storage);
+}
+//
+// Sets r to the product of the bit_count bit normalized mantissas a and b with enough of its low
+// half left out that r may fall short of the true product, but is certain to round to the same
+// result as it does.  Returns false, leaving r unspecified, if the product is too close to a
+// rounding boundary for that, or the precision is too low for the short product to help:
+//
+template <class DoubleInt, class Int>
+typename enable_if_c<!is_trivial_cpp_int<Int>::value, bool>::type multiply_high(DoubleInt& r, const Int& a, const Int& b, unsigned bit_count)
+{
+   using default_ops::eval_msb;
+
+   static const unsigned guard_bits = 32;
+   unsigned n = (bit_count + bits_per_limb - 1) / bits_per_limb;
+   if(use_ntt_multiply(n, n))
+      return false;
+   BOOST_ASSERT((a.size() == n) && (b.size() == n));
+   //
+   // The product of two normalized mantissas has its most significant bit at 2 * bit_count - 2
+   // or above, so the rounding bit is at bit_count - 2 or above.  Choose the first column c of
+   // the short product so that the error, which is less than (2n - 1 - c) * B^(c + 1) (see
+   // multiply_short_limbs), lies at least guard_bits below that:
+   //
+   unsigned c = bit_count > guard_bits + 2 + bits_per_limb ? (bit_count - guard_bits - 2) / bits_per_limb - 1 : 0;
+   unsigned first = 0;
+   while(c)
+   {
+      unsigned count_bits = 0;
+      for(unsigned v = 2 * n - 1 - c; v; v >>= 1)
+         ++count_bits;
+      first = (c + 1) * bits_per_limb + count_bits;
+      if(first + guard_bits <= bit_count - 2)
+         break;
+      --c;
+   }
+   if(!c)
+      return false;
+
+   r.resize(2 * n, 2 * n);
+   limb_type top = multiply_short(r, a.limbs(), b.limbs(), n, c, mpl::bool_<!DoubleInt::variable>());
+   if(r.size() == 2 * n)
+      r.limbs()[2 * n - 1] = top;
+   else
+   {
+      // The full product fits in 2n - 1 limbs, and the short one is no larger:
+      BOOST_ASSERT(top == 0);
+   }
+   r.normalize();
+   return guard_bits_are_mixed(r.limbs(), first, eval_msb(r) - bit_count);
+}
+template <class DoubleInt, class Int>
+inline typename enable_if_c<is_trivial_cpp_int<Int>::value, bool>::type multiply_high(DoubleInt&, const Int&, const Int&, unsigned)
+{
+   return false;
+}
+
+}
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
 inline void eval_multiply(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &a, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &b)
 {
@@ -909,7 +1029,12 @@ inline void eval_multiply(cpp_bin_float<Digits, DigitBase, Allocator, Exponent,
    }
 
    typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type dt;
-   eval_multiply(dt, a.bits(), b.bits());
+   //
+   // Only the high half of the product survives rounding, so try a short product first, and
+   // fall back on the full product when that is too close to a rounding boundary:
+   //
+   if(!detail::multiply_high(dt, a.bits(), b.bits(), cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count))
+      eval_multiply(dt, a.bits(), b.bits());
    res.exponent() = a.exponent() + b.exponent() - (Exponent)cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + 1;
    copy_and_round(res, dt);
    res.check_invariants();
@@ -979,6 +1104,207 @@ inline typename enable_if_c<is_signed<S>::value>::type eval_multiply(cpp_bin_flo
    eval_multiply(res, res, b);
 }
 
+namespace detail{
+
+//
+// Division and square root by Newton iteration on the mantissas.  The iterations work in a
+// signed integer type with room for a little more than the double width product, and are
+// carried bits_per_limb guard bits beyond the precision of the result.  Each step doubles the
+// precision of the one below it (plus a few bits), so the cost is dominated by the last step.
+// The result then carries an error of a few units in the last guard bit, and rounds correctly
+// unless the guard bits lie within 2^newton_error_bits of a rounding boundary, in which case
+// the caller falls back on the exact method:
+//
+template <class Float>
+struct newton_rep_type;
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+struct newton_rep_type<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+{
+   static const unsigned bits = 2 * cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + 4 * bits_per_limb;
+   typedef cpp_int_backend<is_void<Allocator>::value ? bits : 0, bits, signed_magnitude, unchecked, Allocator> type;
+};
+
+static const unsigned newton_guard_bits = bits_per_limb;
+static const unsigned newton_error_bits = 16;
+
+//
+// Sets x to within 2 of 2^(2p) / v, where v has exactly p bits.  With h a little over p / 2,
+// x_h ~ 2^(2h) / v_h from the top h bits of v, and e = 2^(p+h) - v * x_h, the step is:
+//
+// x = x_h * 2^(p-h) + x_h * e / 2^(2h)
+//
+template <class Int>
+void newton_reciprocal(Int& x, const Int& v, unsigned p)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_subtract;
+   using default_ops::eval_add;
+   using default_ops::eval_divide;
+
+   Int t;
+   t = static_cast<limb_type>(1u);
+   if(p <= 2 * bits_per_limb)
+   {
+      eval_left_shift(t, 2 * p);
+      eval_divide(x, t, v);
+      return;
+   }
+   unsigned h = p / 2 + 8;
+   Int xh, e(v);
+   eval_right_shift(e, p - h);
+   newton_reciprocal(xh, e, h);
+   eval_multiply(e, v, xh);
+   eval_left_shift(t, p + h);
+   eval_subtract(e, t, e);
+   // Only the top bits of e matter, which keeps the second product small:
+   eval_right_shift(e, p - h);
+   eval_multiply(t, xh, e);
+   eval_right_shift(t, 3 * h - p);
+   x = xh;
+   eval_left_shift(x, p - h);
+   eval_add(x, t);
+}
+//
+// Sets y to within 3 of 2^(2p) / sqrt(a), where a has 2p - 1 or 2p bits.  With h a little over
+// p / 2, y_h ~ 2^(2h) / sqrt(a_h) from the top 2h bits of a, the step is:
+//
+// y = y_h + y_h * (1 - a * y_h^2) / 2
+//
+// where a is truncated to p + 10 bits, which is all the product needs:
+//
+template <class Int>
+void newton_inverse_sqrt(Int& y, const Int& a, unsigned p)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_subtract;
+   using default_ops::eval_add;
+   using default_ops::eval_msb;
+   using default_ops::eval_convert_to;
+
+   if(p <= 48)
+   {
+      // The hardware square root of the top 62 bits is good for 50 or so:
+      Int t(a);
+      int shift = static_cast<int>(eval_msb(a)) - 61;
+      if(shift > 0)
+         eval_right_shift(t, shift);
+      else
+         shift = 0;
+      boost::ulong_long_type ta;
+      eval_convert_to(&ta, t);
+      double ad = std::ldexp(static_cast<double>(ta), shift - 2 * static_cast<int>(p));
+      y = static_cast<boost::ulong_long_type>(std::ldexp(1 / std::sqrt(ad), static_cast<int>(p)));
+      return;
+   }
+   unsigned h = p / 2 + 8;
+   unsigned l = p + 10;
+   Int yh, e(a), t;
+   eval_right_shift(e, 2 * (p - h));
+   newton_inverse_sqrt(yh, e, h);
+   eval_multiply(t, yh, yh);
+   e = a;
+   eval_right_shift(e, 2 * p - l);
+   eval_multiply(e, t);
+   t = static_cast<limb_type>(1u);
+   eval_left_shift(t, l + 2 * h);
+   eval_subtract(e, t, e);
+   eval_right_shift(e, l - 8);
+   eval_multiply(t, yh, e);
+   eval_right_shift(t, 3 * h - p + 9);
+   y = yh;
+   eval_left_shift(y, p - h);
+   eval_add(y, t);
+}
+//
+// Sets q to u * 2^(bit_count + g) / v, where u and v are normalized mantissas and g is
+// newton_guard_bits, to within 2.  Returns false if that is not enough to round q correctly
+// to bit_count bits.  Rather than carry the reciprocal to full precision we follow Karp and
+// Markstein: with x_h the reciprocal of v to a little over half the precision,
+//
+// y0 = u * x_h, r = u - v * y0, q = y0 + x_h * r
+//
+// which needs only one product (v * y0) larger than half size:
+//
+template <class Int, class Rep>
+bool newton_divide(Int& q, const Rep& u, const Rep& v, unsigned bit_count)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_subtract;
+   using default_ops::eval_add;
+   using default_ops::eval_msb;
+
+   static const unsigned g = newton_guard_bits;
+   unsigned h = (bit_count + g) / 2 + 8;
+   if(h + 8 > bit_count)
+      return false;  // Too few bits to split
+   Int xh, y0, r, t(v);
+   eval_right_shift(t, bit_count - h);
+   newton_reciprocal(xh, t, h);
+   // y0 = u * x_h from the top h bits of u, to h fractional bits:
+   t = u;
+   eval_right_shift(t, bit_count - h);
+   eval_multiply(y0, t, xh);
+   eval_right_shift(y0, h);
+   // r = u * 2^h - v * y0, which is of the order of 2^bit_count:
+   t = v;
+   eval_multiply(r, t, y0);
+   t = u;
+   eval_left_shift(t, h);
+   eval_subtract(r, t, r);
+   // q = y0 * 2^(bit_count + g - h) + x_h * r / 2^(2h - g), with r first truncated to the bits which matter:
+   eval_right_shift(r, h - g - 5);
+   eval_multiply(t, xh, r);
+   eval_right_shift(t, h + 5);
+   q = y0;
+   eval_left_shift(q, bit_count + g - h);
+   eval_add(q, t);
+   return guard_bits_are_mixed(q.limbs(), newton_error_bits, eval_msb(q) - bit_count);
+}
+//
+// Sets s to sqrt(t) * 2^g, where t has 2 * bit_count - 1 or 2 * bit_count bits and g is
+// newton_guard_bits, to within 3.  Returns false if that is not enough to round s correctly
+// to bit_count bits.  Again the inverse square root y_h is only needed to half precision:
+// with a = t * 2^(2g),
+//
+// s0 = a * y_h, d = a - s0^2, s = s0 + y_h * d / 2
+//
+template <class Int, class Rep>
+bool newton_sqrt(Int& s, const Rep& t, unsigned bit_count)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_subtract;
+   using default_ops::eval_add;
+   using default_ops::eval_msb;
+
+   static const unsigned g = newton_guard_bits;
+   unsigned p = bit_count + g;
+   unsigned h = p / 2 + 8;
+   Int yh, s0, d(t), a;
+   eval_left_shift(d, 2 * g);
+   a = d;
+   eval_right_shift(d, 2 * (p - h));
+   newton_inverse_sqrt(yh, d, h);
+   // s0 = sqrt(a) / 2^(p-h) to h bits, from the top h + 8 bits of a:
+   eval_right_shift(d, h - 8);
+   eval_multiply(s0, d, yh);
+   eval_right_shift(s0, h + 8);
+   // d = a - s0^2 * 2^(2(p-h)), which is of the order of 2^(2p-h):
+   eval_multiply(d, s0, s0);
+   eval_left_shift(d, 2 * (p - h));
+   eval_subtract(d, a, d);
+   // s = s0 * 2^(p-h) + y_h * d / 2^(p+h+1), with d first truncated to the bits which matter:
+   eval_right_shift(d, p - 5);
+   eval_multiply(a, yh, d);
+   eval_right_shift(a, h + 6);
+   s = s0;
+   eval_left_shift(s, p - h);
+   eval_add(s, a);
+   return guard_bits_are_mixed(s.limbs(), newton_error_bits, eval_msb(s) - bit_count);
+}
+
+}
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
 inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &u, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &v)
 {
@@ -1089,6 +1415,20 @@ inline void eval_divide(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, Mi
    }
    res.exponent() = u.exponent() - v.exponent() - 1;
    res.sign() = u.sign() != v.sign();
+   if(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count >= BOOST_MP_CPP_BIN_FLOAT_NEWTON_DIVISION_CUTOFF)
+   {
+      //
+      // At high precision multiplying by a reciprocal from Newton iteration is cheaper than
+      // long division, and usually gives a quotient which can be rounded directly:
+      //
+      typename detail::newton_rep_type<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >::type nq;
+      if(detail::newton_divide(nq, u.bits(), v.bits(), cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count))
+      {
+         res.exponent() -= static_cast<Exponent>(detail::newton_guard_bits);
+         copy_and_round(res, nq);
+         return;
+      }
+   }
    //
    // Now get the quotient and remainder:
    //
@@ -1565,6 +1905,19 @@ inline typename enable_if_c<is_signed<I>::value>::type eval_ldexp(cpp_bin_float<
       eval_ldexp(res, arg, static_cast<Exponent>(e));
 }
 
+//
+// Conversion of the non-negative integer results of binary splitting (see default_ops::eval_integer_ratio),
+// which we can round directly rather than assembling from pieces:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, class Int>
+inline void eval_integer_to_float(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const Int& n, unsigned)
+{
+   Int t(n);
+   res.sign() = false;
+   res.exponent() = cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count - 1;
+   copy_and_round(res, t);
+}
+
 /*
 * Sign manipulation
 */
@@ -1631,6 +1984,24 @@ inline void eval_sqrt(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE
 
    typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::double_rep_type t(arg.bits()), r, s;
    eval_left_shift(t, arg.exponent() & 1 ? cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count : cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count - 1);
+   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_type ae = arg.exponent();
+   res.exponent() = ae / 2;
+   if((ae & 1) && (ae < 0))
+      --res.exponent();
+   if(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count >= BOOST_MP_CPP_BIN_FLOAT_NEWTON_SQRT_CUTOFF)
+   {
+      //
+      // Inverse square root by Newton iteration, which usually gives a root that can be
+      // rounded directly:
+      //
+      typename detail::newton_rep_type<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >::type ns;
+      if(detail::newton_sqrt(ns, t, cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count))
+      {
+         res.exponent() -= static_cast<typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_type>(detail::newton_guard_bits);
+         copy_and_round(res, ns);
+         return;
+      }
+   }
    eval_integer_sqrt(s, r, t);
 
    if(!eval_bit_test(s, cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count))
@@ -1641,10 +2012,6 @@ inline void eval_sqrt(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE
          eval_increment(s);
       }
    }
-   typename cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::exponent_type ae = arg.exponent();
-   res.exponent() = ae / 2;
-   if((ae & 1) && (ae < 0))
-      --res.exponent();
    copy_and_round(res, s);
 }
 
@@ -1791,6 +2158,16 @@ struct expression_template_default<cpp_bin_float<Digits, DigitBase, Allocator, E
    static const expression_template_option value = is_void<Allocator>::value ? et_off : et_on;
 };
 
+namespace detail{
+
+template<unsigned Digits, backends::digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+struct binary_splitting_integer<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+{
+   typedef backends::cpp_int_backend<> type;
+};
+
+}
+
 typedef number<backends::cpp_bin_float<50> > cpp_bin_float_50;
 typedef number<backends::cpp_bin_float<100> > cpp_bin_float_100;
 
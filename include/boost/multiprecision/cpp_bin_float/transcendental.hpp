@@ -6,65 +6,559 @@
 #ifndef BOOST_MULTIPRECISION_CPP_BIN_FLOAT_TRANSCENDENTAL_HPP
 #define BOOST_MULTIPRECISION_CPP_BIN_FLOAT_TRANSCENDENTAL_HPP
 
+#include <vector>
+
 namespace boost{ namespace multiprecision{ namespace backends{
 
+namespace detail{
+
+//
+// exp, log, pow, sin, cos and atan work on the mantissas directly, in fixed point integer
+// arithmetic carried transcendental_guard_bits beyond the precision of the result, and round
+// once at the end.  After the argument is reduced, the series is summed by rectangular splitting
+// (see eval_rectangular_series) so that most of the work is multiplication and division by small
+// integers.  The integer type has room for the product of two values carried to twice the
+// working precision, which is the precision of the cached constants, and of the argument
+// reduction for sin and cos:
+//
+static const unsigned transcendental_guard_bits = 64;
+
+template <class Float>
+struct transcendental_rep_type;
+
 template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
-void eval_exp_taylor(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+struct transcendental_rep_type<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >
+{
+   static const unsigned working_bits = cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count + transcendental_guard_bits;
+   static const unsigned bits = 4 * working_bits + 2 * bits_per_limb;
+   typedef cpp_int_backend<is_void<Allocator>::value ? bits : 0, bits, signed_magnitude, unchecked, Allocator> type;
+};
+
+//
+// The series summed by eval_rectangular_series, each with t_0 = 1 and t_(k+1) = t_k * x * num(k) / den(k),
+// negated when the series alternates.  For sin and cos x is the square of the argument, and for
+// atan and atanh the sum is multiplied by the argument afterwards, as it is for exp(x) - 1:
+//
+struct expm1_series
+{
+   static const bool alternating = false;
+   static limb_type num(unsigned) { return 1; }
+   static limb_type den(unsigned k) { return k + 2; }
+};
+
+struct sin_series
+{
+   static const bool alternating = true;
+   static limb_type num(unsigned) { return 1; }
+   static limb_type den(unsigned k) { return static_cast<limb_type>(2 * k + 2) * (2 * k + 3); }
+};
+
+struct cos_series
+{
+   static const bool alternating = true;
+   static limb_type num(unsigned) { return 1; }
+   static limb_type den(unsigned k) { return static_cast<limb_type>(2 * k + 1) * (2 * k + 2); }
+};
+
+struct atan_series
+{
+   static const bool alternating = true;
+   static limb_type num(unsigned k) { return 2 * k + 1; }
+   static limb_type den(unsigned k) { return 2 * k + 3; }
+};
+
+struct atanh_series
 {
-   static const int bits = cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count;
+   static const bool alternating = false;
+   static limb_type num(unsigned k) { return 2 * k + 1; }
+   static limb_type den(unsigned k) { return 2 * k + 3; }
+};
+
+template <class Int>
+inline void shift_fixed(Int& x, boost::intmax_t shift)
+{
+   if(shift > 0)
+      eval_left_shift(x, static_cast<unsigned>(shift));
+   else if(shift < 0)
+      eval_right_shift(x, static_cast<unsigned>(-shift));
+}
+
+//
+// Sets r to the sum of Series at x, with r and x in fixed point with w fractional bits, where the
+// terms fall by at least a half each time.  Rather than Horner's rule, which needs a full
+// multiplication for every term, we use Smith's rectangular splitting: with c_k = t_(k+1) / (t_k x),
+// and x^0 ... x^m precomputed (m ~ sqrt(n) for n terms), the sum S_0 is evaluated from the top
+// in blocks of m terms as
+//
+// S_k = x^0 + c_k (x^1 + c_(k+1) (x^2 + ... + c_(k+m-1) x^m S_(k+m)))
+//
+// which needs one full multiplication (by x^m) per block, and otherwise only multiplications
+// and divisions by the small integers in c_k.  Each step truncates, so the result is within a
+// small multiple of n of the true sum:
+//
+template <class Series, class Int>
+void eval_rectangular_series(Int& r, const Int& x, unsigned w)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_add;
+   using default_ops::eval_divide;
+   using default_ops::eval_msb;
+   using default_ops::eval_get_sign;
+
+   r = static_cast<limb_type>(1u);
+   eval_left_shift(r, w);
+   if(eval_get_sign(x) == 0)
+      return;
    //
-   // Taylor series for small argument, note returns exp(x) - 1:
+   // Find the number of terms, from |x| < 2^l:
    //
-   res = limb_type(0);
-   cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> num(arg), denom, t;
-   denom = limb_type(1);
-   eval_add(res, num);
-
-   for(unsigned k = 2; ; ++k)
-   {
-      eval_multiply(denom, k);
-      eval_multiply(num, arg);
-      eval_divide(t, num, denom);
-      eval_add(res, t);
-      if(eval_is_zero(t) || (res.exponent() - bits > t.exponent()))
-         break;
+   double l;
+   if(eval_get_sign(x) < 0)
+   {
+      Int ax(x);
+      ax.negate();
+      l = static_cast<double>(eval_msb(ax)) + 1 - static_cast<double>(w);
+   }
+   else
+      l = static_cast<double>(eval_msb(x)) + 1 - static_cast<double>(w);
+   double log2_t = 0;
+   unsigned n = 0;
+   while(log2_t > -static_cast<double>(w) - 2)
+   {
+      log2_t += l + std::log(static_cast<double>(Series::num(n)) / static_cast<double>(Series::den(n))) / 0.6931471805599453;
+      ++n;
+   }
+   unsigned m = default_ops::detail::rectangular_block_size(n);
+   unsigned blocks = (n + m - 1) / m;
+
+   std::vector<Int> powers(m + 1);
+   powers[0] = r;
+   powers[1] = x;
+   for(unsigned j = 2; j <= m; ++j)
+   {
+      eval_multiply(powers[j], powers[j - 1], x);
+      eval_right_shift(powers[j], w);
+   }
+   Int t;
+   bool first = true;
+   for(unsigned b = blocks; b-- > 0;)
+   {
+      if(!first)
+      {
+         eval_multiply(t, r, powers[m]);
+         eval_right_shift(t, w);
+         r.swap(t);
+      }
+      for(unsigned j = m; j-- > 0;)
+      {
+         if(first)
+         {
+            r = powers[j];
+            first = false;
+            continue;
+         }
+         unsigned k = b * m + j;
+         limb_type nk = Series::num(k);
+         if(nk != 1)
+            eval_multiply(r, nk);
+         eval_divide(r, Series::den(k));
+         if(Series::alternating)
+            r.negate();
+         eval_add(r, powers[j]);
+      }
    }
 }
 
-template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
-void eval_exp(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+//
+// Pi and log(2) to twice the working precision, in fixed point, from Machin's formula
+//
+// pi = 16 atan(1/5) - 4 atan(1/239)
+//
+// and log(2) = 2 atanh(1/3):
+//
+template <class Float>
+const typename transcendental_rep_type<Float>::type& fixed_constant_pi()
+{
+   typedef typename transcendental_rep_type<Float>::type int_type;
+   static BOOST_MP_THREAD_LOCAL int_type result;
+   static BOOST_MP_THREAD_LOCAL bool b = false;
+   if(!b)
+   {
+      using default_ops::eval_multiply;
+      using default_ops::eval_divide;
+      using default_ops::eval_subtract;
+      static const unsigned w = 2 * transcendental_rep_type<Float>::working_bits + 8;
+      int_type x, s, t;
+      x = static_cast<limb_type>(1u);
+      eval_left_shift(x, w);
+      eval_divide(x, static_cast<limb_type>(25u));
+      eval_rectangular_series<atan_series>(s, x, w);
+      eval_multiply(s, static_cast<limb_type>(16u));
+      eval_divide(s, static_cast<limb_type>(5u));
+      x = static_cast<limb_type>(1u);
+      eval_left_shift(x, w);
+      eval_divide(x, static_cast<limb_type>(239u * 239u));
+      eval_rectangular_series<atan_series>(t, x, w);
+      eval_multiply(t, static_cast<limb_type>(4u));
+      eval_divide(t, static_cast<limb_type>(239u));
+      eval_subtract(result, s, t);
+      eval_right_shift(result, 8);
+      b = true;
+   }
+   default_ops::constant_initializer<int_type, &fixed_constant_pi<Float> >::do_nothing();
+   return result;
+}
+
+template <class Float>
+const typename transcendental_rep_type<Float>::type& fixed_constant_ln2()
+{
+   typedef typename transcendental_rep_type<Float>::type int_type;
+   static BOOST_MP_THREAD_LOCAL int_type result;
+   static BOOST_MP_THREAD_LOCAL bool b = false;
+   if(!b)
+   {
+      using default_ops::eval_multiply;
+      using default_ops::eval_divide;
+      static const unsigned w = 2 * transcendental_rep_type<Float>::working_bits + 8;
+      int_type x;
+      x = static_cast<limb_type>(1u);
+      eval_left_shift(x, w);
+      eval_divide(x, static_cast<limb_type>(9u));
+      eval_rectangular_series<atanh_series>(result, x, w);
+      eval_multiply(result, static_cast<limb_type>(2u));
+      eval_divide(result, static_cast<limb_type>(3u));
+      eval_right_shift(result, 8);
+      b = true;
+   }
+   default_ops::constant_initializer<int_type, &fixed_constant_ln2<Float> >::do_nothing();
+   return result;
+}
+
+//
+// Sets res to v * 2^e, correctly rounded.  v is first cut down to two bits more than we keep, with
+// any bits shifted out folded into the last, so that copy_and_round only adjusts the exponent a little:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, class Int>
+void round_fixed(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& res, Int& v, boost::intmax_t e)
+{
+   using default_ops::eval_msb;
+   using default_ops::eval_lsb;
+   using default_ops::eval_get_sign;
+   using default_ops::eval_bitwise_or;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   static const int bit_count = float_type::bit_count;
+
+   if(eval_get_sign(v) == 0)
+   {
+      res = limb_type(0);
+      return;
+   }
+   bool s = eval_get_sign(v) < 0;
+   if(s)
+      v.negate();
+   int shift = static_cast<int>(eval_msb(v)) - bit_count - 1;
+   if(shift > 0)
+   {
+      bool sticky = static_cast<int>(eval_lsb(v)) < shift;
+      eval_right_shift(v, shift);
+      if(sticky)
+         eval_bitwise_or(v, static_cast<limb_type>(1u));
+      e += shift;
+   }
+   int msb = static_cast<int>(eval_msb(v));
+   e += msb;
+   if(e > float_type::max_exponent)
+      res = std::numeric_limits<number<float_type> >::infinity().backend();
+   else if(e < float_type::min_exponent - 1)
+      res = limb_type(0);
+   else
+   {
+      res.exponent() = static_cast<Exponent>(e - (msb - bit_count + 1));
+      copy_and_round(res, v);
+   }
+   res.sign() = s;
+}
+
+//
+// Sets y to z^2 in fixed point with w fractional bits, where z is the value Z * 2^e:
+//
+template <class Int>
+void square_fixed(Int& y, const Int& z, boost::intmax_t e, unsigned w)
 {
-   //
-   // This is based on MPFR's method, let:
-   //
-   // n = floor(x / ln(2))
-   //
-   // Then:
-   //
-   // r = x - n ln(2) : 0 <= r < ln(2)
-   //
-   // We can reduce r further by dividing by 2^k, with k ~ sqrt(n),
-   // so if:
-   //
-   // e0 = exp(r / 2^k) - 1
-   //
-   // With e0 evaluated by taylor series for small arguments, then:
-   //
-   // exp(x) = 2^n (1 + e0)^2^k
-   //
-   // Note that to preserve precision we actually square (1 + e0) k times, calculating
-   // the result less one each time, i.e.
-   //
-   // (1 + e0)^2 - 1 = e0^2 + 2e0
-   //
-   // Then add the final 1 at the end, given that e0 is small, this effectively wipes
-   // out the error in the last step.
-   //
    using default_ops::eval_multiply;
+   using default_ops::eval_msb;
+   // z < 2^top, and z^2 is lost entirely if top <= -w (tested first since 2 * e may overflow):
+   boost::intmax_t top = e + static_cast<boost::intmax_t>(eval_msb(z)) + 1;
+   if(top <= -static_cast<boost::intmax_t>(w))
+   {
+      y = static_cast<limb_type>(0u);
+      return;
+   }
+   eval_multiply(y, z, z);
+   shift_fixed(y, 2 * e + w);
+}
+
+//
+// Sets z to u * 2^e / v with w significant bits (or w + 1), and returns the exponent of the result:
+//
+template <class Int>
+boost::intmax_t divide_fixed(Int& z, const Int& u, const Int& v, boost::intmax_t e, unsigned w)
+{
+   using default_ops::eval_divide;
+   using default_ops::eval_msb;
+   int shift = static_cast<int>(w) + static_cast<int>(eval_msb(v)) - static_cast<int>(eval_msb(u));
+   Int t(u);
+   shift_fixed(t, shift);
+   eval_divide(z, t, v);
+   return e - shift;
+}
+
+//
+// Sets r to log(x) with p significant bits, for finite x > 0, and returns the exponent of r.  p may
+// be anything up to twice the working precision, less the bits in the exponent of x.  With
+// x = m * 2^n and 1/sqrt(2) <= m < sqrt(2),
+//
+// log(x) = n log(2) + 2 atanh(z), z = (m - 1) / (m + 1)
+//
+// and |z| < 0.172.  m - 1 is exact, so when n is zero the result keeps its relative precision
+// however close x is to 1, and otherwise |log(x)| > 1/3:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, class Int>
+boost::intmax_t eval_log_fixed(Int& r, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& x, unsigned p)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_add;
    using default_ops::eval_subtract;
+   using default_ops::eval_get_sign;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   static const unsigned w = transcendental_rep_type<float_type>::working_bits;
+
+   boost::intmax_t n = x.exponent();
+   // m = M / 2^scale, with M the mantissa bits, and 0xB504F333 / 2^31 just under sqrt(2):
+   Int m(x.bits()), one, y, s;
+   unsigned scale = float_type::bit_count - 1;
+   if(float_type::bit_count >= 32)
+   {
+      Int top(m);
+      eval_right_shift(top, float_type::bit_count - 32);
+      if(top.compare(static_cast<limb_type>(0xB504F333u)) > 0)
+      {
+         ++scale;
+         ++n;
+      }
+   }
+   else if(m.compare(static_cast<limb_type>(0xB504F333u >> (32 - float_type::bit_count))) > 0)
+   {
+      ++scale;
+      ++n;
+   }
+   one = static_cast<limb_type>(1u);
+   eval_left_shift(one, scale);
+   eval_subtract(r, m, one);
+   boost::intmax_t e = -static_cast<boost::intmax_t>(p);
+   if(eval_get_sign(r))
+   {
+      eval_add(m, one);
+      bool neg = eval_get_sign(r) < 0;
+      if(neg)
+         r.negate();
+      e = divide_fixed(y, r, m, 0, p);
+      square_fixed(r, y, e, p);
+      eval_rectangular_series<atanh_series>(s, r, p);
+      eval_multiply(r, y, s);
+      if(neg)
+         r.negate();
+      // r = log(m) * 2^(p - e - 1):
+      e += 1 - static_cast<boost::intmax_t>(p);
+      if(n == 0)
+         return e;
+      shift_fixed(r, e + p);
+      e = -static_cast<boost::intmax_t>(p);
+   }
+   y = static_cast<boost::long_long_type>(n);
+   eval_multiply(s, y, fixed_constant_ln2<float_type>());
+   eval_right_shift(s, 2 * w - p);
+   eval_add(r, s);
+   return e;
+}
+
+//
+// Sets res to exp(t * 2^e).  This is based on MPFR's method: with n the nearest integer to x / log(2),
+// and r = x - n log(2), |r| <= log(2) / 2, we reduce r further by dividing by 2^k, so if:
+//
+// e0 = exp(r / 2^k) - 1
+//
+// with e0 evaluated by the series for small arguments, then
+//
+// exp(x) = 2^n (1 + e0)^2^k
+//
+// To preserve precision we actually square (1 + e0) k times, calculating the result less one
+// each time, i.e. (1 + e0)^2 - 1 = e0 (e0 + 2), then add the final 1 at the end.  Each squaring
+// doubles the error in e0, which the guard bits absorb.  t * 2^e must be accurate to the working
+// precision in fixed point.  Returns false, leaving res unchanged, when |t * 2^e| >= 2^62: n would
+// not fit in an intmax_t, and only types with a very wide exponent range have a finite result there,
+// so we leave those to the generic code:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, class Int>
+bool eval_exp_fixed(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& res, Int& t, boost::intmax_t e)
+{
+   using default_ops::eval_multiply;
    using default_ops::eval_add;
+   using default_ops::eval_subtract;
+   using default_ops::eval_get_sign;
+   using default_ops::eval_msb;
+   using default_ops::eval_qr;
+   using default_ops::eval_increment;
    using default_ops::eval_convert_to;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   static const int w = transcendental_rep_type<float_type>::working_bits;
+
+   bool neg = eval_get_sign(t) < 0;
+   if(neg)
+      t.negate();
+   boost::intmax_t top = eval_get_sign(t) ? static_cast<boost::intmax_t>(eval_msb(t)) + e : -2 * w - 1;
+   if(top < -2 * w)
+   {
+      res = limb_type(1);
+      return true;
+   }
+   if(top >= 62)
+      return false;
+   // With t at 2w fractional bits, t = n log(2) + r:
+   const Int& ln2 = fixed_constant_ln2<float_type>();
+   Int n, r, s;
+   shift_fixed(t, e + 2 * w);
+   eval_qr(t, ln2, n, r);
+   s = ln2;
+   eval_right_shift(s, 1);
+   bool rneg = neg;
+   if(r.compare(s) > 0)
+   {
+      eval_subtract(r, ln2, r);
+      eval_increment(n);
+      rneg = !rneg;
+   }
+   boost::long_long_type nn;
+   eval_convert_to(&nn, n);
+   if(neg)
+      nn = -nn;
+   // About sqrt(w) / 2 squarings balances their cost against the terms they save, but each one
+   // costs a guard bit, so we stop at half of those:
+   unsigned k = (std::min)(static_cast<unsigned>(std::sqrt(static_cast<double>(w))) / 2, transcendental_guard_bits / 2);
+   eval_right_shift(r, w + k);
+   if(rneg)
+      r.negate();
+   eval_rectangular_series<expm1_series>(s, r, w);
+   eval_multiply(t, r, s);
+   eval_right_shift(t, w);
+   for(unsigned i = 0; i < k; ++i)
+   {
+      s = static_cast<limb_type>(1u);
+      eval_left_shift(s, w + 1);
+      eval_add(s, t);
+      eval_multiply(r, t, s);
+      eval_right_shift(r, w);
+      t.swap(r);
+   }
+   s = static_cast<limb_type>(1u);
+   eval_left_shift(s, w);
+   eval_add(t, s);
+   round_fixed(res, t, nn - w);
+   return true;
+}
 
+//
+// Sets res to sin(r) or cos(r), where r = R * 2^e, R has w significant bits, and |r| <= pi/4:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, class Int>
+void eval_sin_cos_reduced(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& res, const Int& r, boost::intmax_t e, bool cosine, bool negate)
+{
+   using default_ops::eval_multiply;
+   static const unsigned w = transcendental_rep_type<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >::working_bits;
+   Int y, s;
+   square_fixed(y, r, e, w);
+   if(cosine)
+   {
+      eval_rectangular_series<cos_series>(s, y, w);
+      if(negate)
+         s.negate();
+      round_fixed(res, s, -static_cast<boost::intmax_t>(w));
+   }
+   else
+   {
+      eval_rectangular_series<sin_series>(s, y, w);
+      eval_multiply(y, s, r);
+      if(negate)
+         y.negate();
+      round_fixed(res, y, e - static_cast<boost::intmax_t>(w));
+   }
+}
+
+//
+// Reduces |x| modulo pi/2 to r = R * 2^e with |r| <= pi/4, and R with w significant bits, setting q to the
+// quadrant and neg to the sign of r.  Uses pi to twice the working precision, and returns false if that
+// leaves too few good bits in r (when x is very close to a multiple of pi/2), or if |x| >= 1/epsilon, where
+// the generic code's treatment of the result as meaningless is kept:
+//
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE, class Int>
+bool reduce_pi_over_2(const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>& x, Int& r, boost::intmax_t& e, unsigned& q, bool& neg)
+{
+   using default_ops::eval_msb;
+   using default_ops::eval_get_sign;
+   using default_ops::eval_subtract;
+   using default_ops::eval_qr;
+   using default_ops::eval_increment;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   static const int w = transcendental_rep_type<float_type>::working_bits;
+   static const int l = 2 * w;
+
+   r = x.bits();
+   q = 0;
+   neg = false;
+   if(x.exponent() < -1)
+   {
+      // |x| < 1/2, nothing to do:
+      eval_left_shift(r, w - float_type::bit_count);
+      e = static_cast<boost::intmax_t>(x.exponent()) + 1 - w;
+      return true;
+   }
+   if(x.exponent() >= static_cast<Exponent>(float_type::bit_count - 1))
+      return false;
+   //
+   // With X = |x| * 2^l and P = pi/2 * 2^l, r * 2^l = X - n * P with n the nearest integer to X / P:
+   //
+   Int p(fixed_constant_pi<float_type>()), n, t;
+   eval_right_shift(p, 1);
+   eval_left_shift(r, static_cast<unsigned>(x.exponent() + 1 - float_type::bit_count + l));
+   eval_qr(r, p, n, t);
+   eval_right_shift(p, 1);
+   if(t.compare(p) > 0)
+   {
+      eval_left_shift(p, 1);
+      eval_subtract(r, p, t);
+      eval_increment(n);
+      neg = true;
+   }
+   else
+      r.swap(t);
+   q = static_cast<unsigned>(*n.limbs() & 3u);
+   // The error in r is at most n + 1 in units of 2^-l, the last place of P, which carries twice the
+   // working precision w (guard bits included).  We need w good bits:
+   int nbits = eval_get_sign(n) ? static_cast<int>(eval_msb(n)) + 1 : 0;
+   if((eval_get_sign(r) == 0) || (static_cast<int>(eval_msb(r)) < w + nbits + 3))
+      return false;
+   int shift = static_cast<int>(eval_msb(r)) + 1 - w;
+   eval_right_shift(r, shift);
+   e = shift - l;
+   return true;
+}
+
+}
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_exp(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
    int type = eval_fpclassify(arg);
    bool isneg = eval_get_sign(arg) < 0;
    if(type == (int)FP_NAN)
@@ -75,10 +569,9 @@ void eval_exp(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>
    }
    else if(type == (int)FP_INFINITE)
    {
-      res = arg;
       if(isneg)
          res = limb_type(0u);
-      else 
+      else
          res = arg;
       return;
    }
@@ -87,62 +580,258 @@ void eval_exp(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>
       res = limb_type(1);
       return;
    }
-   cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> t, n;
+   typename detail::transcendental_rep_type<float_type>::type t(arg.bits());
    if(isneg)
-   {
-      t = arg;
       t.negate();
-      eval_exp(res, t);
-      t.swap(res);
-      res = limb_type(1);
-      eval_divide(res, t);
+   if(!detail::eval_exp_fixed(res, t, static_cast<boost::intmax_t>(arg.exponent()) + 1 - float_type::bit_count))
+      default_ops::eval_exp(res, arg);
+}
+
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_log(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   switch(eval_fpclassify(arg))
+   {
+   case FP_NAN:
+      res = arg;
+      errno = EDOM;
+      return;
+   case FP_INFINITE:
+      if(arg.sign())
+         break;
+      res = arg;
+      return;
+   case FP_ZERO:
+      res = std::numeric_limits<number<float_type> >::infinity().backend();
+      res.negate();
+      errno = ERANGE;
       return;
    }
-
-   eval_divide(n, arg, default_ops::get_constant_ln2<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >());
-   eval_floor(n, n);
-   eval_multiply(t, n, default_ops::get_constant_ln2<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >());
-   eval_subtract(t, arg);
-   t.negate();
-   if(eval_get_sign(t) < 0)
+   if(arg.sign())
    {
-      // There are some very rare cases where arg/ln2 is an integer, and the subsequent multiply
-      // rounds up, in that situation t ends up negative at this point which breaks our invariants below:
-      t = limb_type(0);
+      res = std::numeric_limits<number<float_type> >::quiet_NaN().backend();
+      errno = EDOM;
+      return;
    }
+   typename detail::transcendental_rep_type<float_type>::type r;
+   boost::intmax_t e = detail::eval_log_fixed(r, arg, detail::transcendental_rep_type<float_type>::working_bits);
+   detail::round_fixed(res, r, e);
+}
 
-   Exponent k, nn;
-   eval_convert_to(&nn, n);
-
-   if (nn == (std::numeric_limits<Exponent>::max)())
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_pow(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &x, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &a)
+{
+   //
+   // For x > 0 and finite a we use exp(a log(x)), with log(x) carried to enough extra bits that
+   // a log(x) is accurate in fixed point for any a that does not overflow the result.  Everything
+   // else is a special case, as is an a so small that the exponent arithmetic could overflow, and
+   // the generic version deals with those:
+   //
+   using default_ops::eval_multiply;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   typedef typename detail::transcendental_rep_type<float_type>::type int_type;
+   if((eval_fpclassify(x) != (int)FP_NORMAL) || (eval_fpclassify(a) != (int)FP_NORMAL) || x.sign()
+      || (a.exponent() < -2 * static_cast<Exponent>(detail::transcendental_rep_type<float_type>::working_bits)))
    {
-      // The result will necessarily oveflow:
-      res = std::numeric_limits<number<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> > >::infinity().backend();
+      default_ops::eval_pow(res, x, a);
       return;
    }
+   int_type l, t;
+   boost::intmax_t e = detail::eval_log_fixed(l, x, detail::transcendental_rep_type<float_type>::working_bits + 64);
+   int_type ma(a.bits());
+   eval_multiply(t, l, ma);
+   if(a.sign())
+      t.negate();
+   if(!detail::eval_exp_fixed(res, t, e + a.exponent() + 1 - float_type::bit_count))
+      default_ops::eval_pow(res, x, a);
+}
 
-   BOOST_ASSERT(t.compare(default_ops::get_constant_ln2<cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> >()) < 0);
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_sin(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   switch(eval_fpclassify(arg))
+   {
+   case FP_INFINITE:
+   case FP_NAN:
+      res = std::numeric_limits<number<float_type> >::quiet_NaN().backend();
+      errno = EDOM;
+      return;
+   case FP_ZERO:
+      res = arg;
+      return;
+   default: ;
+   }
+   if(arg.exponent() < -static_cast<Exponent>(detail::transcendental_rep_type<float_type>::working_bits))
+   {
+      // sin(x) = x (1 - x^2 / 6 + ...) rounds to x:
+      res = arg;
+      return;
+   }
+   typename detail::transcendental_rep_type<float_type>::type r;
+   boost::intmax_t e;
+   unsigned q;
+   bool neg;
+   if(!detail::reduce_pi_over_2(arg, r, e, q, neg))
+   {
+      default_ops::eval_sin(res, arg);
+      return;
+   }
+   // sin(x) is sin(r), cos(r), -sin(r) or -cos(r) according to the quadrant:
+   detail::eval_sin_cos_reduced(res, r, e, (q & 1) != 0, (arg.sign() != ((q & 2) != 0)) != (neg && !(q & 1)));
+}
 
-   k = nn ? Exponent(1) << (msb(nn) / 2) : 0;
-   k = (std::min)(k, (Exponent)(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE>::bit_count / 4));
-   eval_ldexp(t, t, -k);
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_cos(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   switch(eval_fpclassify(arg))
+   {
+   case FP_INFINITE:
+   case FP_NAN:
+      res = std::numeric_limits<number<float_type> >::quiet_NaN().backend();
+      errno = EDOM;
+      return;
+   case FP_ZERO:
+      res = limb_type(1);
+      return;
+   default: ;
+   }
+   if(arg.exponent() < -static_cast<Exponent>(detail::transcendental_rep_type<float_type>::working_bits))
+   {
+      // cos(x) = 1 - x^2 / 2 + ... rounds to 1:
+      res = limb_type(1);
+      return;
+   }
+   typename detail::transcendental_rep_type<float_type>::type r;
+   boost::intmax_t e;
+   unsigned q;
+   bool neg;
+   if(!detail::reduce_pi_over_2(arg, r, e, q, neg))
+   {
+      default_ops::eval_cos(res, arg);
+      return;
+   }
+   // cos(x) is cos(r), -sin(r), -cos(r) or sin(r) according to the quadrant:
+   detail::eval_sin_cos_reduced(res, r, e, (q & 1) == 0, (((q + 1) & 2) != 0) != (neg && (q & 1)));
+}
 
-   eval_exp_taylor(res, t);
+template <unsigned Digits, digit_base_type DigitBase, class Allocator, class Exponent, Exponent MinE, Exponent MaxE>
+void eval_atan(cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &res, const cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> &arg)
+{
+   //
+   // For |x| < 1/2 we sum the series directly, otherwise use
    //
-   // Square 1 + res k times:
+   // atan(x) = pi/4 + atan((x - 1) / (x + 1))   for 1/2 <= x < 2
+   // atan(x) = pi/2 - atan(1 / x)               for x >= 2
    //
-   for(Exponent s = 0; s < k; ++s)
+   // which leaves an argument no larger than 1/2 in all cases:
+   //
+   using default_ops::eval_multiply;
+   using default_ops::eval_add;
+   using default_ops::eval_subtract;
+   using default_ops::eval_get_sign;
+   typedef cpp_bin_float<Digits, DigitBase, Allocator, Exponent, MinE, MaxE> float_type;
+   typedef typename detail::transcendental_rep_type<float_type>::type int_type;
+   static const int w = detail::transcendental_rep_type<float_type>::working_bits;
+
+   switch(eval_fpclassify(arg))
+   {
+   case FP_NAN:
+      res = arg;
+      errno = EDOM;
+      return;
+   case FP_ZERO:
+      res = arg;
+      return;
+   case FP_INFINITE:
+      {
+         int_type p(detail::fixed_constant_pi<float_type>());
+         if(arg.sign())
+            p.negate();
+         detail::round_fixed(res, p, -2 * w - 1);
+         return;
+      }
+   default: ;
+   }
+   if(arg.exponent() < -static_cast<Exponent>(w))
+   {
+      // atan(x) = x (1 - x^2 / 3 + ...) rounds to x:
+      res = arg;
+      return;
+   }
+   bool neg_result = arg.sign();
+   int_type z, y, s;
+   boost::intmax_t e = static_cast<boost::intmax_t>(arg.exponent()) + 1 - float_type::bit_count;
+   // The multiple of pi/4 to add, and the sign of atan(z):
+   unsigned quarters = 0;
+   bool neg = false;
+   z = arg.bits();
+   if(arg.exponent() < -1)
+   {
+      eval_left_shift(z, w - float_type::bit_count);
+      e -= w - float_type::bit_count;
+   }
+   else if(arg.exponent() < 1)
+   {
+      // x = M * 2^e, so (x - 1) / (x + 1) = (M - 2^-e) / (M + 2^-e):
+      s = static_cast<limb_type>(1u);
+      eval_left_shift(s, static_cast<unsigned>(-e));
+      eval_subtract(y, z, s);
+      eval_add(s, z);
+      quarters = 1;
+      neg = eval_get_sign(y) < 0;
+      if(neg)
+         y.negate();
+      if(eval_get_sign(y) == 0)
+         z = static_cast<limb_type>(0u);
+      else
+         e = detail::divide_fixed(z, y, s, 0, w);
+   }
+   else
    {
-      t.swap(res);
-      eval_multiply(res, t, t);
-      eval_ldexp(t, t, 1);
-      eval_add(res, t);
+      // atan(1/x) is lost against pi/2 once x > 2^w:
+      if(arg.exponent() > static_cast<Exponent>(w))
+      {
+         z = static_cast<limb_type>(0u);
+         e = 0;
+      }
+      else
+      {
+         s = static_cast<limb_type>(1u);
+         e = detail::divide_fixed(z, s, int_type(z), -e, w);
+      }
+      quarters = 2;
+      neg = true;
    }
-   eval_add(res, limb_type(1));
-   eval_ldexp(res, res, nn);
+   if(eval_get_sign(z))
+   {
+      detail::square_fixed(y, z, e, w);
+      detail::eval_rectangular_series<detail::atan_series>(s, y, w);
+      eval_multiply(y, z, s);
+      if(neg)
+         y.negate();
+   }
+   else
+      y = static_cast<limb_type>(0u);
+   if(!quarters)
+   {
+      if(neg_result)
+         y.negate();
+      detail::round_fixed(res, y, e - w);
+      return;
+   }
+   // atan(z) = y * 2^(e - w), we need it to w fractional bits:
+   detail::shift_fixed(y, e);
+   s = detail::fixed_constant_pi<float_type>();
+   eval_right_shift(s, w + 3 - quarters);
+   eval_add(s, y);
+   if(neg_result)
+      s.negate();
+   detail::round_fixed(res, s, -w);
 }
 
 }}} // namespaces
 
 #endif
-
@@ -27,8 +27,11 @@
 #include <boost/cstdint.hpp>
 #include <boost/functional/hash_fwd.hpp>
 #include <boost/multiprecision/number.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
 #include <boost/multiprecision/detail/big_lanczos.hpp>
 #include <boost/multiprecision/detail/dynamic_array.hpp>
+#include <boost/multiprecision/pool_allocator.hpp>
+#include <boost/multiprecision/detail/ntt.hpp>
 
 //
 // Headers required for Boost.Math integration:
@@ -44,6 +47,16 @@
 #include <boost/math/special_functions/expm1.hpp>
 #include <boost/math/special_functions/gamma.hpp>
 
+//
+// Precision (in 10^8 elements) at which multiplication switches from the schoolbook
+// method to the number theoretic transform in detail/ntt.hpp.  This must be less
+// than 1800, which is the largest precision the schoolbook method can handle, and
+// in practice the schoolbook method is competitive right up to that limit:
+//
+#ifndef BOOST_MP_CPP_DEC_FLOAT_NTT_CUTOFF
+#  define BOOST_MP_CPP_DEC_FLOAT_NTT_CUTOFF 1700
+#endif
+
 #ifdef BOOST_MSVC
 #pragma warning(push)
 #pragma warning(disable:6326)  // comparison of two constants
@@ -120,17 +133,10 @@ private:
    }
    fpclass_type;
 
-#ifndef BOOST_NO_CXX11_HDR_ARRAY
-   typedef typename mpl::if_<is_void<Allocator>,
-      std::array<boost::uint32_t, cpp_dec_float_elem_number>,
-      detail::dynamic_array<boost::uint32_t, cpp_dec_float_elem_number, Allocator>
-      >::type array_type;
-#else
    typedef typename mpl::if_<is_void<Allocator>,
-      boost::array<boost::uint32_t, cpp_dec_float_elem_number>,
+      detail::static_array<boost::uint32_t, cpp_dec_float_elem_number>,
       detail::dynamic_array<boost::uint32_t, cpp_dec_float_elem_number, Allocator>
       >::type array_type;
-#endif
 
    array_type data;
    ExponentType exp;
@@ -199,7 +205,7 @@ public:
 
    template<class I>
    cpp_dec_float(I i, typename enable_if<is_unsigned<I> >::type* = 0) :
-      data(),
+      data(detail::array_no_fill()),
       exp (static_cast<ExponentType>(0)),
       neg (false),
       fpclass (cpp_dec_float_finite),
@@ -210,7 +216,7 @@ public:
 
    template <class I>
    cpp_dec_float(I i, typename enable_if<is_signed<I> >::type* = 0) :
-      data(),
+      data(detail::array_no_fill()),
       exp (static_cast<ExponentType>(0)),
       neg (false),
       fpclass (cpp_dec_float_finite),
@@ -260,7 +266,7 @@ public:
       && !boost::is_same<F, __float128>::value
 #endif
    >::type* = 0) :
-      data(),
+      data(detail::array_no_fill()),
       exp (static_cast<ExponentType>(0)),
       neg (false),
       fpclass (cpp_dec_float_finite),
@@ -414,6 +420,18 @@ public:
       return *this;
    }
 
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+   cpp_dec_float& operator=(cpp_dec_float&& v) BOOST_MP_NOEXCEPT_IF(noexcept(std::declval<array_type&>() = std::declval<array_type&&>()))
+   {
+      data = static_cast<array_type&&>(v.data);
+      exp = v.exp;
+      neg = v.neg;
+      fpclass = v.fpclass;
+      prec_elem = v.prec_elem;
+      return *this;
+   }
+#endif
+
    template <unsigned D>
    cpp_dec_float& operator=(const cpp_dec_float<D>& f)
    {
@@ -458,6 +476,10 @@ public:
    cpp_dec_float& operator*=(const cpp_dec_float& v);
    cpp_dec_float& operator/=(const cpp_dec_float& v);
 
+   // Fused *this += u * v and *this -= u * v.
+   cpp_dec_float& multiply_add(const cpp_dec_float& u, const cpp_dec_float& v)      { return multiply_accumulate(u, v, false); }
+   cpp_dec_float& multiply_subtract(const cpp_dec_float& u, const cpp_dec_float& v) { return multiply_accumulate(u, v, true); }
+
    cpp_dec_float& add_unsigned_long_long(const boost::ulong_long_type n)
    {
       cpp_dec_float t;
@@ -625,7 +647,10 @@ private:
    int cmp_data(const array_type& vd) const;
 
 
+   cpp_dec_float& multiply_accumulate(const cpp_dec_float& u, const cpp_dec_float& v, const bool b_subtract);
+
    static boost::uint32_t mul_loop_uv(boost::uint32_t* const u, const boost::uint32_t* const v, const boost::int32_t p);
+   static boost::uint32_t mul_loop_ntt(boost::uint32_t* const u, const boost::uint32_t* const v, const boost::int32_t p);
    static boost::uint32_t mul_loop_n (boost::uint32_t* const u, boost::uint32_t n, const boost::int32_t p);
    static boost::uint32_t div_loop_n (boost::uint32_t* const u, boost::uint32_t n, const boost::int32_t p);
 
@@ -716,7 +741,7 @@ cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, Expone
    typename array_type::const_iterator p_v = v.data.begin();
    bool b_copy = false;
    const boost::int32_t ofs = static_cast<boost::int32_t>(static_cast<boost::int32_t>(ofs_exp) / cpp_dec_float_elem_digits10);
-   array_type n_data;
+   array_type n_data((detail::array_no_fill()));
 
    if(neg == v.neg)
    {
@@ -750,7 +775,7 @@ cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, Expone
 
       if(b_copy)
       {
-         data = n_data;
+         data = BOOST_MP_MOVE(n_data);
          exp = v.exp;
       }
 
@@ -826,7 +851,7 @@ cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, Expone
 
       if(b_copy)
       {
-         data = n_data;
+         data = BOOST_MP_MOVE(n_data);
          exp = v.exp;
          neg = v.neg;
       }
@@ -934,7 +959,9 @@ cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, Expone
 
    const boost::int32_t prec_mul = (std::min)(prec_elem, v.prec_elem);
 
-   const boost::uint32_t carry = mul_loop_uv(data.data(), v.data.data(), prec_mul);
+   const boost::uint32_t carry = (prec_mul >= static_cast<boost::int32_t>(BOOST_MP_CPP_DEC_FLOAT_NTT_CUTOFF))
+                                    ? mul_loop_ntt(data.data(), v.data.data(), prec_mul)
+                                    : mul_loop_uv (data.data(), v.data.data(), prec_mul);
 
    // Handle a potential carry.
    if(carry != static_cast<boost::uint32_t>(0u))
@@ -970,6 +997,193 @@ cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, Expone
    return *this;
 }
 
+template <unsigned Digits10, class ExponentType, class Allocator>
+cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, ExponentType, Allocator>::multiply_accumulate(const cpp_dec_float<Digits10, ExponentType, Allocator>& u, const cpp_dec_float<Digits10, ExponentType, Allocator>& v, const bool b_subtract)
+{
+   // Exponent of the product, before any carry out of its leading element.
+   const ExponentType prod_exp = static_cast<ExponentType>(u.exp + v.exp);
+
+   const boost::int32_t prec_mul = (std::min)(u.prec_elem, v.prec_elem);
+
+   // The product is accumulated straight into the elements of *this, which is possible when
+   // the leading element of the product (not counting its carry) lines up with, or lies below,
+   // the leading element of *this.  Everything else, special values, zeros, products which might
+   // underflow, large precisions and arguments which alias *this, goes via a temporary.
+   if(   (this == &u) || (this == &v)
+      || !(isfinite)() || !(u.isfinite)() || !(v.isfinite)()
+      || iszero() || u.iszero() || v.iszero()
+      || (prod_exp > exp)
+      || (prod_exp <= static_cast<ExponentType>(cpp_dec_float_min_exp10))
+      || (prec_mul >= static_cast<boost::int32_t>(BOOST_MP_CPP_DEC_FLOAT_NTT_CUTOFF)))
+   {
+      cpp_dec_float t(u);
+      t *= v;
+      return b_subtract ? (*this -= t) : (*this += t);
+   }
+
+   // Check if the product is negligible compared to *this, to the precision of *this.
+   if((exp - prod_exp) > static_cast<ExponentType>(prec_elem * cpp_dec_float_elem_digits10))
+   {
+      return *this;
+   }
+
+   const boost::int32_t ofs = static_cast<boost::int32_t>(static_cast<boost::int32_t>(exp - prod_exp) / cpp_dec_float_elem_digits10);
+
+   // Elements beyond the precision of *this take no part: clear them, and form only the columns
+   // of the product which land within that precision, plus one more for its carry.
+   std::fill(data.begin() + static_cast<std::size_t>(prec_elem), data.end(), static_cast<boost::uint32_t>(0u));
+
+   const boost::int32_t prec_prod = (std::min)(prec_mul, static_cast<boost::int32_t>(prec_elem + 1 - ofs));
+
+   // Add or subtract the magnitude of the product?
+   const bool b_add = (neg == ((u.neg != v.neg) != b_subtract));
+
+   const boost::uint32_t* const pu = u.data.data();
+   const boost::uint32_t* const pv = v.data.data();
+   boost::uint32_t* const       pd = data.data();
+
+   // The multiplication loop of mul_loop_uv, with element j of the product going
+   // to element j + ofs of *this, least significant first.
+   boost::uint64_t carry  = static_cast<boost::uint64_t>(0u);
+   boost::int32_t  borrow = static_cast<boost::int32_t>(0);
+
+   for(boost::int32_t j = static_cast<boost::int32_t>(prec_prod - 1); j >= static_cast<boost::int32_t>(0); j--)
+   {
+      boost::uint64_t sum = carry;
+
+      for(boost::int32_t i = j; i >= static_cast<boost::int32_t>(0); i--)
+      {
+         sum += static_cast<boost::uint64_t>(pu[j - i] * static_cast<boost::uint64_t>(pv[i]));
+      }
+
+      const boost::int32_t k = static_cast<boost::int32_t>(j + ofs);
+
+      if(k >= prec_elem)
+      {
+         // Below the precision of *this, only the carry is needed.
+         carry = static_cast<boost::uint64_t>(sum / static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+      }
+      else if(b_add)
+      {
+         sum += pd[k];
+         pd[k] = static_cast<boost::uint32_t>(sum % static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+         carry = static_cast<boost::uint64_t>(sum / static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+      }
+      else
+      {
+         const boost::int32_t t = static_cast<boost::int32_t>(static_cast<boost::int32_t>(pd[k])
+            - static_cast<boost::int32_t>(sum % static_cast<boost::uint32_t>(cpp_dec_float_elem_mask)) - borrow);
+         borrow = (t < static_cast<boost::int32_t>(0)) ? static_cast<boost::int32_t>(1) : static_cast<boost::int32_t>(0);
+         pd[k] = static_cast<boost::uint32_t>(t + borrow * static_cast<boost::int32_t>(cpp_dec_float_elem_mask));
+         carry = static_cast<boost::uint64_t>(sum / static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+      }
+   }
+
+   // The remaining carry is the leading element of the product (plus any carry of the addition),
+   // which goes in element ofs - 1, then propagate upwards.
+   for(boost::int32_t k = static_cast<boost::int32_t>(ofs - 1); (k >= static_cast<boost::int32_t>(0)) && ((carry != static_cast<boost::uint64_t>(0u)) || (borrow != static_cast<boost::int32_t>(0))); k--)
+   {
+      if(b_add)
+      {
+         const boost::uint64_t sum = static_cast<boost::uint64_t>(pd[k] + carry);
+         pd[k] = static_cast<boost::uint32_t>(sum % static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+         carry = static_cast<boost::uint64_t>(sum / static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+      }
+      else
+      {
+         const boost::int32_t t = static_cast<boost::int32_t>(static_cast<boost::int32_t>(pd[k]) - static_cast<boost::int32_t>(carry) - borrow);
+         borrow = (t < static_cast<boost::int32_t>(0)) ? static_cast<boost::int32_t>(1) : static_cast<boost::int32_t>(0);
+         pd[k] = static_cast<boost::uint32_t>(t + borrow * static_cast<boost::int32_t>(cpp_dec_float_elem_mask));
+         carry = static_cast<boost::uint64_t>(0u);
+      }
+   }
+
+   // Whatever is left over belongs in element -1.
+   boost::uint32_t top = static_cast<boost::uint32_t>(carry + static_cast<boost::uint64_t>(borrow));
+
+   if((!b_add) && (top != static_cast<boost::uint32_t>(0u)))
+   {
+      // The product was the larger: the elements hold 10^(8 * elem_number) * top - |result|,
+      // so take the ten's complement and flip the sign.
+      borrow = static_cast<boost::int32_t>(0);
+
+      for(boost::int32_t k = static_cast<boost::int32_t>(cpp_dec_float_elem_number - 1); k >= static_cast<boost::int32_t>(0); k--)
+      {
+         const boost::int32_t t = static_cast<boost::int32_t>(-static_cast<boost::int32_t>(pd[k]) - borrow);
+         borrow = (t < static_cast<boost::int32_t>(0)) ? static_cast<boost::int32_t>(1) : static_cast<boost::int32_t>(0);
+         pd[k] = static_cast<boost::uint32_t>(t + borrow * static_cast<boost::int32_t>(cpp_dec_float_elem_mask));
+      }
+
+      top = static_cast<boost::uint32_t>(top - static_cast<boost::uint32_t>(borrow));
+      neg = !neg;
+   }
+
+   if(top >= static_cast<boost::uint32_t>(cpp_dec_float_elem_mask))
+   {
+      // When the product lines up with *this, the carry and borrow together can reach 10^8,
+      // which takes two leading elements: shift the data two elements to the right.
+      std::copy_backward(data.begin(), data.end() - static_cast<std::size_t>(2u), data.end());
+      data[0] = static_cast<boost::uint32_t>(top / static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+      data[1] = static_cast<boost::uint32_t>(top % static_cast<boost::uint32_t>(cpp_dec_float_elem_mask));
+      exp += static_cast<ExponentType>(2 * cpp_dec_float_elem_digits10);
+   }
+   else if(top != static_cast<boost::uint32_t>(0u))
+   {
+      // Shift the data one element to the right, and insert the leading element.
+      std::copy_backward(data.begin(), data.end() - static_cast<std::size_t>(1u), data.end());
+      data[0] = top;
+      exp += static_cast<ExponentType>(cpp_dec_float_elem_digits10);
+   }
+   else if(!b_add)
+   {
+      // Is it necessary to justify the data?
+      const typename array_type::const_iterator first_nonzero_elem = std::find_if(data.begin(), data.end(), data_elem_is_non_zero_predicate);
+
+      if(first_nonzero_elem == data.end())
+      {
+         // This result of the subtraction is exactly zero.
+         return (*this = zero());
+      }
+      else if(first_nonzero_elem != data.begin())
+      {
+         const std::size_t sj = static_cast<std::size_t>(std::distance<typename array_type::const_iterator>(data.begin(), first_nonzero_elem));
+
+         std::copy(data.begin() + static_cast<std::size_t>(sj), data.end(), data.begin());
+         std::fill(data.end() - sj, data.end(), static_cast<boost::uint32_t>(0u));
+
+         exp -= static_cast<ExponentType>(sj * static_cast<std::size_t>(cpp_dec_float_elem_digits10));
+
+         // Handle underflow, as for operator*=, when the cancellation leaves less than min().
+         if(exp <= static_cast<ExponentType>(cpp_dec_float_min_exp10))
+         {
+            const bool b_result_is_neg = neg;
+            neg = false;
+
+            if(compare((cpp_dec_float::min)()) < 0)
+            {
+               return (*this = zero());
+            }
+
+            neg = b_result_is_neg;
+         }
+      }
+   }
+
+   // Handle overflow.
+   if(exp >= static_cast<ExponentType>(cpp_dec_float_max_exp10))
+   {
+      const bool b_result_is_neg = neg;
+      neg = false;
+
+      if(compare((cpp_dec_float::max)()) > 0)
+        *this = inf();
+
+      neg = b_result_is_neg;
+   }
+
+   return *this;
+}
+
 template <unsigned Digits10, class ExponentType, class Allocator>
 cpp_dec_float<Digits10, ExponentType, Allocator>& cpp_dec_float<Digits10, ExponentType, Allocator>::operator/=(const cpp_dec_float<Digits10, ExponentType, Allocator>& v)
 {
@@ -2205,7 +2419,7 @@ bool cpp_dec_float<Digits10, ExponentType, Allocator>::rd_string(const char* con
 
 template <unsigned Digits10, class ExponentType, class Allocator>
 cpp_dec_float<Digits10, ExponentType, Allocator>::cpp_dec_float(const double mantissa, const ExponentType exponent)
- : data (),
+ : data (detail::array_no_fill()),
    exp  (static_cast<ExponentType>(0)),
    neg  (false),
    fpclass (cpp_dec_float_finite),
@@ -2358,7 +2572,10 @@ boost::uint32_t cpp_dec_float<Digits10, ExponentType, Allocator>::mul_loop_uv(bo
    //
    // FLOOR( (2^64 - 1) / (10^8 * 10^8) ) == 1844
    //
-   BOOST_STATIC_ASSERT_MSG(cpp_dec_float_elem_number < 1800, "Too many limbs in the data type for the multiplication algorithm - unsupported precision in cpp_dec_float.");
+   // Larger precisions are handled by mul_loop_ntt.
+   //
+   BOOST_STATIC_ASSERT_MSG(BOOST_MP_CPP_DEC_FLOAT_NTT_CUTOFF < 1800, "BOOST_MP_CPP_DEC_FLOAT_NTT_CUTOFF is too large for the schoolbook multiplication algorithm.");
+   BOOST_ASSERT(p < 1800);
 
    boost::uint64_t carry = static_cast<boost::uint64_t>(0u);
 
@@ -2378,6 +2595,32 @@ boost::uint32_t cpp_dec_float<Digits10, ExponentType, Allocator>::mul_loop_uv(bo
    return static_cast<boost::uint32_t>(carry);
 }
 
+template <unsigned Digits10, class ExponentType, class Allocator>
+boost::uint32_t cpp_dec_float<Digits10, ExponentType, Allocator>::mul_loop_ntt(boost::uint32_t* const u, const boost::uint32_t* const v, const boost::int32_t p)
+{
+   //
+   // Same as mul_loop_uv, but using a number theoretic transform to compute the
+   // full 2p element product, the low p elements of which are then discarded.
+   // The transform works with the least significant element first, so we have
+   // to reverse the element order on the way in and out:
+   //
+   const std::size_t n = static_cast<std::size_t>(p);
+   std::vector<boost::uint32_t> a(u, u + n), b, r(2 * n);
+   std::reverse(a.begin(), a.end());
+   if(u == v)
+      boost::multiprecision::detail::ntt_multiply<cpp_dec_float_elem_mask>(&r[0], &a[0], n, &a[0], n);
+   else
+   {
+      b.assign(v, v + n);
+      std::reverse(b.begin(), b.end());
+      boost::multiprecision::detail::ntt_multiply<cpp_dec_float_elem_mask>(&r[0], &a[0], n, &b[0], n);
+   }
+   for(std::size_t j = 0; j < n; ++j)
+      u[j] = r[2 * n - 2 - j];
+
+   return r[2 * n - 1];
+}
+
 template <unsigned Digits10, class ExponentType, class Allocator>
 boost::uint32_t cpp_dec_float<Digits10, ExponentType, Allocator>::mul_loop_n(boost::uint32_t* const u, boost::uint32_t n, const boost::int32_t p)
 {
@@ -2712,6 +2955,16 @@ inline void eval_multiply(cpp_dec_float<Digits10, ExponentType, Allocator>& resu
    result *= o;
 }
 template <unsigned Digits10, class ExponentType, class Allocator>
+inline void eval_multiply_add(cpp_dec_float<Digits10, ExponentType, Allocator>& result, const cpp_dec_float<Digits10, ExponentType, Allocator>& a, const cpp_dec_float<Digits10, ExponentType, Allocator>& b)
+{
+   result.multiply_add(a, b);
+}
+template <unsigned Digits10, class ExponentType, class Allocator>
+inline void eval_multiply_subtract(cpp_dec_float<Digits10, ExponentType, Allocator>& result, const cpp_dec_float<Digits10, ExponentType, Allocator>& a, const cpp_dec_float<Digits10, ExponentType, Allocator>& b)
+{
+   result.multiply_subtract(a, b);
+}
+template <unsigned Digits10, class ExponentType, class Allocator>
 inline void eval_divide(cpp_dec_float<Digits10, ExponentType, Allocator>& result, const cpp_dec_float<Digits10, ExponentType, Allocator>& o)
 {
    result /= o;
@@ -3023,6 +3276,16 @@ using boost::multiprecision::backends::cpp_dec_float;
 typedef number<cpp_dec_float<50> > cpp_dec_float_50;
 typedef number<cpp_dec_float<100> > cpp_dec_float_100;
 
+namespace detail{
+
+template <unsigned Digits10, class ExponentType, class Allocator>
+struct binary_splitting_integer<cpp_dec_float<Digits10, ExponentType, Allocator> >
+{
+   typedef backends::cpp_int_backend<> type;
+};
+
+}
+
 #ifdef BOOST_NO_SFINAE_EXPR
 
 namespace detail{
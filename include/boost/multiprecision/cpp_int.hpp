@@ -22,10 +22,29 @@
 #include <boost/type_traits/common_type.hpp>
 #include <boost/type_traits/make_signed.hpp>
 #include <boost/multiprecision/cpp_int/checked.hpp>
+#include <boost/multiprecision/pool_allocator.hpp>
 #ifdef BOOST_MP_USER_DEFINED_LITERALS
 #include <boost/multiprecision/cpp_int/value_pack.hpp>
 #endif
 
+//
+// The number of bits stored within an arbitrary precision cpp_int (one with MinBits == 0) before
+// memory is allocated, zero means as many as will fit in union with the dynamic storage header,
+// which is two limbs on most platforms.
+//
+// WARNING: this changes the layout of every cpp_int_backend with MinBits == 0, including cpp_int
+// itself, without changing its name.  Translation units built with different values which share
+// such a type violate the one definition rule, and most toolsets give no diagnostic (MSVC reports
+// the mismatch at link time).  Prefer a separate type with its own inline size set via MinBits,
+// for example cpp_int_backend<512>, which still grows dynamically when MaxBits is zero:
+//
+#ifndef BOOST_MP_CPP_INT_INLINE_BITS
+#  define BOOST_MP_CPP_INT_INLINE_BITS 0
+#endif
+#if defined(_MSC_VER) && (_MSC_VER >= 1600)
+#  pragma detect_mismatch("BOOST_MP_CPP_INT_INLINE_BITS", BOOST_STRINGIZE(BOOST_MP_CPP_INT_INLINE_BITS))
+#endif
+
 namespace boost{
 namespace multiprecision{
 namespace backends{
@@ -200,7 +219,9 @@ public:
    BOOST_STATIC_CONSTANT(unsigned, internal_limb_count =
       MinBits
          ? (MinBits / limb_bits + ((MinBits % limb_bits) ? 1 : 0))
-         : (sizeof(limb_data) / sizeof(limb_type)));
+         : (BOOST_MP_CPP_INT_INLINE_BITS / limb_bits + ((BOOST_MP_CPP_INT_INLINE_BITS % limb_bits) ? 1 : 0) > sizeof(limb_data) / sizeof(limb_type)
+            ? BOOST_MP_CPP_INT_INLINE_BITS / limb_bits + ((BOOST_MP_CPP_INT_INLINE_BITS % limb_bits) ? 1 : 0)
+            : sizeof(limb_data) / sizeof(limb_type)));
    BOOST_STATIC_CONSTANT(bool, variable = true);
 
 private:
@@ -1491,30 +1512,9 @@ private:
          }
          else
          {
-            // Base 10, we extract blocks of size 10^9 at a time, that way
-            // the number of multiplications is kept to a minimum:
-            limb_type block_mult = max_block_10;
-            while(*s)
-            {
-               limb_type block = 0;
-               for(unsigned i = 0; i < digits_per_block_10; ++i)
-               {
-                  limb_type val;
-                  if(*s >= '0' && *s <= '9')
-                     val = *s - '0';
-                  else
-                     BOOST_THROW_EXCEPTION(std::runtime_error("Unexpected character encountered in input."));
-                  block *= 10;
-                  block += val;
-                  if(!*++s)
-                  {
-                     block_mult = block_multiplier(i);
-                     break;
-                  }
-               }
-               eval_multiply(result, block_mult);
-               eval_add(result, block);
-            }
+            // Base 10, either a block of digits at a time, or for long strings
+            // by divide and conquer, see cpp_int/radix.hpp:
+            assign_decimal_string(result, s);
          }
       }
       if(isneg)
@@ -1685,39 +1685,16 @@ private:
       }
       else
       {
-         result.assign(Bits / 3 + 1, '0');
-         std::string::difference_type pos = result.size() - 1;
-         cpp_int_backend t(*this);
-         cpp_int_backend r;
-         bool neg = false;
-         if(t.sign())
-         {
-            t.negate();
-            neg = true;
-         }
+         bool neg = this->sign();
          if(this->size() == 1)
          {
-            result = boost::lexical_cast<std::string>(t.limbs()[0]);
+            result = boost::lexical_cast<std::string>(this->limbs()[0]);
          }
          else
          {
-            cpp_int_backend block10;
-            block10 = max_block_10;
-            while(eval_get_sign(t) != 0)
-            {
-               cpp_int_backend t2;
-               divide_unsigned_helper(&t2, t, block10, r);
-               t = t2;
-               limb_type v = r.limbs()[0];
-               for(unsigned i = 0; i < digits_per_block_10; ++i)
-               {
-                  char c = '0' + v % 10;
-                  v /= 10;
-                  result[pos] = c;
-                  if(pos-- == 0)
-                     break;
-               }
-            }
+            // Either a block of digits at a time, or for large values by divide
+            // and conquer, see cpp_int/radix.hpp:
+            get_decimal_string(result, *this);
          }
          std::string::size_type n = result.find_first_not_of('0');
          result.erase(0, n);
@@ -1915,6 +1892,9 @@ typedef number<cpp_int_backend<> >                   cpp_int;
 typedef rational_adaptor<cpp_int_backend<> >         cpp_rational_backend;
 typedef number<cpp_rational_backend>                 cpp_rational;
 
+// Arbitrary precision type whose storage comes from a per thread pool:
+typedef number<cpp_int_backend<0, 0, signed_magnitude, unchecked, pool_allocator<limb_type> > > cpp_int_pooled;
+
 // Fixed precision unsigned types:
 typedef number<cpp_int_backend<128, 128, unsigned_magnitude, unchecked, void> >   uint128_t;
 typedef number<cpp_int_backend<256, 256, unsigned_magnitude, unchecked, void> >   uint256_t;
@@ -1963,11 +1943,19 @@ struct is_explicitly_convertible<cpp_int_backend<MinBits, MaxBits, SignType, Che
 // Last of all we include the implementations of all the eval_* non member functions:
 //
 #include <boost/multiprecision/cpp_int/comparison.hpp>
+#include <boost/multiprecision/cpp_int/intel_intrinsics.hpp>
 #include <boost/multiprecision/cpp_int/add.hpp>
+#include <boost/multiprecision/cpp_int/karatsuba.hpp>
 #include <boost/multiprecision/cpp_int/multiply.hpp>
+#include <boost/multiprecision/cpp_int/unrolled.hpp>
+#include <boost/multiprecision/cpp_int/divide_subquadratic.hpp>
 #include <boost/multiprecision/cpp_int/divide.hpp>
+#include <boost/multiprecision/cpp_int/divisor.hpp>
 #include <boost/multiprecision/cpp_int/bitwise.hpp>
+#include <boost/multiprecision/cpp_int/gcd.hpp>
 #include <boost/multiprecision/cpp_int/misc.hpp>
+#include <boost/multiprecision/cpp_int/powm.hpp>
+#include <boost/multiprecision/cpp_int/radix.hpp>
 #include <boost/multiprecision/cpp_int/limits.hpp>
 #ifdef BOOST_MP_USER_DEFINED_LITERALS
 #include <boost/multiprecision/cpp_int/literals.hpp>
@@ -46,17 +46,8 @@ inline void add_unsigned(CppInt1& result, const CppInt2& a, const CppInt3& b) BO
       swap(pa, pb);
    
    // First where a and b overlap:
-   while(pr != pr_end)
-   {
-      carry += static_cast<double_limb_type>(*pa) + static_cast<double_limb_type>(*pb);
-#ifdef __MSVC_RUNTIME_CHECKS
-      *pr = static_cast<limb_type>(carry & ~static_cast<limb_type>(0));
-#else
-      *pr = static_cast<limb_type>(carry);
-#endif
-      carry >>= CppInt1::limb_bits;
-      ++pr, ++pa, ++pb;
-   }
+   carry = detail::add_limbs_n(pr, pa, pb, m);
+   pr += m, pa += m;
    pr_end += x - m;
    // Now where only a has digits:
    while(pr != pr_end)
@@ -182,15 +173,9 @@ inline void subtract_unsigned(CppInt1& result, const CppInt2& a, const CppInt3&
       return;
    }
    
-   unsigned i = 0;
    // First where a and b overlap:
-   while(i < m)
-   {
-      borrow = static_cast<double_limb_type>(pa[i]) - static_cast<double_limb_type>(pb[i]) - borrow;
-      pr[i] = static_cast<limb_type>(borrow);
-      borrow = (borrow >> CppInt1::limb_bits) & 1u;
-      ++i;
-   }
+   borrow = detail::subtract_limbs_n(pr, pa, pb, m);
+   unsigned i = m;
    // Now where only a has digits, only as long as we've borrowed:
    while(borrow && (i < x))
    {
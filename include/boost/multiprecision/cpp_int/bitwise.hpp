@@ -84,8 +84,7 @@ void bitwise_op(
    {
       if(!o.sign())
       {
-         for(unsigned i = 0; i < os; ++i)
-            pr[i] = op(pr[i], po[i]);
+         detail::bitwise_limbs(pr, po, os, op);
          for(unsigned i = os; i < x; ++i)
             pr[i] = op(pr[i], limb_type(0));
       }
@@ -206,17 +205,34 @@ void bitwise_op(
    for(unsigned i = rs; i < x; ++i)
       pr[i] = 0;
 
-   for(unsigned i = 0; i < os; ++i)
-      pr[i] = op(pr[i], po[i]);
+   detail::bitwise_limbs(pr, po, os, op);
    for(unsigned i = os; i < x; ++i)
       pr[i] = op(pr[i], limb_type(0));
 
    result.normalize();
 }
 
-struct bit_and{ limb_type operator()(limb_type a, limb_type b)const BOOST_NOEXCEPT { return a & b; } };
-struct bit_or { limb_type operator()(limb_type a, limb_type b)const BOOST_NOEXCEPT { return a | b; } };
-struct bit_xor{ limb_type operator()(limb_type a, limb_type b)const BOOST_NOEXCEPT { return a ^ b; } };
+struct bit_and
+{
+   limb_type operator()(limb_type a, limb_type b)const BOOST_NOEXCEPT { return a & b; }
+#ifdef BOOST_MP_HAS_LIMB_VECTOR
+   detail::limb_vector operator()(detail::limb_vector a, detail::limb_vector b)const BOOST_NOEXCEPT { return detail::limb_vector_and(a, b); }
+#endif
+};
+struct bit_or
+{
+   limb_type operator()(limb_type a, limb_type b)const BOOST_NOEXCEPT { return a | b; }
+#ifdef BOOST_MP_HAS_LIMB_VECTOR
+   detail::limb_vector operator()(detail::limb_vector a, detail::limb_vector b)const BOOST_NOEXCEPT { return detail::limb_vector_or(a, b); }
+#endif
+};
+struct bit_xor
+{
+   limb_type operator()(limb_type a, limb_type b)const BOOST_NOEXCEPT { return a ^ b; }
+#ifdef BOOST_MP_HAS_LIMB_VECTOR
+   detail::limb_vector operator()(detail::limb_vector a, detail::limb_vector b)const BOOST_NOEXCEPT { return detail::limb_vector_xor(a, b); }
+#endif
+};
 
 template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1, unsigned MinBits2, unsigned MaxBits2, cpp_integer_type SignType2, cpp_int_check_type Checked2, class Allocator2>
 BOOST_MP_FORCEINLINE typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value && !is_trivial_cpp_int<cpp_int_backend<MinBits2, MaxBits2, SignType2, Checked2, Allocator2> >::value >::type
@@ -299,8 +315,7 @@ BOOST_MP_FORCEINLINE typename enable_if_c<is_unsigned_number<cpp_int_backend<Min
 {
    unsigned os = o.size();
    result.resize(UINT_MAX, os);
-   for(unsigned i = 0; i < os; ++i)
-      result.limbs()[i] = ~o.limbs()[i];
+   detail::complement_limbs(result.limbs(), o.limbs(), os);
    for(unsigned i = os; i < result.size(); ++i)
       result.limbs()[i] = ~static_cast<limb_type>(0);
    result.normalize();
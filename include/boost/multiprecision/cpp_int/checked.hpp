@@ -6,6 +6,18 @@
 #ifndef BOOST_MP_CPP_INT_CHECKED_HPP
 #define BOOST_MP_CPP_INT_CHECKED_HPP
 
+//
+// When the compiler has it, the overflow checking multiply compiles to the multiplication
+// followed by a test of the overflow flag, including for __int128:
+//
+#if defined(__has_builtin)
+#  if __has_builtin(__builtin_mul_overflow)
+#     define BOOST_MP_HAS_MUL_OVERFLOW_BUILTIN
+#  endif
+#elif defined(BOOST_GCC) && (__GNUC__ >= 5)
+#  define BOOST_MP_HAS_MUL_OVERFLOW_BUILTIN
+#endif
+
 namespace boost{ namespace multiprecision{ namespace backends{ namespace detail{
 
 //
@@ -103,10 +115,22 @@ inline A checked_subtract(A a, A b, const mpl::int_<unchecked>&)
 template <class A>
 inline A checked_multiply(A a, A b, const mpl::int_<checked>&)
 {
+#ifdef BOOST_MP_HAS_MUL_OVERFLOW_BUILTIN
+   A result;
+   if(__builtin_mul_overflow(a, b, &result))
+      raise_mul_overflow();
+   return result;
+#else
    BOOST_MP_USING_ABS
-   if(a && (integer_traits<A>::const_max / abs(a) < abs(b)))
+   //
+   // The product can only overflow when one argument uses more than half the bits of A,
+   // so the division - a library call for double_limb_type - is only needed then:
+   //
+   static const unsigned half_bits = (sizeof(A) * CHAR_BIT - (boost::is_signed<A>::value ? 1 : 0)) / 2;
+   if(((abs(a) | abs(b)) >> half_bits) && a && (integer_traits<A>::const_max / abs(a) < abs(b)))
       raise_mul_overflow();
    return a * b;
+#endif
 }
 template <class A>
 inline A checked_multiply(A a, A b, const mpl::int_<unchecked>&)
@@ -10,6 +10,43 @@
 
 namespace boost{ namespace multiprecision{ namespace backends{
 
+//
+// Division via the limb based routines in divide_subquadratic.hpp, as with
+// divide_unsigned_helper below, both the quotient and remainder take the sign of x.
+// Small values use stack storage, so that fixed precision types don't allocate:
+//
+template <class CppInt1, class CppInt2, class CppInt3>
+void divide_limbs_helper(CppInt1* result, const CppInt2& x, const CppInt3& y, CppInt1& r, limb_type* storage)
+{
+   unsigned xn = x.size();
+   unsigned yn = y.size();
+   detail::divide_limbs(storage, storage + xn - yn + 1, x.limbs(), xn, y.limbs(), yn, storage + xn + 1);
+   if(result)
+   {
+      copy_product_result(*result, storage, xn - yn + 1);
+      result->sign(x.sign());
+   }
+   copy_product_result(r, storage + xn - yn + 1, yn);
+   r.sign(x.sign());
+}
+
+template <class CppInt1, class CppInt2, class CppInt3>
+void divide_limbs_helper(CppInt1* result, const CppInt2& x, const CppInt3& y, CppInt1& r)
+{
+   static const unsigned stack_size = 256;
+   unsigned storage_size = x.size() + 1 + detail::divide_limbs_storage(x.size(), y.size());
+   if(storage_size > stack_size)
+   {
+      std::vector<limb_type> storage(storage_size);
+      divide_limbs_helper(result, x, y, r, &storage[0]);
+   }
+   else
+   {
+      limb_type storage[stack_size];
+      divide_limbs_helper(result, x, y, r, storage);
+   }
+}
+
 template <class CppInt1, class CppInt2, class CppInt3>
 void divide_unsigned_helper(
    CppInt1* result, 
@@ -134,6 +171,15 @@ void divide_unsigned_helper(
       r = a % b;
       return;
    }
+   else if(r_order - y_order >= 3)
+   {
+      //
+      // Unless the quotient is very short, Knuth's algorithm D and the subquadratic
+      // routines are faster than the code below:
+      //
+      divide_limbs_helper(result, x, y, r);
+      return;
+   }
    //
    // prepare result:
    //
@@ -396,64 +442,21 @@ void divide_unsigned_helper(
       r.sign(x.sign());
       return;
    }
-
-   // This is initialised just to keep the compiler from emitting useless warnings later on:
-   typename CppInt1::limb_pointer pres = typename CppInt1::limb_pointer();
-   if(result)
-   {
-      result->resize(r_order + 1, r_order + 1);
-      pres = result->limbs();
-      if(result->size() > r_order)
-         pres[r_order] = 0;  // just in case we don't set the most significant limb below.
-   }
-
-   do
-   {
-      //
-      // Calculate our best guess for how many times y divides into r:
-      //
-      if((pr[r_order] < y) && r_order)
-      {
-         double_limb_type a, b;
-         a = (static_cast<double_limb_type>(pr[r_order]) << CppInt1::limb_bits) | pr[r_order - 1];
-         b = a % y;
-         r.resize(r.size() - 1, r.size() - 1);
-         --r_order;
-         pr[r_order] = static_cast<limb_type>(b);
-         if(result)
-            pres[r_order] = static_cast<limb_type>(a / y);
-         if(r_order && pr[r_order] == 0)
-         {
-            --r_order;  // No remainder, division was exact.
-            r.resize(r.size() - 1, r.size() - 1);
-            if(result)
-               pres[r_order] = static_cast<limb_type>(0u);
-         }
-      }
-      else
-      {
-         if(result)
-            pres[r_order] = pr[r_order] / y;
-         pr[r_order] %= y;
-         if(r_order && pr[r_order] == 0)
-         {
-            --r_order;  // No remainder, division was exact.
-            r.resize(r.size() - 1, r.size() - 1);
-            if(result)
-               pres[r_order] = static_cast<limb_type>(0u);
-         }
-      }
-   }
-   // Termination condition is really just a check that r >= y, but with two common
-   // short-circuit cases handled first:
-   while(r_order || (pr[r_order] >= y));
-
+   //
+   // Otherwise divide one limb at a time by multiplying by a reciprocal of y, see
+   // divide_limbs_1 in divide_subquadratic.hpp, which beyond two limbs is quicker than
+   // a double limb division for each.  The quotient overwrites r:
+   //
+   unsigned s = detail::leading_zero_bits(y);
+   limb_type d = y << s;
+   limb_type rem = detail::divide_limbs_1(result ? pr : 0, pr, r.size(), d, s, detail::reciprocal_limb(d));
    if(result)
    {
-      result->normalize();
+      r.normalize();
+      result->swap(r);
       result->sign(x.sign());
    }
-   r.normalize();
+   r = rem;
    r.sign(x.sign());
 
    BOOST_ASSERT(r.compare(y) < 0); // remainder must be less than the divisor or our code has failed
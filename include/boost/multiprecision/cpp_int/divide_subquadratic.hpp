@@ -0,0 +1,505 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Division routines for large cpp_int_backend values.
+//
+// The long division in divide.hpp is quadratic in the size of the arguments, here we
+// use Knuth's algorithm D as the base case for Burnikel and Ziegler's recursive division,
+// which reduces division to multiplication, so that Karatsuba and Toom-3 multiplication
+// (see karatsuba.hpp) make division faster too.  For the very largest divisors, where
+// multiplication is via a number theoretic transform, we compute a reciprocal of the
+// divisor via Newton iteration, and then obtain the quotient by multiplication alone.
+//
+// As with karatsuba.hpp, all of the routines here operate on raw arrays of limbs.
+//
+#ifndef BOOST_MP_CPP_INT_DIVIDE_SUBQUADRATIC_HPP
+#define BOOST_MP_CPP_INT_DIVIDE_SUBQUADRATIC_HPP
+
+//
+// Divisor size (in limbs) at which we switch from Knuth's algorithm D to
+// Burnikel-Ziegler division, and from there to division via a Newton reciprocal.
+// The quotient must be at least BOOST_MP_BZ_DIVISION_CUTOFF limbs long too, otherwise
+// the long division is already linear in the size of the divisor.  See
+// performance/divide_performance.cpp for the benchmarks used to choose these values.
+//
+#ifndef BOOST_MP_BZ_DIVISION_CUTOFF
+#  define BOOST_MP_BZ_DIVISION_CUTOFF 200
+#endif
+#ifndef BOOST_MP_NEWTON_DIVISION_CUTOFF
+#  define BOOST_MP_NEWTON_DIVISION_CUTOFF 16000
+#endif
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127) // conditional expression is constant
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_BZ_DIVISION_CUTOFF >= 4, "The Burnikel-Ziegler division cutoff must be at least 4 limbs.");
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_NEWTON_DIVISION_CUTOFF >= BOOST_MP_BZ_DIVISION_CUTOFF, "The Newton division cutoff may not be lower than the Burnikel-Ziegler cutoff.");
+
+static const unsigned bz_division_cutoff = BOOST_MP_BZ_DIVISION_CUTOFF;
+static const unsigned newton_division_cutoff = BOOST_MP_NEWTON_DIVISION_CUTOFF;
+
+namespace detail{
+
+//
+// r = a << s (or a >> s) for 0 <= s < bits_per_limb, where a and r have n limbs and may
+// be the same array.  Returns the bits shifted out:
+//
+inline limb_type left_shift_limbs(limb_type* r, const limb_type* a, unsigned n, unsigned s) BOOST_NOEXCEPT
+{
+   if(!s)
+   {
+      std::memmove(r, a, n * sizeof(limb_type));
+      return 0;
+   }
+   limb_type carry = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      limb_type l = a[i];
+      r[i] = (l << s) | carry;
+      carry = l >> (bits_per_limb - s);
+   }
+   return carry;
+}
+
+inline void right_shift_limbs(limb_type* r, const limb_type* a, unsigned n, unsigned s) BOOST_NOEXCEPT
+{
+   if(!s)
+   {
+      std::memmove(r, a, n * sizeof(limb_type));
+      return;
+   }
+   for(unsigned i = 0; i + 1 < n; ++i)
+      r[i] = (a[i] >> s) | (a[i + 1] << (bits_per_limb - s));
+   if(n)
+      r[n - 1] = a[n - 1] >> s;
+}
+
+inline unsigned leading_zero_bits(limb_type l) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(l);
+   return bits_per_limb - 1 - boost::multiprecision::detail::find_msb(l);
+}
+
+//
+// Division by invariant integers, after Moller and Granlund, "Improved division by invariant
+// integers", IEEE Transactions on Computers, 2011.  Dividing a double limb by a limb is a
+// library call for most compilers, so instead, for a normalized divisor d we compute once the
+// reciprocal floor((B^2 - 1) / d) - B, after which each quotient limb requires two
+// multiplications and some adjustments.
+//
+inline limb_type reciprocal_limb(limb_type d) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(d >> (bits_per_limb - 1));
+   return static_cast<limb_type>(((static_cast<double_limb_type>(static_cast<limb_type>(~d)) << bits_per_limb) | static_cast<limb_type>(~static_cast<limb_type>(0u))) / d);
+}
+//
+// Returns the quotient of the two limb value [u1, u0] by d, where u1 < d and d is normalized
+// with reciprocal v, the remainder is written to r:
+//
+BOOST_MP_FORCEINLINE limb_type divide_2by1_preinv(limb_type u1, limb_type u0, limb_type d, limb_type v, limb_type& r) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(u1 < d);
+   double_limb_type t = static_cast<double_limb_type>(v) * u1 + ((static_cast<double_limb_type>(u1 + 1) << bits_per_limb) | u0);
+   limb_type q = static_cast<limb_type>(t >> bits_per_limb);
+   limb_type rem = u0 - q * d;
+   if(rem > static_cast<limb_type>(t))
+   {
+      --q;
+      rem += d;
+   }
+   if(rem >= d)
+   {
+      ++q;
+      rem -= d;
+   }
+   r = rem;
+   return q;
+}
+//
+// Sets q to the n limbs of x divided by d << s, where d is normalized with reciprocal v,
+// and returns the remainder.  q may be the same array as x, or null if only the remainder
+// is required:
+//
+inline limb_type divide_limbs_1(limb_type* q, const limb_type* x, unsigned n, limb_type d, unsigned s, limb_type v) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(n && (d >> (bits_per_limb - 1)) && (s < bits_per_limb));
+   limb_type r = 0;
+   if(s)
+   {
+      //
+      // Shift x left by s bits as we go, so that the divisor is normalized:
+      //
+      r = x[n - 1] >> (bits_per_limb - s);
+      for(unsigned i = n - 1; i > 0; --i)
+      {
+         limb_type qi = divide_2by1_preinv(r, (x[i] << s) | (x[i - 1] >> (bits_per_limb - s)), d, v, r);
+         if(q)
+            q[i] = qi;
+      }
+      limb_type qi = divide_2by1_preinv(r, x[0] << s, d, v, r);
+      if(q)
+         q[0] = qi;
+      return r >> s;
+   }
+   for(unsigned i = n; i-- > 0;)
+   {
+      limb_type qi = divide_2by1_preinv(r, x[i], d, v, r);
+      if(q)
+         q[i] = qi;
+   }
+   return r;
+}
+
+//
+// Knuth's algorithm D: divides u (un limbs) by the normalized divisor v (vn >= 2 limbs,
+// most significant bit set), where the most significant vn limbs of u are less than v.
+// The un - vn limb quotient is written to q, and the remainder left in the low vn
+// limbs of u (the remaining limbs of u are zeroed).  inv is reciprocal_limb(v[vn - 1]):
+//
+inline void divide_schoolbook_limbs(limb_type* q, limb_type* u, unsigned un, const limb_type* v, unsigned vn, limb_type inv) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT((vn >= 2) && (un >= vn) && (v[vn - 1] >> (bits_per_limb - 1)));
+   const limb_type v1 = v[vn - 1];
+   const limb_type v2 = v[vn - 2];
+   for(unsigned j = un - vn; j-- > 0;)
+   {
+      limb_type* uj = u + j;
+      //
+      // Estimate the next quotient limb from the top two limbs of the divisor, the
+      // estimate is then either correct or one too large:
+      //
+      limb_type qhat, rhat;
+      bool rhat_valid;
+      if(uj[vn] >= v1)
+      {
+         qhat = ~static_cast<limb_type>(0u);
+         rhat = uj[vn - 1] + v1;
+         rhat_valid = rhat >= v1;
+      }
+      else
+      {
+         qhat = divide_2by1_preinv(uj[vn], uj[vn - 1], v1, inv, rhat);
+         rhat_valid = true;
+      }
+      while(rhat_valid && (static_cast<double_limb_type>(qhat) * v2 > ((static_cast<double_limb_type>(rhat) << bits_per_limb) | uj[vn - 2])))
+      {
+         --qhat;
+         rhat += v1;
+         rhat_valid = rhat >= v1;
+      }
+      //
+      // Subtract qhat * v from u:
+      //
+      double_limb_type carry = 0;
+      limb_type borrow = 0;
+      for(unsigned i = 0; i < vn; ++i)
+      {
+         carry += static_cast<double_limb_type>(qhat) * v[i];
+         limb_type p = static_cast<limb_type>(carry);
+         carry >>= bits_per_limb;
+         limb_type d = uj[i] - p;
+         limb_type b = uj[i] < p;
+         uj[i] = d - borrow;
+         borrow = b + (d < borrow);
+      }
+      double_limb_type top = static_cast<double_limb_type>(static_cast<limb_type>(carry)) + borrow;
+      if(top > uj[vn])
+      {
+         //
+         // Rare case: qhat was one too large, so add v back:
+         //
+         --qhat;
+         add_limbs(uj, uj, vn, v, vn);
+      }
+      uj[vn] = 0;
+      q[j] = qhat;
+   }
+}
+
+inline void divide_schoolbook_limbs(limb_type* q, limb_type* u, unsigned un, const limb_type* v, unsigned vn) BOOST_NOEXCEPT
+{
+   divide_schoolbook_limbs(q, u, un, v, vn, reciprocal_limb(v[vn - 1]));
+}
+
+//
+// Burnikel-Ziegler recursive division.  divide_2n_1n_limbs divides the 2n limb value a by
+// the normalized n limb value b, where the top n limbs of a are less than b, the n limb
+// quotient is written to q and the remainder left in the low n limbs of a.  It is
+// implemented in terms of divide_3n_2n_limbs which divides 3h limbs by 2h limbs, which
+// in turn calls divide_2n_1n_limbs on half sized values.  The recursion stops at odd sizes
+// which is why the caller pads the divisor to a size with many trailing zero bits.
+//
+inline unsigned divide_bz_storage(unsigned n) BOOST_NOEXCEPT
+{
+   if((n & 1u) || (n < bz_division_cutoff))
+      return 0;
+   unsigned h = n / 2;
+   return 2 * h + (std::max)(multiply_limbs_storage(h, h), divide_bz_storage(h));
+}
+
+inline void divide_3n_2n_limbs(limb_type* q, limb_type* a, const limb_type* b, unsigned h, limb_type* scratch);
+
+inline void divide_2n_1n_limbs(limb_type* q, limb_type* a, const limb_type* b, unsigned n, limb_type* scratch)
+{
+   if((n & 1u) || (n < bz_division_cutoff))
+   {
+      divide_schoolbook_limbs(q, a, 2 * n, b, n);
+      return;
+   }
+   unsigned h = n / 2;
+   divide_3n_2n_limbs(q + h, a + h, b, h, scratch);
+   divide_3n_2n_limbs(q, a, b, h, scratch);
+}
+
+inline void divide_3n_2n_limbs(limb_type* q, limb_type* a, const limb_type* b, unsigned h, limb_type* scratch)
+{
+   const limb_type* b1 = b + h;
+   limb_type* d = scratch;
+   scratch += 2 * h;
+   //
+   // Estimate the quotient from the top limbs of a and b:
+   //
+   if(compare_limbs(a + 2 * h, h, b1, h) < 0)
+      divide_2n_1n_limbs(q, a + h, b1, h, scratch);
+   else
+   {
+      //
+      // Quotient is B^h - 1, and the top h limbs of a equal b1, so the remainder
+      // from the top 2h limbs is a[h, 2h) + b1:
+      //
+      for(unsigned i = 0; i < h; ++i)
+      {
+         q[i] = ~static_cast<limb_type>(0u);
+         a[2 * h + i] = 0;
+      }
+      add_limbs(a + h, a + h, 2 * h, b1, h);
+   }
+   //
+   // Subtract q * b2 from the remainder, the estimate may be up to 2 too large,
+   // in which case the result is negative and we add b back:
+   //
+   multiply_limbs(d, q, h, b, h, scratch);
+   limb_type borrow = subtract_limbs(a, a, 3 * h, d, 2 * h);
+   while(borrow)
+   {
+      for(unsigned i = 0; !q[i]--; ++i) {}
+      borrow -= add_limbs(a, a, 3 * h, b, 2 * h);
+   }
+}
+
+//
+// Newton iteration: sets v (k + 1 limbs) to an approximation to B^2k / d, where d is a
+// normalized value of k limbs.  Each step doubles the precision of the approximation
+// for the top half of d, the base case (once k is a quarter of the Newton cutoff) is a division:
+//
+inline unsigned divide_limbs_storage(unsigned xn, unsigned yn) BOOST_NOEXCEPT;
+inline void divide_limbs(limb_type* q, limb_type* r, const limb_type* x, unsigned xn, const limb_type* y, unsigned yn, limb_type* scratch);
+
+inline void newton_reciprocal_limbs(limb_type* v, const limb_type* d, unsigned k)
+{
+   if((k < newton_division_cutoff / 4) || (k < 4))
+   {
+      // The quotient has k + 2 limbs, but the top one is always zero:
+      std::vector<limb_type> u(2 * k + 1), quotient(k + 2), r(k), scratch(divide_limbs_storage(2 * k + 1, k));
+      u[2 * k] = 1;
+      divide_limbs(&quotient[0], &r[0], &u[0], 2 * k + 1, d, k, &scratch[0]);
+      std::memcpy(v, &quotient[0], (k + 1) * sizeof(limb_type));
+      return;
+   }
+   unsigned l = k / 2;
+   unsigned h = k - l;
+   std::vector<limb_type> vh(h + 1);
+   newton_reciprocal_limbs(&vh[0], d + l, h);
+   //
+   // With x = vh * B^l the next approximation is x + x * (B^2k - d * x) / B^2k,
+   // and the error term e = B^(k + h) - d * vh is small:
+   //
+   std::vector<limb_type> e(k + h + 1), t;
+   std::vector<limb_type> scratch(multiply_limbs_storage(k, h + 1) + 1);
+   multiply_limbs(&e[0], d, k, &vh[0], h + 1, &scratch[0]);
+   bool neg = e[k + h] != 0;
+   if(neg)
+      --e[k + h];
+   else
+   {
+      // e = B^(k+h) - e, via the two's complement of the low k + h limbs:
+      unsigned i = 0;
+      while((i < k + h) && !e[i])
+         ++i;
+      if(i < k + h)
+      {
+         e[i] = 0 - e[i];
+         for(++i; i < k + h; ++i)
+            e[i] = ~e[i];
+      }
+   }
+   unsigned en = k + h + 1;
+   while(en && !e[en - 1])
+      --en;
+   std::fill(v, v + l, static_cast<limb_type>(0u));
+   std::memcpy(v + l, &vh[0], (h + 1) * sizeof(limb_type));
+   if(en + 1 > h)
+   {
+      t.resize(h + 1 + en);
+      scratch.resize(multiply_limbs_storage(h + 1, en) + 1);
+      multiply_limbs(&t[0], &vh[0], h + 1, &e[0], en, &scratch[0]);
+      unsigned tn = en + 1 - h;
+      while(tn && !t[2 * h + tn - 1])
+         --tn;
+      if(tn)
+      {
+         BOOST_ASSERT(tn <= k + 1);
+         if(neg)
+            subtract_limbs(v, v, k + 1, &t[2 * h], tn);
+         else
+            add_limbs(v, v, k + 1, &t[2 * h], tn);
+      }
+   }
+}
+
+//
+// Divides the 2n limb value a by the normalized n limb value b, where the top n limbs of a
+// are less than b, using the reciprocal v computed above: the n limb quotient is written
+// to q and the remainder left in the low n limbs of a.  Scratch requires
+// 4n + 1 + multiply_limbs_storage(n, n + 1) limbs.
+//
+inline void divide_newton_2n_1n_limbs(limb_type* q, limb_type* a, const limb_type* b, unsigned n, const limb_type* v, limb_type* scratch)
+{
+   limb_type* p = scratch;
+   limb_type* prod = scratch + 2 * n + 1;
+   scratch = prod + 2 * n;
+   multiply_limbs(p, a + n, n, v, n + 1, scratch);
+   if(p[2 * n])
+   {
+      // The estimate can't exceed B^n - 1:
+      for(unsigned i = 0; i < n; ++i)
+         p[n + i] = ~static_cast<limb_type>(0u);
+   }
+   std::memcpy(q, p + n, n * sizeof(limb_type));
+   multiply_limbs(prod, q, n, b, n, scratch);
+   limb_type borrow = subtract_limbs(a, a, 2 * n, prod, 2 * n);
+   while(borrow)
+   {
+      for(unsigned i = 0; !q[i]--; ++i) {}
+      borrow -= add_limbs(a, a, 2 * n, b, n);
+   }
+   while(compare_limbs(a, 2 * n, b, n) >= 0)
+   {
+      for(unsigned i = 0; !++q[i]; ++i) {}
+      subtract_limbs(a, a, 2 * n, b, n);
+   }
+}
+
+//
+// Top level entry point: computes q = x / y (xn - yn + 1 limbs) and r = x % y (yn limbs),
+// where xn >= yn >= 2 and the most significant limb of y is non-zero.  Scratch must have
+// room for divide_limbs_storage(xn, yn) limbs, which is all that's required by Knuth's
+// algorithm, the subquadratic routines allocate whatever further memory they need.
+//
+inline unsigned divide_limbs_storage(unsigned xn, unsigned yn) BOOST_NOEXCEPT
+{
+   return xn + yn + 1;
+}
+
+inline void divide_limbs(limb_type* q, limb_type* r, const limb_type* x, unsigned xn, const limb_type* y, unsigned yn, limb_type* scratch)
+{
+   BOOST_ASSERT((xn >= yn) && (yn >= 2) && y[yn - 1]);
+   unsigned m = xn - yn;
+   //
+   // Normalize so that the most significant bit of the divisor is set, the numerator gets one
+   // extra limb for the shift, which guarantees that its top yn limbs are less than the divisor:
+   //
+   unsigned s = leading_zero_bits(y[yn - 1]);
+   if((yn < bz_division_cutoff) || (m < bz_division_cutoff))
+   {
+      limb_type* a = scratch;
+      limb_type* b = scratch + xn + 1;
+      left_shift_limbs(b, y, yn, s);
+      a[xn] = left_shift_limbs(a, x, xn, s);
+      divide_schoolbook_limbs(q, a, xn + 1, b, yn);
+      right_shift_limbs(r, a, yn, s);
+      return;
+   }
+   if(m + 2 < yn)
+   {
+      //
+      // The quotient is much shorter than the divisor: divide the leading limbs of x by
+      // the leading m + 2 limbs of y, the resulting quotient is at most 1 too small or 2 too
+      // large, we then correct it using the full remainder:
+      //
+      unsigned sh = yn - (m + 2);
+      std::vector<limb_type> t(xn + 1 + divide_limbs_storage(xn - sh, m + 2)), w(x, x + xn);
+      divide_limbs(q, &t[0], x + sh, xn - sh, y + sh, m + 2, &t[m + 2]);
+      t.resize(xn + 2 + multiply_limbs_storage(m + 1, yn));
+      multiply_limbs(&t[0], q, m + 1, y, yn, &t[xn + 1]);
+      w.push_back(0);
+      limb_type borrow = subtract_limbs(&w[0], &w[0], xn + 1, &t[0], xn + 1);
+      while(borrow)
+      {
+         for(unsigned i = 0; !q[i]--; ++i) {}
+         borrow -= add_limbs(&w[0], &w[0], xn + 1, y, yn);
+      }
+      while(compare_limbs(&w[0], xn + 1, y, yn) >= 0)
+      {
+         for(unsigned i = 0; !++q[i]; ++i) {}
+         subtract_limbs(&w[0], &w[0], xn + 1, y, yn);
+      }
+      std::memcpy(r, &w[0], yn * sizeof(limb_type));
+      return;
+   }
+   //
+   // For Burnikel-Ziegler division we also pad the divisor with zero limbs to a size
+   // n = j * 2^k with j below the cutoff, so that the recursion always stops at the cutoff,
+   // the numerator is padded to match and then to a whole number of chunks of n limbs:
+   //
+   unsigned n = yn;
+   bool use_newton = yn >= newton_division_cutoff;
+   if(!use_newton)
+   {
+      unsigned j = yn, k = 0;
+      while(j >= bz_division_cutoff)
+      {
+         j = (j + 1) / 2;
+         ++k;
+      }
+      n = j << k;
+   }
+   unsigned pad = n - yn;
+   unsigned chunks = (std::max)(2u, (xn + pad + 1 + n - 1) / n);
+   std::vector<limb_type> a(chunks * n), b(n), quotient((chunks - 1) * n);
+   left_shift_limbs(&b[pad], y, yn, s);
+   a[xn + pad] = left_shift_limbs(&a[pad], x, xn, s);
+   if(use_newton)
+   {
+      std::vector<limb_type> v(n + 1), t(4 * n + 1 + multiply_limbs_storage(n, n + 1));
+      newton_reciprocal_limbs(&v[0], &b[0], n);
+      for(unsigned i = chunks - 1; i-- > 0;)
+         divide_newton_2n_1n_limbs(&quotient[i * n], &a[i * n], &b[0], n, &v[0], &t[0]);
+   }
+   else
+   {
+      std::vector<limb_type> t(divide_bz_storage(n) + 1);
+      for(unsigned i = chunks - 1; i-- > 0;)
+         divide_2n_1n_limbs(&quotient[i * n], &a[i * n], &b[0], n, &t[0]);
+   }
+   std::memcpy(q, &quotient[0], (m + 1) * sizeof(limb_type));
+   right_shift_limbs(r, &a[pad], yn, s);
+}
+
+} // namespace detail
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+}}} // namespaces
+
+#endif
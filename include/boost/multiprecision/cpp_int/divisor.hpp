@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// divisor<Number> holds a value together with whatever can be precomputed to speed up
+// repeated division by it.  For cpp_int that is the divisor shifted so that its most
+// significant bit is set, and the reciprocal of its top limb (see reciprocal_limb in
+// divide_subquadratic.hpp), so that each division skips the normalization of the divisor
+// and every quotient limb is found by multiplication rather than division.  For other
+// types it simply forwards to the usual operators.
+//
+#ifndef BOOST_MP_CPP_INT_DIVISOR_HPP
+#define BOOST_MP_CPP_INT_DIVISOR_HPP
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{
+
+template <class Number>
+class divisor
+{
+public:
+   explicit divisor(const Number& d) : m_value(d)
+   {
+      if(m_value == 0)
+         BOOST_THROW_EXCEPTION(std::overflow_error("Integer Division by zero."));
+   }
+   const Number& value()const { return m_value; }
+
+   friend Number operator / (const Number& x, const divisor& d)
+   {
+      return x / d.m_value;
+   }
+   friend Number operator % (const Number& x, const divisor& d)
+   {
+      return x % d.m_value;
+   }
+   friend void divide_qr(const Number& x, const divisor& d, Number& q, Number& r)
+   {
+      boost::multiprecision::divide_qr(x, d.m_value, q, r);
+   }
+private:
+   Number m_value;
+};
+
+template <unsigned MinBits, unsigned MaxBits, cpp_integer_type SignType, cpp_int_check_type Checked, class Allocator, expression_template_option ExpressionTemplates>
+class divisor<number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates> >
+{
+   typedef number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates> number_type;
+   typedef cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>                           backend_type;
+   typedef mpl::bool_<backends::is_trivial_cpp_int<backend_type>::value>                              trivial_tag;
+public:
+   explicit divisor(const number_type& d) : m_value(d), m_shift(0), m_inv(0)
+   {
+      if(m_value == 0)
+         BOOST_THROW_EXCEPTION(std::overflow_error("Integer Division by zero."));
+      init(trivial_tag());
+   }
+   const number_type& value()const { return m_value; }
+
+   friend number_type operator / (const number_type& x, const divisor& d)
+   {
+      number_type q, r;
+      d.divide(x.backend(), &q.backend(), r.backend(), trivial_tag());
+      return q;
+   }
+   friend number_type operator % (const number_type& x, const divisor& d)
+   {
+      number_type r;
+      d.divide(x.backend(), static_cast<backend_type*>(0), r.backend(), trivial_tag());
+      return r;
+   }
+   friend void divide_qr(const number_type& x, const divisor& d, number_type& q, number_type& r)
+   {
+      if((&x == &q) || (&x == &r))
+      {
+         number_type t(x);
+         divide_qr(t, d, q, r);
+         return;
+      }
+      d.divide(x.backend(), &q.backend(), r.backend(), trivial_tag());
+   }
+private:
+   void init(const mpl::true_&) {}
+   void init(const mpl::false_&)
+   {
+      const backend_type& y = m_value.backend();
+      m_normalized.resize(y.size());
+      m_shift = backends::detail::leading_zero_bits(y.limbs()[y.size() - 1]);
+      backends::detail::left_shift_limbs(&m_normalized[0], y.limbs(), y.size(), m_shift);
+      m_inv = backends::detail::reciprocal_limb(m_normalized.back());
+   }
+
+   void divide(const backend_type& x, backend_type* q, backend_type& r, const mpl::true_&)const
+   {
+      if(q)
+      {
+         *q = x;
+         eval_divide(*q, m_value.backend());
+      }
+      r = x;
+      eval_modulus(r, m_value.backend());
+   }
+   void divide(const backend_type& x, backend_type* q, backend_type& r, const mpl::false_&)const
+   {
+      const backend_type& y = m_value.backend();
+      unsigned xn = x.size();
+      unsigned yn = y.size();
+      if(yn == 1)
+      {
+         r = x;
+         limb_type rem = backends::detail::divide_limbs_1(q ? r.limbs() : 0, r.limbs(), xn, m_normalized[0], m_shift, m_inv);
+         if(q)
+         {
+            r.normalize();
+            q->swap(r);
+            q->sign(x.sign() != y.sign());
+         }
+         r = rem;
+         r.sign(x.sign());
+      }
+      else if(x.compare_unsigned(y) < 0)
+      {
+         if(q)
+            *q = static_cast<limb_type>(0u);
+         r = x;
+      }
+      else if((yn < backends::bz_division_cutoff) || (xn - yn < backends::bz_division_cutoff))
+      {
+         //
+         // Knuth's algorithm D, but with the divisor already normalized:
+         //
+         static const unsigned stack_size = 256;
+         unsigned storage_size = 2 * xn + 2;
+         std::vector<limb_type> heap_storage;
+         limb_type stack_storage[stack_size];
+         limb_type* a = stack_storage;
+         if(storage_size > stack_size)
+         {
+            heap_storage.resize(storage_size);
+            a = &heap_storage[0];
+         }
+         limb_type* quotient = a + xn + 1;
+         a[xn] = backends::detail::left_shift_limbs(a, x.limbs(), xn, m_shift);
+         backends::detail::divide_schoolbook_limbs(quotient, a, xn + 1, &m_normalized[0], yn, m_inv);
+         backends::detail::right_shift_limbs(a, a, yn, m_shift);
+         if(q)
+         {
+            backends::copy_product_result(*q, quotient, xn - yn + 1);
+            q->sign(x.sign() != y.sign());
+         }
+         backends::copy_product_result(r, a, yn);
+         r.sign(x.sign());
+      }
+      else
+      {
+         //
+         // The subquadratic routines gain little from the precomputation:
+         //
+         backends::divide_unsigned_helper(q, x, y, r);
+         if(q)
+            q->sign(x.sign() != y.sign());
+      }
+   }
+
+   number_type            m_value;
+   std::vector<limb_type> m_normalized;
+   unsigned               m_shift;
+   limb_type              m_inv;
+};
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,433 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// GCD routines for large cpp_int_backend values.
+//
+// The binary GCD in misc.hpp needs a full width subtraction and shift for every bit or
+// two of reduction.  Here we use Lehmer's algorithm instead: the quotients of the
+// Euclidean algorithm are computed from the leading two limbs of the arguments alone
+// (see Knuth Vol 2, 4.5.2, algorithm L), and the resulting matrix of single limb cofactors
+// is applied to the full values in a single pass, which removes close to a limb per pass.
+//
+// For large values we use the half-GCD method: the Euclidean algorithm is run
+// (recursively) on the leading half of the arguments, and the resulting matrix is
+// applied to the full values with subquadratic multiplication.  The matrix computed
+// from the leading limbs may, very rarely, be slightly wrong for the full values, but
+// as it is unimodular the GCD is unchanged, and the error is corrected by later steps.
+//
+#ifndef BOOST_MP_CPP_INT_GCD_HPP
+#define BOOST_MP_CPP_INT_GCD_HPP
+
+//
+// Size (in limbs) at which we switch from binary GCD to Lehmer's algorithm, and from
+// there to the half-GCD recursion.  See performance/gcd_performance.cpp for the benchmarks
+// used to choose these values.
+//
+#ifndef BOOST_MP_LEHMER_GCD_CUTOFF
+#  define BOOST_MP_LEHMER_GCD_CUTOFF 3
+#endif
+#ifndef BOOST_MP_HGCD_CUTOFF
+#  define BOOST_MP_HGCD_CUTOFF 1000
+#endif
+
+#include <boost/multiprecision/detail/bitscan.hpp>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127) // conditional expression is constant
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_LEHMER_GCD_CUTOFF >= 2, "The Lehmer GCD cutoff must be at least 2 limbs.");
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_HGCD_CUTOFF >= 16, "The half-GCD cutoff must be at least 16 limbs.");
+
+static const unsigned lehmer_gcd_cutoff = BOOST_MP_LEHMER_GCD_CUTOFF;
+static const unsigned hgcd_cutoff = BOOST_MP_HGCD_CUTOFF;
+
+namespace detail{
+
+typedef cpp_int_backend<> gcd_big_type;
+
+//
+// Returns bits [s, s + 2 * bits_per_limb) of the n limb value p:
+//
+inline double_limb_type extract_double_limb(const limb_type* p, unsigned n, unsigned s) BOOST_NOEXCEPT
+{
+   unsigned i = s / bits_per_limb;
+   s %= bits_per_limb;
+   limb_type l[3] = { 0, 0, 0 };
+   for(unsigned j = 0; (j < 3) && (i + j < n); ++j)
+      l[j] = p[i + j];
+   double_limb_type result = l[0] | (static_cast<double_limb_type>(l[1]) << bits_per_limb);
+   if(s)
+      result = (result >> s) | (static_cast<double_limb_type>(l[2]) << (2 * bits_per_limb - s));
+   return result;
+}
+
+//
+// Most quotients in the Euclidean algorithm are small, so avoid double width division when we can:
+//
+inline double_limb_type lehmer_quotient(double_limb_type n, double_limb_type d) BOOST_NOEXCEPT
+{
+   double_limb_type q = 0;
+   while(n >= d)
+   {
+      if(q == 3)
+         return q + n / d;
+      n -= d;
+      ++q;
+   }
+   return q;
+}
+
+//
+// The result of a Lehmer step: (u, v) becomes (a * u - b * v, d * v - c * u) when odd
+// is false, and (b * v - a * u, c * u - d * v) when it is true.  All the cofactors
+// are less than 2^(bits_per_limb - 2):
+//
+struct lehmer_matrix
+{
+   limb_type a, b, c, d;
+   bool odd;
+};
+
+//
+// Computes the Lehmer matrix for u >= v > 0 from the leading 2 * bits_per_limb - 2 bits of u
+// and the same bits of v, returns false if not even one step can be taken, in which
+// case the caller must perform a full division.  The quotients are checked against
+// both the smallest and largest values that u and v could have, so that the matrix
+// is always exact (algorithm L):
+//
+inline bool lehmer_step_matrix(const limb_type* u, unsigned un, const limb_type* v, unsigned vn, lehmer_matrix& m)
+{
+   static const unsigned window = 2 * bits_per_limb - 2;
+   static const signed_double_limb_type limit = static_cast<signed_double_limb_type>(1) << (bits_per_limb - 2);
+   unsigned ubits = (un - 1) * bits_per_limb + boost::multiprecision::detail::find_msb(u[un - 1]) + 1;
+   unsigned s = ubits > window ? ubits - window : 0;
+   signed_double_limb_type uh = static_cast<signed_double_limb_type>(extract_double_limb(u, un, s));
+   signed_double_limb_type vh = static_cast<signed_double_limb_type>(extract_double_limb(v, vn, s));
+   signed_double_limb_type A = 1, B = 0, C = 0, D = 1;
+   while((vh + C > 0) && (vh + D > 0) && (uh + A >= 0) && (uh + B >= 0))
+   {
+      double_limb_type q = lehmer_quotient(static_cast<double_limb_type>(uh + A), static_cast<double_limb_type>(vh + C));
+      if((q >= static_cast<double_limb_type>(limit)) || (q != lehmer_quotient(static_cast<double_limb_type>(uh + B), static_cast<double_limb_type>(vh + D))))
+         break;
+      signed_double_limb_type sq = static_cast<signed_double_limb_type>(q);
+      signed_double_limb_type nc = A - sq * C;
+      signed_double_limb_type nd = B - sq * D;
+      if((nc >= limit) || (nc <= -limit) || (nd >= limit) || (nd <= -limit))
+         break;
+      A = C;
+      B = D;
+      C = nc;
+      D = nd;
+      signed_double_limb_type t = uh - sq * vh;
+      uh = vh;
+      vh = t;
+   }
+   if(B == 0)
+      return false;
+   m.odd = B > 0;
+   m.a = static_cast<limb_type>(A < 0 ? -A : A);
+   m.b = static_cast<limb_type>(B < 0 ? -B : B);
+   m.c = static_cast<limb_type>(C < 0 ? -C : C);
+   m.d = static_cast<limb_type>(D < 0 ? -D : D);
+   return true;
+}
+
+//
+// r = a * x - b * y, where x and y have n limbs and the result is known to be non-negative:
+//
+inline void lehmer_combine_limbs(limb_type* r, const limb_type* x, limb_type a, const limb_type* y, limb_type b, unsigned n) BOOST_NOEXCEPT
+{
+   double_limb_type cx = 0, cy = 0;
+   limb_type borrow = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      cx += static_cast<double_limb_type>(a) * x[i];
+      cy += static_cast<double_limb_type>(b) * y[i];
+      limb_type lx = static_cast<limb_type>(cx);
+      limb_type ly = static_cast<limb_type>(cy);
+      cx >>= bits_per_limb;
+      cy >>= bits_per_limb;
+      limb_type d = lx - ly;
+      limb_type b1 = lx < ly;
+      r[i] = d - borrow;
+      borrow = b1 + (d < borrow);
+   }
+}
+
+//
+// Applies the Lehmer matrix m to u >= v, t1 and t2 are temporaries:
+//
+inline void lehmer_apply(gcd_big_type& u, gcd_big_type& v, const lehmer_matrix& m, gcd_big_type& t1, gcd_big_type& t2)
+{
+   unsigned n = u.size();
+   unsigned vn = v.size();
+   v.resize(n, n);
+   std::memset(v.limbs() + vn, 0, (n - vn) * sizeof(limb_type));
+   t1.resize(n, n);
+   t2.resize(n, n);
+   if(m.odd)
+   {
+      lehmer_combine_limbs(t1.limbs(), v.limbs(), m.b, u.limbs(), m.a, n);
+      lehmer_combine_limbs(t2.limbs(), u.limbs(), m.c, v.limbs(), m.d, n);
+   }
+   else
+   {
+      lehmer_combine_limbs(t1.limbs(), u.limbs(), m.a, v.limbs(), m.b, n);
+      lehmer_combine_limbs(t2.limbs(), v.limbs(), m.d, u.limbs(), m.c, n);
+   }
+   t1.normalize();
+   t2.normalize();
+   // The temporaries may have been used for signed values elsewhere:
+   t1.sign(false);
+   t2.sign(false);
+   u.swap(t1);
+   v.swap(t2);
+}
+
+//
+// A 2x2 matrix of signed values, for the transformations of (u, v) computed by the
+// routines below, m[0] and m[1] are the first row:
+//
+struct gcd_matrix
+{
+   gcd_big_type m[4];
+
+   void set_identity()
+   {
+      m[0] = m[3] = static_cast<limb_type>(1u);
+      m[1] = m[2] = static_cast<limb_type>(0u);
+   }
+   //
+   // Applies the Lehmer step l to the rows of the matrix:
+   //
+   void lehmer_update(const lehmer_matrix& l)
+   {
+      gcd_big_type t, w;
+      for(unsigned j = 0; j < 2; ++j)
+      {
+         eval_multiply(t, m[j], l.a);
+         eval_multiply(w, m[2 + j], l.b);
+         gcd_big_type& r0 = m[j];
+         gcd_big_type& r1 = m[2 + j];
+         if(l.odd)
+            eval_subtract(w, t);
+         else
+         {
+            eval_subtract(t, w);
+            w.swap(t);
+         }
+         // w is the new r0, now compute the new r1:
+         eval_multiply(t, r0, l.c);
+         eval_multiply(r0, r1, l.d);
+         if(l.odd)
+            eval_subtract(t, r0);
+         else
+         {
+            eval_subtract(r0, t);
+            t.swap(r0);
+         }
+         r0.swap(w);
+         r1.swap(t);
+      }
+   }
+   //
+   // After a division step with quotient q, (r0, r1) = (r1, r0 - q * r1):
+   //
+   void division_update(const gcd_big_type& q)
+   {
+      gcd_big_type t;
+      for(unsigned j = 0; j < 2; ++j)
+      {
+         eval_multiply(t, q, m[2 + j]);
+         eval_subtract(m[j], t);
+         m[j].swap(m[2 + j]);
+      }
+   }
+   //
+   // *this = s * *this:
+   //
+   void left_multiply(const gcd_matrix& s)
+   {
+      gcd_big_type r[4], t;
+      for(unsigned i = 0; i < 2; ++i)
+      {
+         for(unsigned j = 0; j < 2; ++j)
+         {
+            eval_multiply(r[2 * i + j], s.m[2 * i], m[j]);
+            eval_multiply(t, s.m[2 * i + 1], m[2 + j]);
+            eval_add(r[2 * i + j], t);
+         }
+      }
+      for(unsigned i = 0; i < 4; ++i)
+         m[i].swap(r[i]);
+   }
+};
+
+//
+// (u, v) = (v, u % v), and updates S with the quotient if it's non-null:
+//
+inline void gcd_division_step(gcd_big_type& u, gcd_big_type& v, gcd_matrix* S)
+{
+   gcd_big_type q, r;
+   divide_unsigned_helper(S ? &q : static_cast<gcd_big_type*>(0), u, v, r);
+   u.swap(v);
+   v.swap(r);
+   if(S)
+      S->division_update(q);
+}
+
+//
+// Reduces u >= v >= 0 with steps of the Euclidean algorithm until v has no more than
+// target limbs or is zero.  When S is non-null it's set to the matrix which maps the
+// original values to the new ones.  When S is null and target is zero, then u is left
+// holding the GCD.
+//
+inline void gcd_reduce(gcd_big_type& u, gcd_big_type& v, gcd_matrix* S, unsigned target)
+{
+   gcd_big_type t1, t2;
+   if(S)
+      S->set_identity();
+   while((v.size() > target) && ((v.size() > 1) || v.limbs()[0]))
+   {
+      unsigned k = u.size();
+      if(!S && (k <= 2))
+      {
+         //
+         // Finish off with double width arithmetic:
+         //
+         double_limb_type a = u.limbs()[0], b = v.limbs()[0];
+         if(k > 1)
+            a |= static_cast<double_limb_type>(u.limbs()[1]) << bits_per_limb;
+         if(v.size() > 1)
+            b |= static_cast<double_limb_type>(v.limbs()[1]) << bits_per_limb;
+         while(b)
+         {
+            double_limb_type r = a % b;
+            a = b;
+            b = r;
+         }
+         limb_type g[2] = { static_cast<limb_type>(a), static_cast<limb_type>(a >> bits_per_limb) };
+         copy_product_result(u, g, 2);
+         v = static_cast<limb_type>(0u);
+         return;
+      }
+      if(k - v.size() >= 2)
+      {
+         // The quotient is at least a limb long, so divide:
+         gcd_division_step(u, v, S);
+         continue;
+      }
+      unsigned m = (std::min)(2 * (k - target), (k + 1) / 2);
+      if((k >= hgcd_cutoff) && (m >= hgcd_cutoff / 2))
+      {
+         //
+         // Reduce the leading m limbs of u and v to about half their size, the resulting
+         // matrix has entries of roughly m / 2 limbs, and reduces the full values by the same amount:
+         //
+         unsigned p = k - m;
+         gcd_big_type a, b;
+         copy_product_result(a, u.limbs() + p, m);
+         copy_product_result(b, v.limbs() + p, v.size() - p);
+         gcd_matrix S1;
+         gcd_reduce(a, b, &S1, m / 2 + 1);
+         eval_multiply(a, S1.m[0], u);
+         eval_multiply(t1, S1.m[1], v);
+         eval_add(a, t1);
+         eval_multiply(b, S1.m[2], u);
+         eval_multiply(t1, S1.m[3], v);
+         eval_add(b, t1);
+         //
+         // Correct for the (rare) case that the matrix is not quite right for the full values:
+         //
+         if(a.sign())
+         {
+            a.negate();
+            S1.m[0].negate();
+            S1.m[1].negate();
+         }
+         if(b.sign())
+         {
+            b.negate();
+            S1.m[2].negate();
+            S1.m[3].negate();
+         }
+         if(a.compare(b) < 0)
+         {
+            a.swap(b);
+            S1.m[0].swap(S1.m[2]);
+            S1.m[1].swap(S1.m[3]);
+         }
+         bool progress = (a.compare(u) < 0) || (b.compare(v) < 0);
+         u.swap(a);
+         v.swap(b);
+         if(S)
+            S->left_multiply(S1);
+         if(progress)
+            continue;
+      }
+      lehmer_matrix l;
+      if(lehmer_step_matrix(u.limbs(), u.size(), v.limbs(), v.size(), l))
+      {
+         lehmer_apply(u, v, l, t1, t2);
+         if(S)
+            S->lehmer_update(l);
+      }
+      else
+         gcd_division_step(u, v, S);
+   }
+}
+
+//
+// Sets u to gcd(u, v) for u, v > 0:
+//
+inline void gcd_lehmer(gcd_big_type& u, gcd_big_type& v)
+{
+   if(u.compare(v) < 0)
+      u.swap(v);
+   gcd_reduce(u, v, 0, 0);
+}
+
+//
+// Sets u to g = gcd(u, v) for u, v > 0, and s and t to the cofactors with the smallest
+// absolute values such that s * u + t * v = g:
+//
+inline void gcdext_lehmer(gcd_big_type& u, gcd_big_type& v, gcd_big_type& s, gcd_big_type& t)
+{
+   gcd_big_type a(u), b(v);
+   bool swapped = u.compare(v) < 0;
+   if(swapped)
+      u.swap(v);
+   gcd_matrix S;
+   gcd_reduce(u, v, &S, 0);
+   s.swap(S.m[swapped ? 1 : 0]);
+   //
+   // Bring s into the range (-b/2g, b/2g], then t = (g - s * a) / b:
+   //
+   gcd_big_type m, r;
+   eval_divide(m, b, u);
+   eval_modulus(s, s, m);
+   if(s.sign())
+      eval_add(s, m);
+   eval_add(r, s, s);
+   if(r.compare(m) > 0)
+      eval_subtract(s, m);
+   eval_multiply(t, s, a);
+   eval_subtract(t, u, t);
+   eval_divide(t, t, b);
+}
+
+} // namespace detail
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+}}} // namespaces
+
+#endif
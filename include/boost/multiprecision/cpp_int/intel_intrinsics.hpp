@@ -0,0 +1,212 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Limb at a time kernels for the inner loops of cpp_int_backend addition, subtraction and
+// bitwise operations.
+//
+// On x86 and x64 the add and subtract loops use the _addcarry/_subborrow intrinsics, which
+// compile to a single adc/sbb chain with the carry kept in the flags register, and the bitwise
+// loops use the widest SIMD registers the target has (SSE2, AVX2 or AVX-512F).  Everything is
+// selected at compile time from the compiler's target macros, so building with for example
+// -mavx2 or /arch:AVX2 is all that is required, and there is a portable fallback for every
+// kernel.  Defining BOOST_MP_NO_LIMB_INTRINSICS disables all of this and uses the portable
+// versions throughout.  See performance/limb_performance.cpp for the benchmarks.
+//
+#ifndef BOOST_MP_CPP_INT_INTEL_INTRINSICS_HPP
+#define BOOST_MP_CPP_INT_INTEL_INTRINSICS_HPP
+
+#ifndef BOOST_MP_NO_LIMB_INTRINSICS
+
+#if defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_IX86))
+#  include <intrin.h>
+#  define BOOST_MP_HAS_ADDCARRY
+#  if defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#     define BOOST_MP_HAS_SSE2
+#  endif
+#  ifdef __AVX2__
+#     define BOOST_MP_HAS_AVX2
+#  endif
+#  ifdef __AVX512F__
+#     define BOOST_MP_HAS_AVX512
+#  endif
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  include <x86intrin.h>
+#  define BOOST_MP_HAS_ADDCARRY
+#  ifdef __SSE2__
+#     define BOOST_MP_HAS_SSE2
+#  endif
+#  ifdef __AVX2__
+#     define BOOST_MP_HAS_AVX2
+#  endif
+#  ifdef __AVX512F__
+#     define BOOST_MP_HAS_AVX512
+#  endif
+#endif
+
+//
+// The 64-bit intrinsics only exist on x64, where limbs are 64-bit whenever there is a 128-bit type:
+//
+#if defined(BOOST_MP_HAS_ADDCARRY) && defined(BOOST_HAS_INT128) && !defined(__x86_64__) && !defined(_M_X64)
+#  undef BOOST_MP_HAS_ADDCARRY
+#endif
+
+#endif // BOOST_MP_NO_LIMB_INTRINSICS
+
+namespace boost{ namespace multiprecision{ namespace backends{ namespace detail{
+
+//
+// *p = a + b + carry, returns the carry out:
+//
+inline unsigned char addcarry_limb(unsigned char carry, limb_type a, limb_type b, limb_type* p) BOOST_NOEXCEPT
+{
+#if defined(BOOST_MP_HAS_ADDCARRY) && defined(BOOST_HAS_INT128)
+   unsigned long long r;
+   carry = _addcarry_u64(carry, a, b, &r);
+   *p = r;
+   return carry;
+#elif defined(BOOST_MP_HAS_ADDCARRY)
+   unsigned int r;
+   carry = _addcarry_u32(carry, a, b, &r);
+   *p = r;
+   return carry;
+#else
+   double_limb_type sum = static_cast<double_limb_type>(a) + static_cast<double_limb_type>(b) + carry;
+   *p = static_cast<limb_type>(sum);
+   return static_cast<unsigned char>(sum >> bits_per_limb);
+#endif
+}
+//
+// *p = a - b - borrow, returns the borrow out:
+//
+inline unsigned char subborrow_limb(unsigned char borrow, limb_type a, limb_type b, limb_type* p) BOOST_NOEXCEPT
+{
+#if defined(BOOST_MP_HAS_ADDCARRY) && defined(BOOST_HAS_INT128)
+   unsigned long long r;
+   borrow = _subborrow_u64(borrow, a, b, &r);
+   *p = r;
+   return borrow;
+#elif defined(BOOST_MP_HAS_ADDCARRY)
+   unsigned int r;
+   borrow = _subborrow_u32(borrow, a, b, &r);
+   *p = r;
+   return borrow;
+#else
+   double_limb_type diff = static_cast<double_limb_type>(a) - static_cast<double_limb_type>(b) - borrow;
+   *p = static_cast<limb_type>(diff);
+   return static_cast<unsigned char>((diff >> bits_per_limb) & 1u);
+#endif
+}
+//
+// r = a + b, all of n limbs, returns the carry out.  r may alias a or b:
+//
+inline limb_type add_limbs_n(limb_type* r, const limb_type* a, const limb_type* b, unsigned n) BOOST_NOEXCEPT
+{
+   unsigned char carry = 0;
+   unsigned i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      carry = addcarry_limb(carry, a[i], b[i], r + i);
+      carry = addcarry_limb(carry, a[i + 1], b[i + 1], r + i + 1);
+      carry = addcarry_limb(carry, a[i + 2], b[i + 2], r + i + 2);
+      carry = addcarry_limb(carry, a[i + 3], b[i + 3], r + i + 3);
+   }
+   for(; i < n; ++i)
+      carry = addcarry_limb(carry, a[i], b[i], r + i);
+   return carry;
+}
+//
+// r = a - b, all of n limbs, returns the borrow out.  r may alias a or b:
+//
+inline limb_type subtract_limbs_n(limb_type* r, const limb_type* a, const limb_type* b, unsigned n) BOOST_NOEXCEPT
+{
+   unsigned char borrow = 0;
+   unsigned i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      borrow = subborrow_limb(borrow, a[i], b[i], r + i);
+      borrow = subborrow_limb(borrow, a[i + 1], b[i + 1], r + i + 1);
+      borrow = subborrow_limb(borrow, a[i + 2], b[i + 2], r + i + 2);
+      borrow = subborrow_limb(borrow, a[i + 3], b[i + 3], r + i + 3);
+   }
+   for(; i < n; ++i)
+      borrow = subborrow_limb(borrow, a[i], b[i], r + i);
+   return borrow;
+}
+
+//
+// The widest vector register available, and the operations on it used by the bitwise kernels:
+//
+#if defined(BOOST_MP_HAS_AVX512)
+
+typedef __m512i limb_vector;
+inline limb_vector load_limb_vector(const limb_type* p) BOOST_NOEXCEPT { return _mm512_loadu_si512(p); }
+inline void store_limb_vector(limb_type* p, limb_vector v) BOOST_NOEXCEPT { _mm512_storeu_si512(p, v); }
+inline limb_vector limb_vector_and(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm512_and_si512(a, b); }
+inline limb_vector limb_vector_or(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm512_or_si512(a, b); }
+inline limb_vector limb_vector_xor(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm512_xor_si512(a, b); }
+inline limb_vector limb_vector_ones() BOOST_NOEXCEPT { return _mm512_set1_epi32(-1); }
+#  define BOOST_MP_HAS_LIMB_VECTOR
+
+#elif defined(BOOST_MP_HAS_AVX2)
+
+typedef __m256i limb_vector;
+inline limb_vector load_limb_vector(const limb_type* p) BOOST_NOEXCEPT { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+inline void store_limb_vector(limb_type* p, limb_vector v) BOOST_NOEXCEPT { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+inline limb_vector limb_vector_and(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm256_and_si256(a, b); }
+inline limb_vector limb_vector_or(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm256_or_si256(a, b); }
+inline limb_vector limb_vector_xor(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm256_xor_si256(a, b); }
+inline limb_vector limb_vector_ones() BOOST_NOEXCEPT { return _mm256_set1_epi32(-1); }
+#  define BOOST_MP_HAS_LIMB_VECTOR
+
+#elif defined(BOOST_MP_HAS_SSE2)
+
+typedef __m128i limb_vector;
+inline limb_vector load_limb_vector(const limb_type* p) BOOST_NOEXCEPT { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+inline void store_limb_vector(limb_type* p, limb_vector v) BOOST_NOEXCEPT { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+inline limb_vector limb_vector_and(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm_and_si128(a, b); }
+inline limb_vector limb_vector_or(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm_or_si128(a, b); }
+inline limb_vector limb_vector_xor(limb_vector a, limb_vector b) BOOST_NOEXCEPT { return _mm_xor_si128(a, b); }
+inline limb_vector limb_vector_ones() BOOST_NOEXCEPT { return _mm_set1_epi32(-1); }
+#  define BOOST_MP_HAS_LIMB_VECTOR
+
+#endif
+
+#ifdef BOOST_MP_HAS_LIMB_VECTOR
+static const unsigned limbs_per_vector = sizeof(limb_vector) / sizeof(limb_type);
+#endif
+
+//
+// r[i] = op(r[i], a[i]) for the n limbs of r and a, Op must also accept a pair of limb_vector's
+// when there is one.  a may alias r:
+//
+template <class Op>
+inline void bitwise_limbs(limb_type* r, const limb_type* a, unsigned n, Op op) BOOST_NOEXCEPT
+{
+   unsigned i = 0;
+#ifdef BOOST_MP_HAS_LIMB_VECTOR
+   for(; i + limbs_per_vector <= n; i += limbs_per_vector)
+      store_limb_vector(r + i, op(load_limb_vector(r + i), load_limb_vector(a + i)));
+#endif
+   for(; i < n; ++i)
+      r[i] = op(r[i], a[i]);
+}
+//
+// r[i] = ~a[i] for n limbs, a may alias r:
+//
+inline void complement_limbs(limb_type* r, const limb_type* a, unsigned n) BOOST_NOEXCEPT
+{
+   unsigned i = 0;
+#ifdef BOOST_MP_HAS_LIMB_VECTOR
+   const limb_vector ones = limb_vector_ones();
+   for(; i + limbs_per_vector <= n; i += limbs_per_vector)
+      store_limb_vector(r + i, limb_vector_xor(load_limb_vector(a + i), ones));
+#endif
+   for(; i < n; ++i)
+      r[i] = ~a[i];
+}
+
+}}}} // namespaces
+
+#endif
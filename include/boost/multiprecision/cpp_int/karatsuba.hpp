@@ -0,0 +1,882 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Subquadratic (Karatsuba, Toom-3 and NTT) multiplication routines for cpp_int_backend.
+//
+// All of the routines in this file operate on raw arrays of limbs, the caller
+// allocates a single block of scratch storage up front (see multiply_karatsuba_storage)
+// which is then carved up as we recurse, so there is no memory allocation below
+// the top level call.  The exception is the NTT code (see detail/ntt.hpp) used for
+// very large values, which manages its own memory.
+//
+#ifndef BOOST_MP_CPP_INT_KARATSUBA_HPP
+#define BOOST_MP_CPP_INT_KARATSUBA_HPP
+
+//
+// Operand sizes (in limbs) at which we switch from schoolbook to Karatsuba multiplication,
+// and from Karatsuba to Toom-3.  Both operands must be at least this large for the switch
+// to happen.  Defining BOOST_MP_KARATSUBA_CUTOFF to a very large value disables the
+// subquadratic code altogether.  See performance/karatsuba_performance.cpp for the
+// benchmarks used to choose these values.
+//
+#ifndef BOOST_MP_KARATSUBA_CUTOFF
+#  define BOOST_MP_KARATSUBA_CUTOFF 40
+#endif
+#ifndef BOOST_MP_TOOM3_CUTOFF
+#  define BOOST_MP_TOOM3_CUTOFF 180
+#endif
+//
+// Operand size (in limbs) at which we switch to multiplication via a number theoretic
+// transform, again both operands must be at least this large:
+//
+#ifndef BOOST_MP_NTT_CUTOFF
+#  define BOOST_MP_NTT_CUTOFF 10000
+#endif
+//
+// Operand size (in limbs) at which short products, which compute only the high half of a product,
+// switch from truncated schoolbook multiplication to Mulders' method, which uses the full
+// (Karatsuba or Toom-3) product of the high parts of the operands:
+//
+#ifndef BOOST_MP_MULDERS_CUTOFF
+#  define BOOST_MP_MULDERS_CUTOFF 100
+#endif
+
+#include <boost/multiprecision/detail/ntt.hpp>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127) // conditional expression is constant
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_KARATSUBA_CUTOFF >= 18, "The Karatsuba cutoff must be at least 18 limbs.");
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_TOOM3_CUTOFF >= BOOST_MP_KARATSUBA_CUTOFF, "The Toom-3 cutoff may not be lower than the Karatsuba cutoff.");
+
+static const unsigned karatsuba_cutoff = BOOST_MP_KARATSUBA_CUTOFF;
+static const unsigned toom3_cutoff = BOOST_MP_TOOM3_CUTOFF;
+static const unsigned ntt_cutoff = BOOST_MP_NTT_CUTOFF;
+static const unsigned mulders_cutoff = BOOST_MP_MULDERS_CUTOFF;
+
+namespace detail{
+
+//
+// Basic building blocks, all lengths are in limbs:
+//
+// r = a + b, where a has an limbs, b has bn <= an limbs and r has room for an limbs.
+// r may alias a.  Returns the carry out:
+//
+inline limb_type add_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(an >= bn);
+   double_limb_type carry = add_limbs_n(r, a, b, bn);
+   unsigned i = bn;
+   for(; carry && (i < an); ++i)
+   {
+      carry += static_cast<double_limb_type>(a[i]);
+      r[i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   if(r != a)
+   {
+      for(; i < an; ++i)
+         r[i] = a[i];
+   }
+   return static_cast<limb_type>(carry);
+}
+//
+// r = a - b, where a has an limbs, b has bn <= an limbs and r has room for an limbs.
+// r may alias a.  Returns the borrow out:
+//
+inline limb_type subtract_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(an >= bn);
+   double_limb_type borrow = subtract_limbs_n(r, a, b, bn);
+   unsigned i = bn;
+   for(; borrow && (i < an); ++i)
+   {
+      borrow = static_cast<double_limb_type>(a[i]) - borrow;
+      r[i] = static_cast<limb_type>(borrow);
+      borrow = (borrow >> bits_per_limb) & 1u;
+   }
+   if(r != a)
+   {
+      for(; i < an; ++i)
+         r[i] = a[i];
+   }
+   return static_cast<limb_type>(borrow);
+}
+//
+// r = b - a, where a has an limbs, b has bn <= an limbs, and b >= a.  r may alias a:
+//
+inline void reverse_subtract_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(an >= bn);
+   double_limb_type borrow = subtract_limbs_n(r, b, a, bn);
+   for(unsigned i = bn; i < an; ++i)
+   {
+      borrow = static_cast<double_limb_type>(0) - static_cast<double_limb_type>(a[i]) - borrow;
+      r[i] = static_cast<limb_type>(borrow);
+      borrow = (borrow >> bits_per_limb) & 1u;
+   }
+   BOOST_ASSERT(borrow == 0);
+}
+//
+// Compare a (an limbs) with b (bn limbs), either may have leading zeros:
+//
+inline int compare_limbs(const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+{
+   while(an > bn)
+   {
+      if(a[--an])
+         return 1;
+   }
+   while(bn > an)
+   {
+      if(b[--bn])
+         return -1;
+   }
+   while(an)
+   {
+      --an;
+      if(a[an] != b[an])
+         return a[an] > b[an] ? 1 : -1;
+   }
+   return 0;
+}
+//
+// Adds the an limbs in a to the rn limbs in r, propagating the carry as far as
+// the end of r.  Used to accumulate partial products into the final result: any
+// limbs in a beyond the end of r must be zero, as must the final carry.
+//
+inline void add_limbs_into(limb_type* r, unsigned rn, const limb_type* a, unsigned an) BOOST_NOEXCEPT
+{
+   if(an > rn)
+   {
+#ifdef BOOST_MP_DEBUG
+      for(unsigned i = rn; i < an; ++i)
+         BOOST_ASSERT(a[i] == 0);
+#endif
+      an = rn;
+   }
+   limb_type carry = add_limbs(r, r, rn, a, an);
+   BOOST_ASSERT(carry == 0);
+   (void)carry;
+}
+//
+// x = ±x ± y, where x has n limbs and y has yn <= n limbs, the sign of x is
+// held in xneg.  The result must fit in n limbs:
+//
+inline void signed_add_limbs(limb_type* x, bool& xneg, unsigned n, const limb_type* y, unsigned yn, bool yneg) BOOST_NOEXCEPT
+{
+   if(xneg == yneg)
+   {
+      limb_type carry = add_limbs(x, x, n, y, yn);
+      BOOST_ASSERT(carry == 0);
+      (void)carry;
+   }
+   else if(compare_limbs(x, n, y, yn) >= 0)
+   {
+      subtract_limbs(x, x, n, y, yn);
+   }
+   else
+   {
+      reverse_subtract_limbs(x, x, n, y, yn);
+      xneg = yneg;
+   }
+}
+//
+// r = |a - b| where a has an limbs, b has bn limbs, r has room for max(an, bn)
+// limbs, and the return value is true if a < b:
+//
+inline bool abs_difference_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+{
+   if(compare_limbs(a, an, b, bn) >= 0)
+   {
+      if(an >= bn)
+         subtract_limbs(r, a, an, b, bn);
+      else
+      {
+         // b has leading zeros:
+         subtract_limbs(r, a, an, b, an);
+         for(unsigned i = an; i < bn; ++i)
+            r[i] = 0;
+      }
+      return false;
+   }
+   if(bn >= an)
+      subtract_limbs(r, b, bn, a, an);
+   else
+   {
+      subtract_limbs(r, b, bn, a, bn);
+      for(unsigned i = bn; i < an; ++i)
+         r[i] = 0;
+   }
+   return true;
+}
+//
+// In place shifts by one bit, used by the Toom-3 evaluation and interpolation steps:
+//
+inline limb_type left_shift_limbs_1(limb_type* r, unsigned n) BOOST_NOEXCEPT
+{
+   limb_type carry = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      limb_type v = r[i];
+      r[i] = (v << 1) | carry;
+      carry = v >> (bits_per_limb - 1);
+   }
+   return carry;
+}
+inline void right_shift_limbs_1(limb_type* r, unsigned n) BOOST_NOEXCEPT
+{
+   for(unsigned i = 0; i + 1 < n; ++i)
+      r[i] = (r[i] >> 1) | (r[i + 1] << (bits_per_limb - 1));
+   if(n)
+      r[n - 1] >>= 1;
+}
+//
+// Exact division by 3, this uses multiplication by the modular inverse of 3
+// rather than an actual division, see "Exact Division by Small Integers"
+// in Modern Computer Arithmetic (Brent and Zimmermann):
+//
+inline void divide_exact_by_3_limbs(limb_type* r, unsigned n) BOOST_NOEXCEPT
+{
+   static const limb_type third = ~static_cast<limb_type>(0u) / 3;  // 0x5555...
+   static const limb_type inverse = 2 * third + 1;                   // 0xAAAA...B, the inverse of 3 mod 2^bits_per_limb
+   static const limb_type bound1 = third + 1;                        // 3q overflows a limb when q >= bound1
+   static const limb_type bound2 = 2 * third + 1;                    // 3q overflows by 2 when q >= bound2
+   limb_type borrow = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      limb_type s = r[i];
+      limb_type t = s - borrow;
+      limb_type q = t * inverse;
+      r[i] = q;
+      borrow = static_cast<limb_type>(s < borrow) + static_cast<limb_type>(q >= bound1) + static_cast<limb_type>(q >= bound2);
+   }
+   BOOST_ASSERT(borrow == 0);
+}
+//
+// r = a * b, where a has n limbs, returns the limb carried out.  r may alias a:
+//
+inline limb_type mul_limbs_1(limb_type* r, const limb_type* a, unsigned n, limb_type b) BOOST_NOEXCEPT
+{
+   double_limb_type carry = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      carry += static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(b);
+      r[i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   return static_cast<limb_type>(carry);
+}
+//
+// r += a * b, where a and r have n limbs, returns the limb carried out.  r must not overlap a.
+//
+// Each step is a single double width multiply and accumulate, a[i] * b + r[i] + carry, which
+// can not overflow.  Unrolling by four lets the multiplies, which do not depend on the carry,
+// be issued ahead of the additions, so that only the add with carry remains on the critical path:
+//
+inline limb_type mul_add_limbs_1(limb_type* r, const limb_type* a, unsigned n, limb_type b) BOOST_NOEXCEPT
+{
+   limb_type carry = 0;
+   unsigned i = 0;
+   for(; i + 4 <= n; i += 4)
+   {
+      double_limb_type t0 = static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(b) + r[i] + carry;
+      r[i] = static_cast<limb_type>(t0);
+      double_limb_type t1 = static_cast<double_limb_type>(a[i + 1]) * static_cast<double_limb_type>(b) + r[i + 1] + static_cast<limb_type>(t0 >> bits_per_limb);
+      r[i + 1] = static_cast<limb_type>(t1);
+      double_limb_type t2 = static_cast<double_limb_type>(a[i + 2]) * static_cast<double_limb_type>(b) + r[i + 2] + static_cast<limb_type>(t1 >> bits_per_limb);
+      r[i + 2] = static_cast<limb_type>(t2);
+      double_limb_type t3 = static_cast<double_limb_type>(a[i + 3]) * static_cast<double_limb_type>(b) + r[i + 3] + static_cast<limb_type>(t2 >> bits_per_limb);
+      r[i + 3] = static_cast<limb_type>(t3);
+      carry = static_cast<limb_type>(t3 >> bits_per_limb);
+   }
+   for(; i < n; ++i)
+   {
+      double_limb_type t = static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(b) + r[i] + carry;
+      r[i] = static_cast<limb_type>(t);
+      carry = static_cast<limb_type>(t >> bits_per_limb);
+   }
+   return carry;
+}
+//
+// r -= a * b, where a and r have n limbs, returns the limb borrowed out.  r must not overlap a.
+// a[i] * b + borrow can not overflow, and the borrow out of each step is at most one more
+// than the high limb of that product:
+//
+inline limb_type mul_subtract_limbs_1(limb_type* r, const limb_type* a, unsigned n, limb_type b) BOOST_NOEXCEPT
+{
+   limb_type borrow = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      double_limb_type t = static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(b) + borrow;
+      limb_type l = static_cast<limb_type>(t);
+      limb_type v = r[i];
+      r[i] = v - l;
+      borrow = static_cast<limb_type>(t >> bits_per_limb) + static_cast<limb_type>(v < l);
+   }
+   return borrow;
+}
+//
+// Schoolbook squaring, r must have room for 2n limbs and must not overlap a.
+// Each cross product a[i]*a[j] (i < j) is computed once and the sum doubled,
+// before the squares on the diagonal are added in:
+//
+inline void square_schoolbook_limbs(limb_type* r, const limb_type* a, unsigned n) BOOST_NOEXCEPT
+{
+   std::memset(r, 0, 2 * n * sizeof(limb_type));
+   for(unsigned i = 0; i + 1 < n; ++i)
+      r[i + n] = mul_add_limbs_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+   limb_type top = left_shift_limbs_1(r, 2 * n);
+   BOOST_ASSERT(top == 0);
+   (void)top;
+   double_limb_type carry = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      double_limb_type sq = static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(a[i]);
+      carry += static_cast<double_limb_type>(r[2 * i]) + static_cast<limb_type>(sq);
+      r[2 * i] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+      carry += static_cast<double_limb_type>(r[2 * i + 1]) + static_cast<limb_type>(sq >> bits_per_limb);
+      r[2 * i + 1] = static_cast<limb_type>(carry);
+      carry >>= bits_per_limb;
+   }
+   BOOST_ASSERT(carry == 0);
+}
+//
+// Schoolbook multiplication, r must have room for an + bn limbs and must
+// not overlap either a or b.  When a and b are the same value we square instead:
+//
+inline void multiply_schoolbook_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+{
+   if((a == b) && (an == bn))
+   {
+      square_schoolbook_limbs(r, a, an);
+      return;
+   }
+   std::memset(r, 0, (an + bn) * sizeof(limb_type));
+   for(unsigned i = 0; i < an; ++i)
+      r[i + bn] = mul_add_limbs_1(r + i, b, bn, a[i]);
+}
+//
+// Short product: the sum of a[i] * b[j] over the columns i + j >= c only, where a and b both
+// have n > c limbs.  This falls short of the full product by less than (c + 1) * B^(c + 1),
+// where B is the limb base, so the limbs above c + 2 are correct, or at worst a borrow
+// away from correct.  Leaving out the low columns saves about c^2 / 2 of the n^2 limb
+// multiplications, close to half of them when c is close to n.
+//
+// r must have room for 2n - 1 limbs, the most significant limb of the result (which is
+// zero if the result fits in 2n - 1 limbs) is returned rather than stored:
+//
+inline limb_type multiply_high_schoolbook_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, unsigned c) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(c < n);
+   std::memset(r, 0, (2 * n - 1) * sizeof(limb_type));
+   limb_type carry = 0;
+   for(unsigned i = 0; i < n; ++i)
+   {
+      unsigned j = i < c ? c - i : 0;
+      carry = mul_add_limbs_1(r + i + j, b + j, n - j, a[i]);
+      if(i + 1 < n)
+         r[i + n] = carry;
+   }
+   return carry;
+}
+
+//
+// Scratch space requirements for the routines below, these must mirror exactly the
+// way in which the scratch space is carved up by the multiplication routines:
+//
+inline unsigned multiply_balanced_storage(unsigned n) BOOST_NOEXCEPT
+{
+   if(n < karatsuba_cutoff)
+      return 0;
+   if(n < toom3_cutoff)
+   {
+      unsigned k = n - n / 2;
+      return 4 * k + 1 + (std::max)(multiply_balanced_storage(n / 2), multiply_balanced_storage(k));
+   }
+   unsigned k = (n + 2) / 3;
+   unsigned l = n - 2 * k;
+   return 8 * k + 8 + (std::max)((std::max)(multiply_balanced_storage(k), multiply_balanced_storage(l)), multiply_balanced_storage(k + 1));
+}
+
+inline unsigned multiply_karatsuba_storage(unsigned an, unsigned bn) BOOST_NOEXCEPT
+{
+   // an >= bn:
+   if(bn < karatsuba_cutoff)
+      return 0;
+   if(an == bn)
+      return multiply_balanced_storage(an);
+   unsigned tail = an % bn;
+   unsigned result = 2 * bn + multiply_balanced_storage(bn);
+   if(tail)
+      result = (std::max)(result, bn + tail + (tail > bn ? multiply_karatsuba_storage(tail, bn) : multiply_karatsuba_storage(bn, tail)));
+   return result;
+}
+
+inline void multiply_balanced_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, limb_type* scratch) BOOST_NOEXCEPT;
+inline void multiply_unbalanced_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, limb_type* scratch) BOOST_NOEXCEPT;
+
+//
+// Karatsuba multiplication of two n limb values, r has room for 2n limbs.
+// We use the "subtractive" form which avoids any carry out of the middle term:
+//
+// a = a1*x + a0, b = b1*x + b0,
+// a*b = a1*b1*x^2 + (a1*b1 + a0*b0 - (a0 - a1)*(b0 - b1))*x + a0*b0
+//
+// When a and b are the same array all three sub-products are squares, and we
+// pass that on by calling ourselves recursively with identical pointers.
+//
+inline void multiply_karatsuba_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, limb_type* scratch) BOOST_NOEXCEPT
+{
+   unsigned h = n / 2;   // size of the low halves
+   unsigned k = n - h;   // size of the high halves, k >= h
+   //
+   // Scratch layout: [t: 2k][work: 2k + 1][recursive scratch...]
+   //
+   limb_type* t = scratch;
+   limb_type* work = scratch + 2 * k;
+   limb_type* next = work + 2 * k + 1;
+   //
+   // Low and high products go directly into the result:
+   //
+   multiply_balanced_limbs(r, a, b, h, scratch);
+   multiply_balanced_limbs(r + 2 * h, a + h, b + h, k, scratch);
+   //
+   // Middle product of the differences:
+   //
+   bool sa = abs_difference_limbs(work, a, h, a + h, k);
+   bool sb = sa;
+   if(a == b)
+      multiply_balanced_limbs(t, work, work, k, next);
+   else
+   {
+      sb = abs_difference_limbs(work + k, b, h, b + h, k);
+      multiply_balanced_limbs(t, work, work + k, k, next);
+   }
+   //
+   // work = a0*b0 + a1*b1 -/+ t:
+   //
+   std::memcpy(work, r + 2 * h, 2 * k * sizeof(limb_type));
+   work[2 * k] = 0;
+   add_limbs(work, work, 2 * k + 1, r, 2 * h);
+   if(sa == sb)
+      subtract_limbs(work, work, 2 * k + 1, t, 2 * k);
+   else
+      add_limbs(work, work, 2 * k + 1, t, 2 * k);
+   //
+   // And accumulate into the result:
+   //
+   add_limbs_into(r + h, 2 * n - h, work, 2 * k + 1);
+}
+
+//
+// Toom-3 multiplication of two n limb values, r has room for 2n limbs.
+// Evaluation is at the points 0, 1, -1, -2, infinity, and interpolation follows
+// the sequence given in Bodrato and Zanoni, "Integer and Polynomial Multiplication:
+// Towards Optimal Toom-Cook Matrices".
+//
+inline void multiply_toom3_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, limb_type* scratch) BOOST_NOEXCEPT
+{
+   unsigned k = (n + 2) / 3;    // size of the low and middle pieces
+   unsigned l = n - 2 * k;      // size of the high piece, 0 < l <= k
+   unsigned m = 2 * k + 2;      // size of the products of the evaluated values
+   BOOST_ASSERT(l && (l <= k));
+
+   const limb_type* a0 = a;
+   const limb_type* a1 = a + k;
+   const limb_type* a2 = a + 2 * k;
+   const limb_type* b0 = b;
+   const limb_type* b1 = b + k;
+   const limb_type* b2 = b + 2 * k;
+   //
+   // Scratch layout: [pa: k+1][pb: k+1][r1: m][rm1: m][rm2: m][recursive scratch...]
+   //
+   limb_type* pa = scratch;
+   limb_type* pb = pa + k + 1;
+   limb_type* r1 = pb + k + 1;
+   limb_type* rm1 = r1 + m;
+   limb_type* rm2 = rm1 + m;
+   limb_type* next = rm2 + m;
+   //
+   // When squaring, the evaluations of b are the same as those of a, so we skip
+   // them and pass identical pointers on to the recursive calls:
+   //
+   const bool square = (a == b);
+   if(square)
+      pb = pa;
+   //
+   // pa = a0 + a2, pb = b0 + b2:
+   //
+   pa[k] = add_limbs(pa, a0, k, a2, l);
+   if(!square)
+      pb[k] = add_limbs(pb, b0, k, b2, l);
+   //
+   // r1 = (a0 + a1 + a2) * (b0 + b1 + b2), the evaluated values are placed
+   // in rm2 temporarily as that is not yet in use:
+   //
+   limb_type* p1 = rm2;
+   limb_type* q1 = square ? p1 : rm2 + k + 1;
+   add_limbs(p1, pa, k + 1, a1, k);
+   if(!square)
+      add_limbs(q1, pb, k + 1, b1, k);
+   multiply_balanced_limbs(r1, p1, q1, k + 1, next);
+   //
+   // rm1 = (a0 - a1 + a2) * (b0 - b1 + b2):
+   //
+   bool sa = false;
+   bool sb = false;
+   signed_add_limbs(pa, sa, k + 1, a1, k, true);
+   if(!square)
+      signed_add_limbs(pb, sb, k + 1, b1, k, true);
+   multiply_balanced_limbs(rm1, pa, pb, k + 1, next);
+   bool sm1 = square ? false : sa != sb;
+   //
+   // rm2 = (a0 - 2a1 + 4a2) * (b0 - 2b1 + 4b2), computed as ((pa + a2) * 2 - a0):
+   //
+   signed_add_limbs(pa, sa, k + 1, a2, l, false);
+   left_shift_limbs_1(pa, k + 1);
+   signed_add_limbs(pa, sa, k + 1, a0, k, true);
+   if(!square)
+   {
+      signed_add_limbs(pb, sb, k + 1, b2, l, false);
+      left_shift_limbs_1(pb, k + 1);
+      signed_add_limbs(pb, sb, k + 1, b0, k, true);
+   }
+   multiply_balanced_limbs(rm2, pa, pb, k + 1, next);
+   bool sm2 = square ? false : sa != sb;
+   //
+   // r0 and rinf go directly into the result:
+   //
+   multiply_balanced_limbs(r, a0, b0, k, next);
+   std::memset(r + 2 * k, 0, 2 * k * sizeof(limb_type));
+   multiply_balanced_limbs(r + 4 * k, a2, b2, l, next);
+   const limb_type* r0 = r;
+   const limb_type* rinf = r + 4 * k;
+   //
+   // Interpolation, at the end r1, rm1 and rm2 hold the coefficients of x, x^2 and x^3:
+   //
+   // rm2 = (rm2 - r1) / 3
+   bool s1 = false;
+   signed_add_limbs(rm2, sm2, m, r1, m, true);
+   divide_exact_by_3_limbs(rm2, m);
+   // r1 = (r1 - rm1) / 2
+   signed_add_limbs(r1, s1, m, rm1, m, !sm1);
+   right_shift_limbs_1(r1, m);
+   // rm1 = rm1 - r0
+   signed_add_limbs(rm1, sm1, m, r0, 2 * k, true);
+   // rm2 = (rm1 - rm2) / 2 + 2 * rinf
+   sm2 = !sm2;
+   signed_add_limbs(rm2, sm2, m, rm1, m, sm1);
+   right_shift_limbs_1(rm2, m);
+   signed_add_limbs(rm2, sm2, m, rinf, 2 * l, false);
+   signed_add_limbs(rm2, sm2, m, rinf, 2 * l, false);
+   // rm1 = rm1 + r1 - rinf
+   signed_add_limbs(rm1, sm1, m, r1, m, s1);
+   signed_add_limbs(rm1, sm1, m, rinf, 2 * l, true);
+   // r1 = r1 - rm2
+   signed_add_limbs(r1, s1, m, rm2, m, !sm2);
+   BOOST_ASSERT(!s1 || (compare_limbs(r1, m, r1, 0) == 0));
+   BOOST_ASSERT(!sm1 || (compare_limbs(rm1, m, rm1, 0) == 0));
+   BOOST_ASSERT(!sm2 || (compare_limbs(rm2, m, rm2, 0) == 0));
+   //
+   // Recomposition:
+   //
+   add_limbs_into(r + k, 2 * n - k, r1, m);
+   add_limbs_into(r + 2 * k, 2 * n - 2 * k, rm1, m);
+   add_limbs_into(r + 3 * k, 2 * n - 3 * k, rm2, m);
+}
+
+inline void multiply_balanced_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, limb_type* scratch) BOOST_NOEXCEPT
+{
+   if(n < karatsuba_cutoff)
+      multiply_schoolbook_limbs(r, a, n, b, n);
+   else if(n < toom3_cutoff)
+      multiply_karatsuba_limbs(r, a, b, n, scratch);
+   else
+      multiply_toom3_limbs(r, a, b, n, scratch);
+}
+//
+// Multiplication of an an limb value by a bn limb value, where an >= bn.  We split
+// a into bn sized chunks and multiply each by b using the balanced routines:
+//
+inline void multiply_unbalanced_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, limb_type* scratch) BOOST_NOEXCEPT
+{
+   BOOST_ASSERT(an >= bn);
+   if(bn < karatsuba_cutoff)
+   {
+      multiply_schoolbook_limbs(r, a, an, b, bn);
+      return;
+   }
+   if(an == bn)
+   {
+      multiply_balanced_limbs(r, a, b, bn, scratch);
+      return;
+   }
+   //
+   // Scratch layout: [t: 2 * bn][recursive scratch...]
+   //
+   limb_type* t = scratch;
+   limb_type* next = scratch + 2 * bn;
+   unsigned offset = bn;
+   multiply_balanced_limbs(r, a, b, bn, next);
+   std::memset(r + 2 * bn, 0, (an - bn) * sizeof(limb_type));
+   while(offset + bn <= an)
+   {
+      multiply_balanced_limbs(t, a + offset, b, bn, next);
+      add_limbs_into(r + offset, an + bn - offset, t, 2 * bn);
+      offset += bn;
+   }
+   if(offset < an)
+   {
+      unsigned tail = an - offset;
+      if(tail >= bn)
+         multiply_unbalanced_limbs(t, a + offset, tail, b, bn, t + tail + bn);
+      else
+         multiply_unbalanced_limbs(t, b, bn, a + offset, tail, t + tail + bn);
+      add_limbs_into(r + offset, an + bn - offset, t, tail + bn);
+   }
+}
+
+//
+// Mulders' short product of two n limb values: every a[i] * b[j] with i + j >= n - 1 is included
+// in r (which has room for 2n limbs), and some of the terms below that column may be as well, so
+// the result falls short of the full product by less than n * B^n, just as for
+// multiply_high_schoolbook_limbs with c = n - 1.  With a = a1*x^l + a0 and b = b1*x^l + b0,
+// where a0 and b0 have l limbs and the high parts a1 and b1 have k = n - l >= l limbs, the full
+// product a1*b1 is computed by the balanced routines, and the cross terms are the short products
+// of the top l limbs of a1 by b0, and of a0 by the top l limbs of b1.  Everything left out
+// lies in column n - 2 or below.  Mulders' analysis gives k ~ 0.7n as the best split when the
+// full product uses Karatsuba multiplication.
+//
+inline unsigned mulders_high_storage(unsigned n) BOOST_NOEXCEPT
+{
+   if(n < mulders_cutoff)
+      return 0;
+   unsigned k = (7 * n + 9) / 10;
+   unsigned l = n - k;
+   return (std::max)(multiply_balanced_storage(k), 2 * l + mulders_high_storage(l));
+}
+
+inline void mulders_high_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, limb_type* scratch) BOOST_NOEXCEPT
+{
+   if(n < mulders_cutoff)
+   {
+      r[2 * n - 1] = multiply_high_schoolbook_limbs(r, a, b, n, n - 1);
+      return;
+   }
+   unsigned k = (7 * n + 9) / 10;
+   unsigned l = n - k;
+   //
+   // Scratch layout: [t: 2l][recursive scratch...], the full product uses all of it:
+   //
+   limb_type* t = scratch;
+   limb_type* next = scratch + 2 * l;
+   multiply_balanced_limbs(r + 2 * l, a + l, b + l, k, scratch);
+   std::memset(r, 0, 2 * l * sizeof(limb_type));
+   mulders_high_limbs(t, a + k, b, l, next);
+   add_limbs_into(r + k, 2 * n - k, t, 2 * l);
+   mulders_high_limbs(t, a, b + k, l, next);
+   add_limbs_into(r + k, 2 * n - k, t, 2 * l);
+}
+//
+// Top level entry point for short products, with the same contract as
+// multiply_high_schoolbook_limbs except that the error bound is the looser (2n - 1 - c) * B^(c + 1).
+// Mulders' method only gives us the terms from column n - 1 up, so for lower c the operands
+// are padded with n - 1 - c zero limbs at the bottom:
+//
+inline unsigned multiply_short_storage(unsigned n, unsigned c) BOOST_NOEXCEPT
+{
+   if(n < mulders_cutoff)
+      return 0;
+   unsigned m = 2 * n - 1 - c;
+   return 4 * m + mulders_high_storage(m);
+}
+
+inline limb_type multiply_short_limbs(limb_type* r, const limb_type* a, const limb_type* b, unsigned n, unsigned c, limb_type* scratch) BOOST_NOEXCEPT
+{
+   if(n < mulders_cutoff)
+      return multiply_high_schoolbook_limbs(r, a, b, n, c);
+   unsigned d = n - 1 - c;
+   unsigned m = n + d;
+   //
+   // Scratch layout: [pa: m][pb: m][pr: 2m][recursive scratch...]
+   //
+   limb_type* pa = scratch;
+   limb_type* pb = pa + m;
+   limb_type* pr = pb + m;
+   std::memset(pa, 0, d * sizeof(limb_type));
+   std::memcpy(pa + d, a, n * sizeof(limb_type));
+   std::memset(pb, 0, d * sizeof(limb_type));
+   std::memcpy(pb + d, b, n * sizeof(limb_type));
+   mulders_high_limbs(pr, pa, pb, m, pr + 2 * m);
+   std::memcpy(r, pr + 2 * d, (2 * n - 1) * sizeof(limb_type));
+   return pr[2 * m - 1];
+}
+
+//
+// NTT multiplication: the limbs are split into 32-bit digits which is the largest size
+// for which the three prime transform is exact:
+//
+static const unsigned ntt_digits_per_limb = bits_per_limb / 32;
+
+inline bool use_ntt_multiply(unsigned an, unsigned bn) BOOST_NOEXCEPT
+{
+   return ((std::min)(an, bn) >= ntt_cutoff) && (static_cast<std::size_t>(an + bn) * ntt_digits_per_limb <= boost::multiprecision::detail::ntt_max_length);
+}
+
+inline void limbs_to_ntt_digits(std::vector<boost::uint32_t>& d, const limb_type* a, unsigned an)
+{
+   d.resize(an * ntt_digits_per_limb);
+   for(unsigned i = 0; i < an; ++i)
+   {
+      for(unsigned j = 0; j < ntt_digits_per_limb; ++j)
+         d[i * ntt_digits_per_limb + j] = static_cast<boost::uint32_t>(a[i] >> (32 * j));
+   }
+}
+
+inline void multiply_ntt_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn)
+{
+   std::vector<boost::uint32_t> da, db, dr((an + bn) * ntt_digits_per_limb);
+   limbs_to_ntt_digits(da, a, an);
+   if((a == b) && (an == bn))
+      boost::multiprecision::detail::ntt_multiply<0x100000000uLL>(&dr[0], &da[0], da.size(), &da[0], da.size());
+   else
+   {
+      limbs_to_ntt_digits(db, b, bn);
+      boost::multiprecision::detail::ntt_multiply<0x100000000uLL>(&dr[0], &da[0], da.size(), &db[0], db.size());
+   }
+   for(unsigned i = 0; i < an + bn; ++i)
+   {
+      limb_type l = 0;
+      for(unsigned j = 0; j < ntt_digits_per_limb; ++j)
+         l |= static_cast<limb_type>(dr[i * ntt_digits_per_limb + j]) << (32 * j);
+      r[i] = l;
+   }
+}
+
+//
+// Top level entry point: multiply a by b placing the an + bn limb result in r,
+// using the storage provided:
+//
+inline void multiply_subquadratic_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, limb_type* scratch)
+{
+   if(use_ntt_multiply(an, bn))
+      multiply_ntt_limbs(r, a, an, b, bn);
+   else if(an >= bn)
+      multiply_unbalanced_limbs(r, a, an, b, bn, scratch);
+   else
+      multiply_unbalanced_limbs(r, b, bn, a, an, scratch);
+}
+
+//
+// Multiplication of a by b into r (an + bn limbs) choosing the best method for the
+// operand sizes, plus the scratch space that requires:
+//
+inline unsigned multiply_limbs_storage(unsigned an, unsigned bn) BOOST_NOEXCEPT
+{
+   if(an < bn)
+      std::swap(an, bn);
+   if((bn < karatsuba_cutoff) || use_ntt_multiply(an, bn))
+      return 0;
+   return multiply_karatsuba_storage(an, bn);
+}
+
+inline void multiply_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, limb_type* scratch)
+{
+   if((an >= karatsuba_cutoff) && (bn >= karatsuba_cutoff))
+      multiply_subquadratic_limbs(r, a, an, b, bn, scratch);
+   else
+      multiply_schoolbook_limbs(r, a, an, b, bn);
+}
+
+//
+// RAII wrapper around the block of memory used by a single top level multiplication:
+//
+template <class Allocator>
+class scoped_limb_storage : private Allocator
+{
+   limb_type* m_data;
+   std::size_t m_size;
+   scoped_limb_storage(const scoped_limb_storage&);
+   scoped_limb_storage& operator=(const scoped_limb_storage&);
+public:
+   scoped_limb_storage(const Allocator& a, std::size_t n) : Allocator(a), m_data(0), m_size(n)
+   {
+      m_data = Allocator::allocate(n);
+   }
+   ~scoped_limb_storage()
+   {
+      Allocator::deallocate(m_data, m_size);
+   }
+   limb_type* data()const BOOST_NOEXCEPT { return m_data; }
+};
+
+} // namespace detail
+
+//
+// Copies the product in p (of pn limbs) into result, truncating and checking for overflow as required:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline void copy_product_result(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result, const limb_type* p, unsigned pn)
+{
+   while((pn > 1) && !p[pn - 1])
+      --pn;
+   result.resize(pn, pn); // May throw if checking is enabled and the result doesn't fit
+   std::memcpy(result.limbs(), p, (std::min)(pn, result.size()) * sizeof(limb_type));
+   result.normalize();
+}
+
+//
+// Variable precision types allocate their scratch space from the result's allocator:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline void multiply_subquadratic(
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+   const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, const mpl::false_&)
+{
+   unsigned storage_size = as + bs + (detail::use_ntt_multiply(as, bs) ? 0 : detail::multiply_karatsuba_storage((std::max)(as, bs), (std::min)(as, bs)));
+   detail::scoped_limb_storage<typename cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>::allocator_type> storage(result.allocator(), storage_size);
+   detail::multiply_subquadratic_limbs(storage.data(), pa, as, pb, bs, storage.data() + as + bs);
+   copy_product_result(result, storage.data(), as + bs);
+}
+//
+// Fixed precision types have no allocator, so use stack storage whose size is fixed at
+// compile time for all but the largest types, and std::allocator for the others:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline void multiply_subquadratic(
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+   const limb_type* pa, unsigned as, const limb_type* pb, unsigned bs, const mpl::true_&)
+{
+   typedef cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> backend_type;
+   static const unsigned limb_count = backend_type::internal_limb_count;
+   static const unsigned stack_size = 10 * limb_count + 64 > 4096 ? 4096 : 10 * limb_count + 64;
+   unsigned storage_size = as + bs + (detail::use_ntt_multiply(as, bs) ? 0 : detail::multiply_karatsuba_storage((std::max)(as, bs), (std::min)(as, bs)));
+   if(storage_size > stack_size)
+   {
+      detail::scoped_limb_storage<std::allocator<limb_type> > storage(std::allocator<limb_type>(), storage_size);
+      detail::multiply_subquadratic_limbs(storage.data(), pa, as, pb, bs, storage.data() + as + bs);
+      copy_product_result(result, storage.data(), as + bs);
+   }
+   else
+   {
+      limb_type storage[stack_size];
+      detail::multiply_subquadratic_limbs(storage, pa, as, pb, bs, storage + as + bs);
+      copy_product_result(result, storage, as + bs);
+   }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+}}} // namespaces
+
+#endif
@@ -437,6 +437,20 @@ inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBit
    if(vs)
       v >>= vs;
 
+   if(u.size() > 2)
+   {
+      //
+      // Reduce u modulo v first, after which single limb arithmetic suffices.
+      // v is odd, so any factors of 2 in the remainder can be discarded:
+      //
+      limb_type r = eval_integer_modulus(u, v);
+      if(r)
+         v = integer_gcd_reduce(static_cast<limb_type>(r >> boost::multiprecision::detail::find_lsb(r)), v);
+      result = v;
+      eval_left_shift(result, shift);
+      return;
+   }
+
    do 
    {
       /* Now u and v are both odd, so diff(u, v) is even.
@@ -502,6 +516,16 @@ inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBit
       eval_gcd(result, a, *b.limbs());
       return;
    }
+   if((std::max)(a.size(), b.size()) >= lehmer_gcd_cutoff)
+   {
+      detail::gcd_big_type u, v;
+      copy_product_result(u, a.limbs(), a.size());
+      copy_product_result(v, b.limbs(), b.size());
+      detail::gcd_lehmer(u, v);
+      result.sign(false);
+      copy_product_result(result, u.limbs(), u.size());
+      return;
+   }
 
    int shift;
 
@@ -571,6 +595,52 @@ inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBit
    eval_left_shift(result, shift);
 }
 //
+// Extended GCD: sets g = gcd(a, b) and s, t such that a * s + b * t = g:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value>::type
+   eval_gcdext(
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& g, 
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& s, 
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& t, 
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a, 
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& b)
+{
+   detail::gcd_big_type u, v, x, y;
+   bool a_neg = a.sign();
+   bool b_neg = b.sign();
+   copy_product_result(u, a.limbs(), a.size());
+   copy_product_result(v, b.limbs(), b.size());
+   if(eval_is_zero(v))
+   {
+      // gcd(a, 0) = |a|:
+      x = static_cast<limb_type>(eval_is_zero(u) ? 0u : 1u);
+      y = static_cast<limb_type>(0u);
+   }
+   else if(eval_is_zero(u))
+   {
+      u.swap(v);
+      x = static_cast<limb_type>(0u);
+      y = static_cast<limb_type>(1u);
+   }
+   else
+      detail::gcdext_lehmer(u, v, x, y);
+   if(a_neg)
+      x.negate();
+   if(b_neg)
+      y.negate();
+   g.sign(false);
+   copy_product_result(g, u.limbs(), u.size());
+   s.sign(false);
+   copy_product_result(s, x.limbs(), x.size());
+   if(x.sign())
+      s.negate();
+   t.sign(false);
+   copy_product_result(t, y.limbs(), y.size());
+   if(y.sign())
+      t.negate();
+}
+//
 // Now again for trivial backends:
 //
 template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
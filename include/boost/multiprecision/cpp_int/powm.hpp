@@ -0,0 +1,498 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Modular exponentiation for cpp_int_backend.
+//
+// The generic eval_powm in default_ops performs a full division after every
+// multiplication.  Here we instead use Montgomery multiplication when the modulus
+// is odd, and Barrett reduction when it is even, so that after a one off setup
+// cost no further division is required.  The exponent is scanned with a sliding
+// window, which reduces the number of multiplications (as opposed to squarings)
+// to roughly bits / (window + 1).
+//
+// As with the code in karatsuba.hpp, the routines here operate on raw arrays of limbs
+// carved out of a single block of memory allocated up front.
+//
+#ifndef BOOST_MP_CPP_INT_POWM_HPP
+#define BOOST_MP_CPP_INT_POWM_HPP
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127) // conditional expression is constant
+#endif
+
+namespace detail{
+
+//
+// Returns -1/m mod 2^bits_per_limb for odd m.  m * m == 1 mod 8 so m is its own
+// inverse to 3 bits, and each Newton step doubles the number of correct bits:
+//
+inline limb_type montgomery_inverse(limb_type m) BOOST_NOEXCEPT
+{
+   limb_type inv = m;
+   for(unsigned bits = 3; bits < bits_per_limb; bits *= 2)
+      inv *= 2 - m * inv;
+   return 0 - inv;
+}
+
+//
+// Montgomery multiplication modulo an odd value m of n limbs, with R = 2^(n * bits_per_limb).
+// Values are held in the form xR mod m, and multiply(r, x, y) computes xyR^-1 mod m.
+// The product and reduction are separate steps so that the squaring and subquadratic
+// multiplication routines can be used for the former.
+//
+class montgomery_reducer
+{
+   const limb_type* m_mod;
+   unsigned m_size;
+   limb_type m_inv;
+   limb_type* m_product;  // 2n + 1 limbs
+   limb_type* m_scratch;
+public:
+   montgomery_reducer(const limb_type* m, unsigned n, limb_type inv, limb_type* workspace) BOOST_NOEXCEPT
+      : m_mod(m), m_size(n), m_inv(inv), m_product(workspace), m_scratch(workspace + 2 * n + 1) {}
+
+   static unsigned storage(unsigned n) BOOST_NOEXCEPT
+   {
+      return 2 * n + 1 + multiply_limbs_storage(n, n);
+   }
+   //
+   // r = m_product * R^-1 mod m, where m_product < mR:
+   //
+   void reduce(limb_type* r) BOOST_NOEXCEPT
+   {
+      limb_type* t = m_product;
+      t[2 * m_size] = 0;
+      for(unsigned i = 0; i < m_size; ++i)
+      {
+         limb_type u = t[i] * m_inv;
+         double_limb_type carry = 0;
+         for(unsigned j = 0; j < m_size; ++j)
+         {
+            carry += static_cast<double_limb_type>(u) * static_cast<double_limb_type>(m_mod[j]) + t[i + j];
+            t[i + j] = static_cast<limb_type>(carry);
+            carry >>= bits_per_limb;
+         }
+         for(unsigned j = i + m_size; carry && (j <= 2 * m_size); ++j)
+         {
+            carry += t[j];
+            t[j] = static_cast<limb_type>(carry);
+            carry >>= bits_per_limb;
+         }
+      }
+      // The result is in the top n + 1 limbs, and is less than 2m:
+      t += m_size;
+      if(compare_limbs(t, m_size + 1, m_mod, m_size) >= 0)
+         subtract_limbs(t, t, m_size + 1, m_mod, m_size);
+      std::memcpy(r, t, m_size * sizeof(limb_type));
+   }
+   void multiply(limb_type* r, const limb_type* x, const limb_type* y)
+   {
+      multiply_limbs(m_product, x, m_size, y, m_size, m_scratch);
+      reduce(r);
+   }
+   //
+   // Conversion out of Montgomery form, r = xR^-1 mod m:
+   //
+   void convert(limb_type* r, const limb_type* x) BOOST_NOEXCEPT
+   {
+      std::memcpy(m_product, x, m_size * sizeof(limb_type));
+      std::memset(m_product + m_size, 0, m_size * sizeof(limb_type));
+      reduce(r);
+   }
+};
+
+//
+// Truncated schoolbook products for the Barrett reduction below.  The first computes
+// the limbs of a * b from k upwards, ignoring all the partial products which lie
+// wholly below limb k - 2, so the value in limbs k and above may be up to 1 too small:
+//
+inline void multiply_high_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, unsigned k) BOOST_NOEXCEPT
+{
+   std::memset(r, 0, (an + bn) * sizeof(limb_type));
+   for(unsigned i = 0; i < an; ++i)
+   {
+      unsigned j = i + 2 < k ? k - 2 - i : 0;
+      if(j >= bn)
+         continue;
+      double_limb_type carry = 0;
+      for(; j < bn; ++j)
+      {
+         carry += static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(b[j]) + r[i + j];
+         r[i + j] = static_cast<limb_type>(carry);
+         carry >>= bits_per_limb;
+      }
+      r[i + bn] = static_cast<limb_type>(carry);
+   }
+}
+//
+// And the second computes the low k limbs of a * b only:
+//
+inline void multiply_low_limbs(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, unsigned k) BOOST_NOEXCEPT
+{
+   std::memset(r, 0, k * sizeof(limb_type));
+   for(unsigned i = 0; (i < an) && (i < k); ++i)
+   {
+      double_limb_type carry = 0;
+      unsigned jn = (std::min)(bn, k - i);
+      for(unsigned j = 0; j < jn; ++j)
+      {
+         carry += static_cast<double_limb_type>(a[i]) * static_cast<double_limb_type>(b[j]) + r[i + j];
+         r[i + j] = static_cast<limb_type>(carry);
+         carry >>= bits_per_limb;
+      }
+      if(i + bn < k)
+         r[i + bn] = static_cast<limb_type>(carry);
+   }
+}
+
+//
+// Barrett reduction modulo m of n limbs, using mu = floor(b^2n / m) where b = 2^bits_per_limb.
+// Values are held in normal form.  The quotient estimate is at most 3 too small (one
+// more than usual as the high product is truncated), so at most 3 correcting subtractions
+// are required.  Below the Karatsuba cutoff only the parts of the products which are
+// actually needed are computed:
+//
+class barrett_reducer
+{
+   const limb_type* m_mod;
+   unsigned m_size;
+   const limb_type* m_mu;
+   unsigned m_mu_size;
+   limb_type* m_product;  // 2n limbs
+   limb_type* m_quotient; // n + 1 + mu_size limbs
+   limb_type* m_qm;       // n + mu_size limbs
+   limb_type* m_scratch;
+public:
+   barrett_reducer(const limb_type* m, unsigned n, const limb_type* mu, unsigned mun, limb_type* workspace) BOOST_NOEXCEPT
+      : m_mod(m), m_size(n), m_mu(mu), m_mu_size(mun), m_product(workspace), m_quotient(workspace + 2 * n),
+      m_qm(workspace + 3 * n + 1 + mun), m_scratch(workspace + 4 * n + 1 + 2 * mun) {}
+
+   static unsigned storage(unsigned n, unsigned mun) BOOST_NOEXCEPT
+   {
+      return 4 * n + 1 + 2 * mun + (std::max)(multiply_limbs_storage(n, n), (std::max)(multiply_limbs_storage(n + 1, mun), multiply_limbs_storage(mun, n)));
+   }
+   void multiply(limb_type* r, const limb_type* x, const limb_type* y)
+   {
+      multiply_limbs(m_product, x, m_size, y, m_size, m_scratch);
+      //
+      // q = ((xy >> (n - 1) limbs) * mu) >> (n + 1) limbs, then r = xy - qm.
+      // The result is less than 3m, so only the low n + 1 limbs of each are required:
+      //
+      bool truncate = m_size + 1 < karatsuba_cutoff;
+      if(truncate)
+         multiply_high_limbs(m_quotient, m_product + m_size - 1, m_size + 1, m_mu, m_mu_size, m_size + 1);
+      else
+         multiply_limbs(m_quotient, m_product + m_size - 1, m_size + 1, m_mu, m_mu_size, m_scratch);
+      const limb_type* q = m_quotient + m_size + 1;
+      unsigned qn = m_mu_size;
+      while(qn && !q[qn - 1])
+         --qn;
+      if(qn)
+      {
+         if(truncate)
+            multiply_low_limbs(m_qm, q, qn, m_mod, m_size, m_size + 1);
+         else
+         {
+            // Use all mu_size limbs of q, as only that product is allowed for in storage():
+            multiply_limbs(m_qm, q, m_mu_size, m_mod, m_size, m_scratch);
+         }
+         subtract_limbs(m_product, m_product, m_size + 1, m_qm, m_size + 1);
+      }
+      while(compare_limbs(m_product, m_size + 1, m_mod, m_size) >= 0)
+         subtract_limbs(m_product, m_product, m_size + 1, m_mod, m_size);
+      std::memcpy(r, m_product, m_size * sizeof(limb_type));
+   }
+};
+
+//
+// Window size (in bits) for an exponent of ebits bits, chosen to minimise the total
+// number of multiplications including those needed to fill the table:
+//
+inline unsigned powm_window_bits(unsigned ebits) BOOST_NOEXCEPT
+{
+   return ebits <= 8 ? 1 : ebits <= 24 ? 2 : ebits <= 80 ? 3 : ebits <= 240 ? 4 : ebits <= 672 ? 5 : 6;
+}
+
+inline unsigned powm_bit(const limb_type* e, unsigned i) BOOST_NOEXCEPT
+{
+   return static_cast<unsigned>(e[i / bits_per_limb] >> (i % bits_per_limb)) & 1u;
+}
+
+//
+// Sliding window exponentiation r = g^e where g is held in table[0], e has ebits bits
+// with the most significant set, and table has room for 2^(k-1) values of n limbs
+// which are filled with the odd powers g, g^3, g^5, ... g^(2^k - 1):
+//
+template <class Reducer>
+void powm_sliding_window(Reducer& red, limb_type* r, limb_type* table, unsigned n, const limb_type* e, unsigned ebits, unsigned k)
+{
+   if(k > 1)
+   {
+      red.multiply(r, table, table);
+      for(unsigned i = 1; i < (1u << (k - 1)); ++i)
+         red.multiply(table + i * n, table + (i - 1) * n, r);
+   }
+   bool started = false;
+   unsigned i = ebits;
+   while(i)
+   {
+      if(!powm_bit(e, i - 1))
+      {
+         red.multiply(r, r, r);
+         --i;
+         continue;
+      }
+      //
+      // Find the longest window [l, i) of at most k bits ending in a set bit:
+      //
+      unsigned l = i > k ? i - k : 0;
+      while(!powm_bit(e, l))
+         ++l;
+      unsigned w = 0;
+      for(unsigned j = i; j > l; --j)
+         w = (w << 1) | powm_bit(e, j - 1);
+      if(started)
+      {
+         for(unsigned j = l; j < i; ++j)
+            red.multiply(r, r, r);
+         red.multiply(r, r, table + (w >> 1) * n);
+      }
+      else
+      {
+         std::memcpy(r, table + (w >> 1) * n, n * sizeof(limb_type));
+         started = true;
+      }
+      i = l;
+   }
+}
+
+//
+// Precomputed values for arithmetic modulo a fixed m > 0 of n limbs: the Montgomery
+// inverse and R^2 mod m when m is odd, and the Barrett constant when it is even.
+// Residues are arrays of n limbs, in Montgomery form when m is odd, and in normal
+// form otherwise.  The workspace is held here too, so a single object must not
+// be used concurrently from more than one thread.
+//
+class cpp_int_modulus
+{
+   typedef cpp_int_backend<> big_type;
+
+   big_type m_mod;
+   unsigned m_size;
+   bool m_montgomery;
+   limb_type m_inv;
+   std::vector<limb_type> m_aux;       // R^2 mod m, or mu.
+   std::vector<limb_type> m_workspace; // Reducer storage followed by n limbs of temporary.
+   std::vector<limb_type> m_table;     // Window table for powm.
+public:
+   cpp_int_modulus(const limb_type* m, unsigned n) : m_size(n), m_montgomery(m[0] & 1u), m_inv(0)
+   {
+      BOOST_ASSERT(n && m[n - 1]);
+      copy_product_result(m_mod, m, n);
+      big_type t;
+      t = static_cast<limb_type>(1u);
+      eval_left_shift(t, 2 * n * bits_per_limb);
+      unsigned storage;
+      if(m_montgomery)
+      {
+         m_inv = montgomery_inverse(m[0]);
+         eval_modulus(t, t, m_mod);
+         m_aux.assign(n, 0);
+         storage = montgomery_reducer::storage(n);
+      }
+      else
+      {
+         eval_divide(t, t, m_mod);
+         m_aux.resize(t.size());
+         storage = barrett_reducer::storage(n, t.size());
+      }
+      std::memcpy(&m_aux[0], t.limbs(), t.size() * sizeof(limb_type));
+      m_workspace.resize(storage + n);
+   }
+   unsigned size()const BOOST_NOEXCEPT { return m_size; }
+   const limb_type* modulus()const BOOST_NOEXCEPT { return m_mod.limbs(); }
+   //
+   // r = xy mod m for residues x and y, all of which may alias:
+   //
+   void multiply(limb_type* r, const limb_type* x, const limb_type* y)
+   {
+      if(m_montgomery)
+      {
+         montgomery_reducer red(m_mod.limbs(), m_size, m_inv, &m_workspace[0]);
+         red.multiply(r, x, y);
+      }
+      else
+      {
+         barrett_reducer red(m_mod.limbs(), m_size, &m_aux[0], static_cast<unsigned>(m_aux.size()), &m_workspace[0]);
+         red.multiply(r, x, y);
+      }
+   }
+   //
+   // Sets r to the residue of the value x of xn limbs, which is negative when neg is set:
+   //
+   void to_residue(limb_type* r, const limb_type* x, unsigned xn, bool neg = false)
+   {
+      limb_type* t = &m_workspace[m_workspace.size() - m_size];
+      if(compare_limbs(x, xn, m_mod.limbs(), m_size) >= 0)
+      {
+         big_type v;
+         copy_product_result(v, x, xn);
+         eval_modulus(v, v, m_mod);
+         std::memset(t, 0, m_size * sizeof(limb_type));
+         std::memcpy(t, v.limbs(), v.size() * sizeof(limb_type));
+      }
+      else
+      {
+         std::memset(t + xn, 0, (m_size - xn) * sizeof(limb_type));
+         std::memmove(t, x, xn * sizeof(limb_type));
+      }
+      if(neg)
+      {
+         // -x mod m = m - (x mod m), unless that is zero:
+         unsigned tn = m_size;
+         while(tn && !t[tn - 1])
+            --tn;
+         if(tn)
+            reverse_subtract_limbs(t, t, m_size, m_mod.limbs(), m_size);
+      }
+      if(m_montgomery)
+         multiply(r, t, &m_aux[0]);
+      else
+         std::memcpy(r, t, m_size * sizeof(limb_type));
+   }
+   //
+   // Sets r to the value of the residue x:
+   //
+   void from_residue(limb_type* r, const limb_type* x)
+   {
+      if(m_montgomery)
+      {
+         montgomery_reducer red(m_mod.limbs(), m_size, m_inv, &m_workspace[0]);
+         red.convert(r, x);
+      }
+      else
+         std::memmove(r, x, m_size * sizeof(limb_type));
+   }
+   //
+   // r = x^e mod m for residue x, e has en limbs:
+   //
+   void powm(limb_type* r, const limb_type* x, const limb_type* e, unsigned en)
+   {
+      while(en && !e[en - 1])
+         --en;
+      if(!en)
+      {
+         limb_type one = 1;
+         to_residue(r, &one, 1);
+         return;
+      }
+      unsigned ebits = (en - 1) * bits_per_limb + boost::multiprecision::detail::find_msb(e[en - 1]) + 1;
+      unsigned k = powm_window_bits(ebits);
+      m_table.resize(m_size << (k - 1));
+      std::memcpy(&m_table[0], x, m_size * sizeof(limb_type));
+      if(m_montgomery)
+      {
+         montgomery_reducer red(m_mod.limbs(), m_size, m_inv, &m_workspace[0]);
+         powm_sliding_window(red, r, &m_table[0], m_size, e, ebits, k);
+      }
+      else
+      {
+         barrett_reducer red(m_mod.limbs(), m_size, &m_aux[0], static_cast<unsigned>(m_aux.size()), &m_workspace[0]);
+         powm_sliding_window(red, r, &m_table[0], m_size, e, ebits, k);
+      }
+   }
+};
+
+//
+// result = a^e mod c, e has en limbs and is non-zero, c is non-zero:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+void powm_imp(
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+   const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a,
+   const limb_type* pe, unsigned en,
+   const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& c)
+{
+   // With truncated division the result is negative only when a is negative and e is odd:
+   bool neg = a.sign() && (pe[0] & 1u);
+   cpp_int_modulus mod(c.limbs(), c.size());
+   scoped_limb_storage<std::allocator<limb_type> > storage(std::allocator<limb_type>(), c.size());
+   limb_type* r = storage.data();
+   mod.to_residue(r, a.limbs(), a.size());
+   mod.powm(r, r, pe, en);
+   mod.from_residue(r, r);
+   result.sign(false);
+   copy_product_result(result, r, c.size());
+   if(neg)
+      result.negate();
+}
+
+//
+// Handles the cases where either the exponent or the modulus is zero, returns true
+// if the result has been computed:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+bool powm_special_cases(
+   cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+   bool zero_exponent,
+   const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& c)
+{
+   if(zero_exponent || eval_is_zero(c))
+   {
+      // Either 1 % c or a division by zero error:
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> one(static_cast<limb_type>(1u));
+      eval_modulus(result, one, c);
+      return true;
+   }
+   return false;
+}
+
+} // namespace detail
+
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value>::type
+   eval_powm(
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& p,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& c)
+{
+   if(p.sign())
+   {
+      BOOST_THROW_EXCEPTION(std::runtime_error("powm requires a positive exponent."));
+   }
+   if(!detail::powm_special_cases(result, eval_is_zero(p), c))
+      detail::powm_imp(result, a, p.limbs(), p.size(), c);
+}
+
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1, class Integer>
+inline typename enable_if_c<!is_trivial_cpp_int<cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> >::value && is_unsigned<Integer>::value>::type
+   eval_powm(
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& a,
+      Integer b,
+      const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& c)
+{
+   if(!detail::powm_special_cases(result, b == 0, c))
+   {
+      limb_type e[2] = { static_cast<limb_type>(b), 0 };
+      if(sizeof(Integer) > sizeof(limb_type))
+         e[1] = static_cast<limb_type>(static_cast<double_limb_type>(b) >> bits_per_limb);
+      detail::powm_imp(result, a, e, 2, c);
+   }
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+}}} // namespaces
+
+#endif
@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Decimal string conversion for large cpp_int_backend values.
+//
+// Converting one block of decimal digits at a time is quadratic in the number of digits.
+// Instead we divide (or multiply) by 10^(d * 2^k), where d is the number of decimal digits
+// per block, which splits the value into two halves which are converted recursively.  The
+// division and multiplication are then subquadratic (see karatsuba.hpp and
+// divide_subquadratic.hpp), and so is the conversion.  The powers 10^(d * 2^k) are cached
+// per thread, and are reused by all subsequent conversions.
+//
+#ifndef BOOST_MP_CPP_INT_RADIX_HPP
+#define BOOST_MP_CPP_INT_RADIX_HPP
+
+//
+// Size (in limbs) at which we switch from converting one block at a time to the
+// divide and conquer method, for output and input respectively.  Input of a block
+// at a time needs only one single limb multiplication per block, so is the faster of
+// the two for longer.  See performance/radix_performance.cpp for the benchmarks
+// used to choose these values.
+//
+#ifndef BOOST_MP_RADIX_OUTPUT_CUTOFF
+#  define BOOST_MP_RADIX_OUTPUT_CUTOFF 40
+#endif
+#ifndef BOOST_MP_RADIX_INPUT_CUTOFF
+#  define BOOST_MP_RADIX_INPUT_CUTOFF 400
+#endif
+
+#include <vector>
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable:4127) // conditional expression is constant
+#endif
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_RADIX_OUTPUT_CUTOFF >= 2, "The radix output cutoff must be at least 2 limbs.");
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_RADIX_INPUT_CUTOFF >= 2, "The radix input cutoff must be at least 2 limbs.");
+
+static const unsigned radix_output_cutoff = BOOST_MP_RADIX_OUTPUT_CUTOFF;
+static const unsigned radix_input_cutoff = BOOST_MP_RADIX_INPUT_CUTOFF;
+
+namespace detail{
+
+typedef cpp_int_backend<> radix_big_type;
+
+//
+// Returns the cached powers 10^(digits_per_block_10 * 2^i), for i = 0 to at least k.
+// References into the result are invalidated by a later call with a larger k:
+//
+inline const std::vector<radix_big_type>& decimal_powers(unsigned k)
+{
+   static BOOST_MP_THREAD_LOCAL std::vector<radix_big_type> powers;
+   if(powers.empty())
+   {
+      powers.push_back(radix_big_type());
+      powers.back() = max_block_10;
+   }
+   while(powers.size() <= k)
+   {
+      radix_big_type t;
+      eval_square(t, powers.back());
+      powers.push_back(radix_big_type());
+      powers.back().swap(t);
+   }
+   return powers;
+}
+
+//
+// Writes the ndigits least significant decimal digits of the n limbs at p to
+// [first, first + ndigits), with leading zeros as required.  The limbs are overwritten:
+//
+inline void decimal_base_case(limb_type* p, unsigned n, char* first, std::size_t ndigits)
+{
+   char* pos = first + ndigits;
+   const unsigned s = leading_zero_bits(max_block_10);
+   const limb_type inv = reciprocal_limb(max_block_10 << s);
+   while(((n > 1) || *p) && (pos != first))
+   {
+      // p /= max_block_10, and write out the remainder:
+      limb_type v = divide_limbs_1(p, p, n, max_block_10 << s, s, inv);
+      if(!p[n - 1] && (n > 1))
+         --n;
+      for(unsigned i = 0; (i < digits_per_block_10) && (pos != first); ++i)
+      {
+         *--pos = static_cast<char>('0' + v % 10);
+         v /= 10;
+      }
+   }
+   while(pos != first)
+      *--pos = '0';
+}
+
+//
+// Writes the digits_per_block_10 * 2^(k+1) decimal digits of x < 10^(digits_per_block_10 * 2^(k+1))
+// to the buffer at first, x is destroyed:
+//
+inline void decimal_recursive(radix_big_type& x, int k, char* first, const std::vector<radix_big_type>& powers)
+{
+   std::size_t ndigits = static_cast<std::size_t>(digits_per_block_10) << (k + 1);
+   if((k < 0) || (x.size() < radix_output_cutoff))
+   {
+      decimal_base_case(x.limbs(), x.size(), first, ndigits);
+      return;
+   }
+   radix_big_type q, r;
+   divide_unsigned_helper(&q, x, powers[k], r);
+   x = static_cast<limb_type>(0u);
+   decimal_recursive(q, k - 1, first, powers);
+   decimal_recursive(r, k - 1, first + ndigits / 2, powers);
+}
+
+//
+// Sets result to the value of the n decimal digits at s, converting one block at a time:
+//
+template <class CppInt>
+void decimal_base_case_assign(CppInt& result, const char* s, std::size_t n)
+{
+   using default_ops::eval_multiply;
+   using default_ops::eval_add;
+
+   result = static_cast<limb_type>(0u);
+   while(n)
+   {
+      unsigned count = static_cast<unsigned>((std::min)(n, static_cast<std::size_t>(digits_per_block_10)));
+      limb_type block = 0;
+      for(unsigned i = 0; i < count; ++i)
+      {
+         if((s[i] < '0') || (s[i] > '9'))
+            BOOST_THROW_EXCEPTION(std::runtime_error("Unexpected character encountered in input."));
+         block *= 10;
+         block += s[i] - '0';
+      }
+      eval_multiply(result, count == digits_per_block_10 ? max_block_10 : block_multiplier(count - 1));
+      eval_add(result, block);
+      s += count;
+      n -= count;
+   }
+}
+
+//
+// Returns the largest k for which digits_per_block_10 * 2^k < n:
+//
+inline unsigned decimal_split(std::size_t n)
+{
+   unsigned k = 0;
+   while((static_cast<std::size_t>(digits_per_block_10) << (k + 1)) < n)
+      ++k;
+   return k;
+}
+
+//
+// Sets result to the value of the n decimal digits at s, by splitting off the low
+// digits_per_block_10 * 2^k digits, where that is at least half of the total:
+//
+inline void decimal_assign_recursive(radix_big_type& result, const char* s, std::size_t n, const std::vector<radix_big_type>& powers)
+{
+   if(n <= static_cast<std::size_t>(digits_per_block_10) * radix_input_cutoff)
+   {
+      decimal_base_case_assign(result, s, n);
+      return;
+   }
+   unsigned k = decimal_split(n);
+   std::size_t low_digits = static_cast<std::size_t>(digits_per_block_10) << k;
+   radix_big_type high, low;
+   decimal_assign_recursive(high, s, n - low_digits, powers);
+   decimal_assign_recursive(low, s + n - low_digits, low_digits, powers);
+   eval_multiply(result, high, powers[k]);
+   eval_add(result, low);
+}
+
+} // namespace detail
+
+//
+// Sets result to the decimal digits of |t|, possibly with leading zeros:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+void get_decimal_string(std::string& result, const cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& t)
+{
+   if(t.size() < radix_output_cutoff)
+   {
+      cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1> u(t);
+      result.assign(t.size() * bits_per_limb / 3 + 1, '0');
+      detail::decimal_base_case(u.limbs(), u.size(), &result[0], result.size());
+      return;
+   }
+   detail::radix_big_type x;
+   copy_product_result(x, t.limbs(), t.size());
+   //
+   // Find k such that x < 10^(digits_per_block_10 * 2^(k+1)), that is, the square of the k'th power
+   // is larger than x:
+   //
+   unsigned k = 0;
+   while(2 * (detail::decimal_powers(k)[k].size() - 1) < x.size())
+      ++k;
+   result.assign(static_cast<std::size_t>(digits_per_block_10) << (k + 1), '0');
+   detail::decimal_recursive(x, static_cast<int>(k), &result[0], detail::decimal_powers(k));
+}
+
+//
+// Sets result to the value of the decimal digits in the null terminated string s:
+//
+template <unsigned MinBits1, unsigned MaxBits1, cpp_integer_type SignType1, cpp_int_check_type Checked1, class Allocator1>
+void assign_decimal_string(cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>& result, const char* s)
+{
+   std::size_t n = std::strlen(s);
+   //
+   // Checked fixed precision types must detect overflow as it happens, so always go one block at a time:
+   //
+   if((n <= static_cast<std::size_t>(digits_per_block_10) * radix_input_cutoff)
+      || ((Checked1 == checked) && !cpp_int_backend<MinBits1, MaxBits1, SignType1, Checked1, Allocator1>::variable))
+   {
+      detail::decimal_base_case_assign(result, s, n);
+      return;
+   }
+   detail::radix_big_type t;
+   detail::decimal_assign_recursive(t, s, n, detail::decimal_powers(detail::decimal_split(n)));
+   copy_product_result(result, t.limbs(), t.size());
+}
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+}}} // namespaces
+
+#endif
@@ -0,0 +1,210 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Fully unrolled addition, subtraction and multiplication for small fixed precision cpp_int's.
+//
+// For unchecked fixed precision types (int256_t, uint512_t and the like) of at most
+// BOOST_MP_MAX_UNROLLED_LIMBS limbs, these replace the general purpose loops, whose trip
+// counts depend upon the runtime size of each argument, with straight line code generated
+// from the compile time limb count.  Every argument is treated as the full width number it
+// is, with the limbs above its size() read as zero, so there are no size dependent branches
+// beyond the final normalization.  Products are truncated to the width of the type, exactly
+// as the general purpose code would do.  The kernels themselves work on plain limb arrays
+// and are constexpr in C++14.
+//
+#ifndef BOOST_MP_CPP_INT_UNROLLED_HPP
+#define BOOST_MP_CPP_INT_UNROLLED_HPP
+
+//
+// The largest fixed precision type, in limbs, which uses the unrolled code, defining this
+// to zero disables it:
+//
+#ifndef BOOST_MP_MAX_UNROLLED_LIMBS
+#  define BOOST_MP_MAX_UNROLLED_LIMBS 8
+#endif
+
+namespace boost{ namespace multiprecision{ namespace backends{
+
+namespace detail{
+
+//
+// Operations on limbs [I, N) of N limb arrays, where only the first an and bn limbs of
+// the arguments a and b are significant, each returns the carry or borrow out:
+//
+template <unsigned I, unsigned N>
+struct unrolled_limbs
+{
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR limb_type add(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, limb_type carry) BOOST_NOEXCEPT
+   {
+      double_limb_type t = static_cast<double_limb_type>(I < an ? a[I] : 0) + static_cast<double_limb_type>(I < bn ? b[I] : 0) + carry;
+      r[I] = static_cast<limb_type>(t);
+      return unrolled_limbs<I + 1, N>::add(r, a, an, b, bn, static_cast<limb_type>(t >> bits_per_limb));
+   }
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR limb_type subtract(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn, limb_type borrow) BOOST_NOEXCEPT
+   {
+      double_limb_type t = static_cast<double_limb_type>(I < an ? a[I] : 0) - static_cast<double_limb_type>(I < bn ? b[I] : 0) - borrow;
+      r[I] = static_cast<limb_type>(t);
+      return unrolled_limbs<I + 1, N>::subtract(r, a, an, b, bn, static_cast<limb_type>((t >> bits_per_limb) & 1u));
+   }
+   //
+   // r = ~r + carry, with a carry in of 1 this is the two's complement:
+   //
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR void negate(limb_type* r, limb_type carry) BOOST_NOEXCEPT
+   {
+      double_limb_type t = static_cast<double_limb_type>(static_cast<limb_type>(~r[I])) + carry;
+      r[I] = static_cast<limb_type>(t);
+      unrolled_limbs<I + 1, N>::negate(r, static_cast<limb_type>(t >> bits_per_limb));
+   }
+};
+
+template <unsigned N>
+struct unrolled_limbs<N, N>
+{
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR limb_type add(limb_type*, const limb_type*, unsigned, const limb_type*, unsigned, limb_type carry) BOOST_NOEXCEPT
+   {
+      return carry;
+   }
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR limb_type subtract(limb_type*, const limb_type*, unsigned, const limb_type*, unsigned, limb_type borrow) BOOST_NOEXCEPT
+   {
+      return borrow;
+   }
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR void negate(limb_type*, limb_type) BOOST_NOEXCEPT {}
+};
+
+//
+// r[J, K) += x * b[J, K), where only the first bn limbs of b are significant, the
+// carry out of the final limb is discarded:
+//
+template <unsigned J, unsigned K>
+struct unrolled_multiply_row
+{
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR void apply(limb_type* r, limb_type x, const limb_type* b, unsigned bn, limb_type carry) BOOST_NOEXCEPT
+   {
+      double_limb_type t = static_cast<double_limb_type>(x) * static_cast<double_limb_type>(J < bn ? b[J] : 0) + r[J] + carry;
+      r[J] = static_cast<limb_type>(t);
+      unrolled_multiply_row<J + 1, K>::apply(r, x, b, bn, static_cast<limb_type>(t >> bits_per_limb));
+   }
+};
+
+template <unsigned K>
+struct unrolled_multiply_row<K, K>
+{
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR void apply(limb_type*, limb_type, const limb_type*, unsigned, limb_type) BOOST_NOEXCEPT {}
+};
+
+//
+// r += a * b truncated to N limbs, row I adds a[I] * b to r[I, N), rows beyond the
+// significant limbs of a are skipped:
+//
+template <unsigned I, unsigned N>
+struct unrolled_multiply
+{
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR void apply(limb_type* r, const limb_type* a, unsigned an, const limb_type* b, unsigned bn) BOOST_NOEXCEPT
+   {
+      if(I < an)
+      {
+         unrolled_multiply_row<0, N - I>::apply(r + I, a[I], b, bn, 0);
+         unrolled_multiply<I + 1, N>::apply(r, a, an, b, bn);
+      }
+   }
+};
+
+template <unsigned N>
+struct unrolled_multiply<N, N>
+{
+   static BOOST_MP_FORCEINLINE BOOST_CXX14_CONSTEXPR void apply(limb_type*, const limb_type*, unsigned, const limb_type*, unsigned) BOOST_NOEXCEPT {}
+};
+
+} // namespace detail
+
+//
+// True for the types which use the code in this file:
+//
+template <class Backend>
+struct is_unrolled_cpp_int : public mpl::false_ {};
+
+template <unsigned Bits, cpp_integer_type SignType>
+struct is_unrolled_cpp_int<cpp_int_backend<Bits, Bits, SignType, unchecked, void> >
+   : public mpl::bool_<!is_trivial_cpp_int<cpp_int_backend<Bits, Bits, SignType, unchecked, void> >::value
+      && ((Bits + bits_per_limb - 1) / bits_per_limb <= BOOST_MP_MAX_UNROLLED_LIMBS)> {};
+
+//
+// These are more specialized than the general purpose versions in add.hpp and multiply.hpp,
+// so are preferred whenever all the arguments are of the same unrolled type:
+//
+template <unsigned Bits, cpp_integer_type SignType>
+inline typename enable_if_c<is_unrolled_cpp_int<cpp_int_backend<Bits, Bits, SignType, unchecked, void> >::value>::type
+   add_unsigned(
+      cpp_int_backend<Bits, Bits, SignType, unchecked, void>& result,
+      const cpp_int_backend<Bits, Bits, SignType, unchecked, void>& a,
+      const cpp_int_backend<Bits, Bits, SignType, unchecked, void>& b) BOOST_NOEXCEPT
+{
+   static const unsigned N = cpp_int_backend<Bits, Bits, SignType, unchecked, void>::internal_limb_count;
+   bool s = a.sign();
+   detail::unrolled_limbs<0, N>::add(result.limbs(), a.limbs(), a.size(), b.limbs(), b.size(), 0);
+   result.resize(N, N);
+   result.normalize();
+   result.sign(s);
+}
+
+template <unsigned Bits, cpp_integer_type SignType>
+inline typename enable_if_c<is_unrolled_cpp_int<cpp_int_backend<Bits, Bits, SignType, unchecked, void> >::value>::type
+   subtract_unsigned(
+      cpp_int_backend<Bits, Bits, SignType, unchecked, void>& result,
+      const cpp_int_backend<Bits, Bits, SignType, unchecked, void>& a,
+      const cpp_int_backend<Bits, Bits, SignType, unchecked, void>& b) BOOST_NOEXCEPT
+{
+   static const unsigned N = cpp_int_backend<Bits, Bits, SignType, unchecked, void>::internal_limb_count;
+   bool s = a.sign();
+   if(detail::unrolled_limbs<0, N>::subtract(result.limbs(), a.limbs(), a.size(), b.limbs(), b.size(), 0) && (SignType == signed_magnitude))
+   {
+      //
+      // b > a, so the magnitude of the result is the two's complement of what we have.  For
+      // unsigned types we already have the result, modulo 2^N limbs:
+      //
+      detail::unrolled_limbs<0, N>::negate(result.limbs(), 1);
+      s = !s;
+   }
+   result.resize(N, N);
+   result.normalize();
+   result.sign(s);
+}
+
+template <unsigned Bits, cpp_integer_type SignType>
+inline typename enable_if_c<is_unrolled_cpp_int<cpp_int_backend<Bits, Bits, SignType, unchecked, void> >::value>::type
+   eval_multiply(
+      cpp_int_backend<Bits, Bits, SignType, unchecked, void>& result,
+      const cpp_int_backend<Bits, Bits, SignType, unchecked, void>& a,
+      const cpp_int_backend<Bits, Bits, SignType, unchecked, void>& b) BOOST_NOEXCEPT
+{
+   static const unsigned N = cpp_int_backend<Bits, Bits, SignType, unchecked, void>::internal_limb_count;
+   bool s = a.sign() != b.sign();
+   unsigned as = a.size();
+   unsigned bs = b.size();
+   if(as == 1)
+   {
+      limb_type l = *a.limbs();
+      eval_multiply(result, b, l);
+   }
+   else if(bs == 1)
+   {
+      limb_type l = *b.limbs();
+      eval_multiply(result, a, l);
+   }
+   else
+   {
+      // Work in a temporary as the result may alias either argument:
+      limb_type r[N] = { 0 };
+      detail::unrolled_multiply<0, N>::apply(r, a.limbs(), as, b.limbs(), bs);
+      result.resize(N, N);
+      std::memcpy(result.limbs(), r, sizeof(r));
+      result.normalize();
+   }
+   result.sign(s);
+}
+
+}}} // namespaces
+
+#endif
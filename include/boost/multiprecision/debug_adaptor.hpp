@@ -476,6 +476,15 @@ using backends::debug_adaptor;
 template<class Backend>
 struct number_category<backends::debug_adaptor<Backend> > : public number_category<Backend> {};
 
+namespace detail{
+
+template<class Backend>
+struct is_workspace_enabled<backends::debug_adaptor<Backend> > : public is_workspace_enabled<Backend> {};
+template<class Backend>
+struct binary_splitting_integer<backends::debug_adaptor<Backend> > : public binary_splitting_integer<Backend> {};
+
+}
+
 #ifdef BOOST_MSVC
 #pragma warning(pop)
 #endif
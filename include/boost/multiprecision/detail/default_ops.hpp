@@ -8,6 +8,7 @@
 
 #include <boost/math/policies/error_handling.hpp>
 #include <boost/multiprecision/detail/number_base.hpp>
+#include <boost/multiprecision/workspace.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <boost/math/special_functions/next.hpp>
 #include <boost/utility/enable_if.hpp>
@@ -418,6 +419,15 @@ inline void eval_multiply(T& t, const U& u, const V& v)
 {
    eval_multiply_default(t, u, v);
 }
+//
+// Squaring: backends which can square faster than they can multiply (by computing each
+// cross product only once) should overload this, result and a may be the same object:
+//
+template <class T>
+inline void eval_square(T& result, const T& a)
+{
+   eval_multiply(result, a, a);
+}
 
 template <class T>
 inline void eval_multiply_add(T& t, const T& u, const T& v, const T& x)
@@ -1664,7 +1674,7 @@ inline void eval_hypot(R& result, const T& a, const U& b)
 
    R rat;
    eval_divide(rat, y, x);
-   eval_multiply(result, rat, rat);
+   eval_square(result, rat);
    eval_increment(result);
    eval_sqrt(rat, result);
    eval_multiply(result, rat, x);
@@ -8,21 +8,115 @@
 #ifndef BOOST_MP_DETAIL_DYNAMIC_ARRAY_HPP
   #define BOOST_MP_DETAIL_DYNAMIC_ARRAY_HPP
 
-  #include <vector>
+  #include <algorithm>
+  #include <cstddef>
+  #include <boost/cstdint.hpp>
+  #include <boost/config.hpp>
+  #ifndef BOOST_NO_CXX11_HDR_ARRAY
+  #include <array>
+  #else
+  #include <boost/array.hpp>
+  #endif
   #include <boost/multiprecision/detail/rebind.hpp>
 
   namespace boost { namespace multiprecision { namespace backends { namespace detail
   {
+    // Passed to the array constructors when every element is about to be
+    // overwritten, so that the elements need not be zeroed first.
+    struct array_no_fill {};
+
+    // Fixed size storage held within the object, zeroed on default construction.
+    template <class value_type, const boost::uint32_t elem_number>
+#ifndef BOOST_NO_CXX11_HDR_ARRAY
+    struct static_array : public std::array<value_type, elem_number>
+    {
+       typedef std::array<value_type, elem_number> base_type;
+#else
+    struct static_array : public boost::array<value_type, elem_number>
+    {
+       typedef boost::array<value_type, elem_number> base_type;
+#endif
+       static_array() BOOST_NOEXCEPT : base_type() { }
+       explicit static_array(const array_no_fill&) BOOST_NOEXCEPT { }
+    };
+
+    // Fixed size storage obtained from the allocator.  Copy assignment reuses the
+    // existing block, while move assignment and swap exchange blocks, so that every
+    // array, including one that has been moved from, always owns a block.
     template <class value_type, const boost::uint32_t elem_number, class my_allocator>
-    struct dynamic_array : public std::vector<value_type, typename rebind<value_type, my_allocator>::type>
+    struct dynamic_array : private rebind<value_type, my_allocator>::type
     {
-       dynamic_array() :
-         std::vector<value_type, typename rebind<value_type, my_allocator>::type>(static_cast<typename std::vector<value_type, typename rebind<value_type, my_allocator>::type>::size_type>(elem_number), static_cast<value_type>(0))
+       typedef typename rebind<value_type, my_allocator>::type allocator_type;
+       typedef value_type*                                     iterator;
+       typedef const value_type*                               const_iterator;
+       typedef value_type&                                     reference;
+       typedef const value_type&                               const_reference;
+       typedef std::size_t                                     size_type;
+
+       dynamic_array() : m_data(allocate())
        {
+          std::fill(m_data, m_data + elem_number, static_cast<value_type>(0));
        }
 
-             value_type* data()       { return &(*(this->begin())); }
-       const value_type* data() const { return &(*(this->begin())); }
+       explicit dynamic_array(const array_no_fill&) : m_data(allocate()) { }
+
+       dynamic_array(const dynamic_array& other) : allocator_type(other), m_data(allocate())
+       {
+          std::copy(other.begin(), other.end(), m_data);
+       }
+
+       ~dynamic_array()
+       {
+          allocator().deallocate(m_data, elem_number);
+       }
+
+       dynamic_array& operator=(const dynamic_array& other)
+       {
+          std::copy(other.begin(), other.end(), m_data);
+          return *this;
+       }
+
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+       dynamic_array& operator=(dynamic_array&& other)
+       {
+          // Our old block goes to other, which is usually a temporary, or
+          // is reused if other is assigned to again:
+          if(allocator() == other.allocator())
+             swap(other);
+          else
+             *this = static_cast<const dynamic_array&>(other);
+          return *this;
+       }
+#endif
+
+       void swap(dynamic_array& other) BOOST_NOEXCEPT
+       {
+          std::swap(m_data, other.m_data);
+       }
+
+             iterator begin()       { return m_data; }
+       const_iterator begin() const { return m_data; }
+             iterator end()         { return m_data + elem_number; }
+       const_iterator end() const   { return m_data + elem_number; }
+
+             value_type* data()       { return m_data; }
+       const value_type* data() const { return m_data; }
+
+             reference front()       { return *m_data; }
+       const_reference front() const { return *m_data; }
+
+             reference operator[](size_type i)       { return m_data[i]; }
+       const_reference operator[](size_type i) const { return m_data[i]; }
+
+       static size_type size() { return elem_number; }
+
+    private:
+             allocator_type& allocator()       { return *this; }
+       const allocator_type& allocator() const { return *this; }
+
+       value_type* allocate() { return allocator().allocate(elem_number); }
+
+       value_type* m_data;
     };
   } } } } // namespace boost::multiprecision::backends::detail
 
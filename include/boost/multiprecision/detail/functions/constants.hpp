@@ -6,6 +6,383 @@
 // This file has no include guards or namespaces - it's expanded inline inside default_ops.hpp
 // 
 
+//
+// Binary splitting: the sum over [a, b) of a(k) p(a)...p(k) / (q(a)...q(k)) is T(a, b) / Q(a, b), where
+// P(a, b) and Q(a, b) are the products of the p(k) and q(k).  Splitting the range at m gives
+//
+// P(a, b) = P(a, m) P(m, b),   Q(a, b) = Q(a, m) Q(m, b),   T(a, b) = T(a, m) Q(m, b) + P(a, m) T(m, b)
+//
+// so that the integers multiplied together are always of similar size, and with a fast integer multiply
+// the whole sum costs little more than a few multiplications at the size of the result.  Series sets
+// p = p(k), q = q(k) and t = a(k) p(k) for a single term.  P is not needed at the top level, nor by
+// anything down the right hand edge of the recursion, so we skip it there:
+//
+template <class Int, class Series>
+void eval_binary_split(Int& P, Int& Q, Int& T, const Series& s, unsigned a, unsigned b, bool need_p = true)
+{
+   if(b - a == 1)
+   {
+      s(P, Q, T, a);
+      return;
+   }
+   unsigned m = a + (b - a) / 2;
+   Int P2, Q2, T2;
+   eval_binary_split(P, Q, T, s, a, m);
+   eval_binary_split(P2, Q2, T2, s, m, b, need_p);
+   eval_multiply(T, Q2);
+   eval_multiply(T2, P);
+   eval_add(T, T2);
+   eval_multiply(Q, Q2);
+   if(need_p)
+      eval_multiply(P, P2);
+}
+
+//
+// Sets result to the non-negative integer n of the given number of bits, by converting the two halves
+// separately, so that no more than a few full precision operations are needed at each level:
+//
+template <class T, class Int>
+void eval_integer_to_float(T& result, const Int& n, unsigned bits)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   if(bits <= 32)
+   {
+      ui_type v;
+      eval_convert_to(&v, n);
+      result = v;
+      return;
+   }
+   unsigned h = bits / 2;
+   Int hi, lo;
+   eval_right_shift(hi, n, h);
+   eval_left_shift(lo, hi, h);
+   eval_subtract(lo, n, lo);
+   T t;
+   eval_integer_to_float(result, hi, bits - h);
+   eval_ldexp(result, result, static_cast<int>(h));
+   eval_integer_to_float(t, lo, h);
+   eval_add(result, t);
+}
+
+//
+// Sets result to num / den, both positive, dividing in integers first to 64 bits more than we need.
+// A decimal type is given the quotient scaled by a power of 10 as a string instead, since scaling
+// by a large power of 2 is itself an expensive operation there:
+//
+template <class T, class Int>
+void eval_integer_ratio(T& result, const Int& num, const Int& den, unsigned digits)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+   int shift = static_cast<int>(digits) + 64 + static_cast<int>(eval_msb(den)) - static_cast<int>(eval_msb(num));
+   if(shift < 0)
+      shift = 0;
+   Int q;
+   if(std::numeric_limits<number<T> >::radix == 10)
+   {
+      shift = static_cast<int>(shift * 0.30103) + 2;
+      Int scale, ten;
+      scale = static_cast<ui_type>(1u);
+      ten = static_cast<ui_type>(10u);
+      for(unsigned k = shift; k; k >>= 1)
+      {
+         if(k & 1)
+            eval_multiply(scale, ten);
+         if(k > 1)
+            eval_multiply(ten, ten);
+      }
+      eval_multiply(q, num, scale);
+      eval_divide(q, den);
+      std::string str = q.str(0, std::ios_base::fmtflags(0));
+      str += "e-";
+      str += boost::lexical_cast<std::string>(shift);
+      result = str.c_str();
+      return;
+   }
+   eval_left_shift(q, num, shift);
+   eval_divide(q, den);
+   eval_integer_to_float(result, q, static_cast<unsigned>(eval_msb(q)) + 1);
+   eval_ldexp(result, result, -shift);
+}
+
+//
+// The series for each constant, in terms of p(k), q(k) and a(k) as described above:
+//
+// e = SUM[k>=0] 1 / k!
+//
+struct e_series
+{
+   template <class Int>
+   void operator()(Int& p, Int& q, Int& t, unsigned k)const
+   {
+      typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+      p = static_cast<ui_type>(1u);
+      q = static_cast<ui_type>(k ? k : 1u);
+      t = p;
+   }
+};
+
+//
+// ln(2) = 3/4 SUM[k>=0] ((-1)^k * k!^2 / (2^k(2k+1)!)), where each term is -k / (8k + 4) times the last:
+//
+struct log2_series
+{
+   template <class Int>
+   void operator()(Int& p, Int& q, Int& t, unsigned k)const
+   {
+      typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+      p = static_cast<ui_type>(k ? k : 1u);
+      if(k)
+         p.negate();
+      q = static_cast<ui_type>(k ? 8u * k + 4u : 1u);
+      t = p;
+   }
+};
+
+//
+// Chudnovsky's formula:
+//
+// 1 / pi = 12 SUM[k>=0] ((-1)^k (6k)! (13591409 + 545140134k) / ((3k)! k!^3 640320^(3k+3/2)))
+//
+// where each term is -(6k-5)(2k-1)(6k-1) / (k^3 640320^3 / 24) times the last, ignoring the change
+// in a(k) = 13591409 + 545140134k.  Each term adds a little over 47 bits:
+//
+struct chudnovsky_series
+{
+   template <class Int>
+   void operator()(Int& p, Int& q, Int& t, unsigned k)const
+   {
+      typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+      if(k)
+      {
+         p = static_cast<ui_type>(6u * k - 5u);
+         eval_multiply(p, static_cast<ui_type>(2u * k - 1u));
+         eval_multiply(p, static_cast<ui_type>(6u * k - 1u));
+         p.negate();
+         q = static_cast<ui_type>(k);
+         eval_multiply(q, static_cast<ui_type>(k));
+         eval_multiply(q, static_cast<ui_type>(k));
+         // 640320^3 / 24:
+         eval_multiply(q, static_cast<ui_type>(320160u));
+         eval_multiply(q, static_cast<ui_type>(320160u));
+         eval_multiply(q, static_cast<ui_type>(106720u));
+      }
+      else
+      {
+         p = static_cast<ui_type>(1u);
+         q = p;
+      }
+      t = static_cast<ui_type>(k);
+      eval_multiply(t, static_cast<ui_type>(545140134u));
+      eval_add(t, static_cast<ui_type>(13591409u));
+      eval_multiply(t, p);
+   }
+};
+
+template <class T>
+bool calc_log2_binary_split(T&, unsigned, void*)
+{
+   return false;
+}
+
+template <class T, class Int>
+bool calc_log2_binary_split(T& result, unsigned digits, Int*)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+   Int P, Q, S;
+   eval_binary_split(P, Q, S, log2_series(), 0, (digits + 64) / 3 + 2, false);
+   eval_multiply(S, static_cast<ui_type>(3u));
+   eval_multiply(Q, static_cast<ui_type>(4u));
+   eval_integer_ratio(result, S, Q, digits);
+   return true;
+}
+
+template <class T>
+bool calc_e_binary_split(T&, unsigned, void*)
+{
+   return false;
+}
+
+template <class T, class Int>
+bool calc_e_binary_split(T& result, unsigned digits, Int*)
+{
+   //
+   // Enough terms that N! > 2^(digits + 64):
+   //
+   unsigned n = 2;
+   for(double bits = 1; bits < digits + 64; ++n)
+      bits += std::log(static_cast<double>(n)) / std::log(2.0);
+   Int P, Q, S;
+   eval_binary_split(P, Q, S, e_series(), 0, n, false);
+   eval_integer_ratio(result, S, Q, digits);
+   return true;
+}
+
+//
+// Sets s to sqrt(n) * 2^k for a small integer n, with a relative error below 2^-k, by Newton's
+// iteration s = (s + n 2^2j / s) / 2 from a double precision start with j = 12.  Each step squares
+// the relative error, so j very nearly doubles each time, and the cost is that of a couple of
+// full length divisions:
+//
+template <class Int>
+void eval_scaled_integer_sqrt(Int& s, boost::uint32_t n, unsigned k)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+   BOOST_ASSERT(n < 0x10000u);
+   unsigned j = k < 12 ? k : 12;
+   s = static_cast<ui_type>(static_cast<boost::uint32_t>(std::ldexp(std::sqrt(static_cast<double>(n)), static_cast<int>(j))));
+   Int t;
+   while(j < k)
+   {
+      unsigned j2 = 2 * j - 4 < k ? 2 * j - 4 : k;
+      eval_left_shift(s, j2 - j);
+      j = j2;
+      t = static_cast<ui_type>(n);
+      eval_left_shift(t, 2 * j);
+      eval_divide(t, s);
+      eval_add(s, t);
+      eval_right_shift(s, 1);
+   }
+}
+
+template <class T>
+bool calc_pi_binary_split(T&, unsigned, void*)
+{
+   return false;
+}
+
+template <class T, class Int>
+bool calc_pi_binary_split(T& result, unsigned digits, Int*)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+   //
+   // pi = 426880 sqrt(10005) Q / T.  The square root goes into the numerator as the integer
+   // sqrt(10005) * 2^k, so that it too is carried to the 64 extra bits of eval_integer_ratio, and
+   // the result is rounded only once.  Q and T have rather more than the k bits needed, so
+   // first truncate both to k + 32 bits or so, and the product back down by 2^k, each of which
+   // loses less than one part in 2^k:
+   //
+   Int P, Q, S, root;
+   eval_binary_split(P, Q, S, chudnovsky_series(), 0, (digits + 64) / 47 + 2, false);
+   const unsigned k = digits + 64;
+   if(eval_msb(S) > k + 32)
+   {
+      unsigned excess = static_cast<unsigned>(eval_msb(S)) - k - 32;
+      eval_right_shift(Q, excess);
+      eval_right_shift(S, excess);
+   }
+   eval_scaled_integer_sqrt(root, 10005u, k);
+   eval_multiply(Q, static_cast<ui_type>(426880u));
+   eval_multiply(Q, root);
+   eval_right_shift(Q, k);
+   eval_integer_ratio(result, Q, S, digits);
+   return true;
+}
+
+//
+// Euler's constant by Brent and McMillan's algorithm B1: with t(k) = (n^k / k!)^2 and H(k) the
+// harmonic numbers,
+//
+// gamma = SUM[k>=0] t(k) H(k) / SUM[k>=0] t(k) - ln(n) + O(e^(-4n))
+//
+// where the sums may be cut off at k = 3.5912n.  We take n = 2^m, so that ln(n) = m ln(2).  As well
+// as the P, Q and T of the sum of t(k), split over [a, b) in the same way, the harmonic numbers need
+// D(a, b), the product of the k, with C(a, b) / D(a, b) the sum of the 1/k, and V(a, b) / (D Q) the
+// sum of t(k) H(k), all relative to the start of the range.  Joining the ranges at m:
+//
+// C = C(a, m) D(m, b) + C(m, b) D(a, m)
+// V = V(a, m) D(m, b) Q(m, b) + P(a, m) (C(a, m) D(m, b) T(m, b) + D(a, m) V(m, b))
+//
+// P(a, b) is always a power of two, and is kept as its exponent p:
+//
+template <class Int>
+void eval_euler_split(Int& Q, Int& T, Int& D, Int& C, Int& V, unsigned& p, unsigned m, unsigned a, unsigned b)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+   if(b - a == 1)
+   {
+      if(a == 0)
+      {
+         Q = static_cast<ui_type>(1u);
+         T = Q;
+         D = Q;
+         C = static_cast<ui_type>(0u);
+         V = C;
+         p = 0;
+      }
+      else
+      {
+         Q = static_cast<ui_type>(a);
+         eval_multiply(Q, static_cast<ui_type>(a));
+         T = static_cast<ui_type>(1u);
+         eval_left_shift(T, 2 * m);
+         D = static_cast<ui_type>(a);
+         C = static_cast<ui_type>(1u);
+         V = T;
+         p = 2 * m;
+      }
+      return;
+   }
+   unsigned mid = a + (b - a) / 2;
+   unsigned p2;
+   Int Q2, T2, D2, C2, V2, t;
+   eval_euler_split(Q, T, D, C, V, p, m, a, mid);
+   eval_euler_split(Q2, T2, D2, C2, V2, p2, m, mid, b);
+   eval_multiply(t, C, D2);
+   eval_multiply(t, T2);
+   eval_multiply(V2, D);
+   eval_add(t, V2);
+   eval_left_shift(t, p);
+   eval_multiply(V, D2);
+   eval_multiply(V, Q2);
+   eval_add(V, t);
+   eval_multiply(T, Q2);
+   eval_left_shift(T2, p);
+   eval_add(T, T2);
+   eval_multiply(C, D2);
+   eval_multiply(C2, D);
+   eval_add(C, C2);
+   eval_multiply(Q, Q2);
+   eval_multiply(D, D2);
+   p += p2;
+}
+
+template <class T>
+bool calc_euler_binary_split(T&, unsigned, void*)
+{
+   return false;
+}
+
+template <class T, class Int>
+bool calc_euler_binary_split(T& result, unsigned digits, Int*)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, Int>::type ui_type;
+   //
+   // e^(-4n) < 2^-(digits + 64):
+   //
+   unsigned m = 0;
+   while((1uL << m) < (digits + 64) * 0.1733 + 1)
+      ++m;
+   unsigned n = 1u << m;
+   unsigned p;
+   Int Q, S, D, C, V;
+   eval_euler_split(Q, S, D, C, V, p, m, 0, static_cast<unsigned>(3.5912 * n) + 2);
+   //
+   // gamma = V / (D S) - 3m L / 4Q, where L / Q is the log(2) series, as a single ratio so that
+   // subtracting ln(n) loses nothing:
+   //
+   Int P, L, num;
+   eval_binary_split(P, Q, L, log2_series(), 0, (digits + 64) / 3 + 2, false);
+   eval_multiply(D, S);
+   eval_multiply(L, static_cast<ui_type>(3u * m));
+   eval_multiply(L, D);
+   eval_multiply(Q, static_cast<ui_type>(4u));
+   eval_multiply(num, V, Q);
+   eval_subtract(num, L);
+   eval_multiply(D, Q);
+   eval_integer_ratio(result, num, D, digits);
+   return true;
+}
+
 template <class T>
 void calc_log2(T& num, unsigned digits)
 {
@@ -36,6 +413,11 @@ void calc_log2(T& num, unsigned digits)
       return;
    }
    //
+   // By binary splitting if there is an integer type to do it in:
+   //
+   if(calc_log2_binary_split(num, digits, static_cast<typename boost::multiprecision::detail::binary_splitting_integer<T>::type*>(0)))
+      return;
+   //
    // We calculate log2 from using the formula:
    //
    // ln(2) = 3/4 SUM[n>=0] ((-1)^n * N!^2 / (2^n(2n+1)!))
@@ -64,7 +446,7 @@ void calc_log2(T& num, unsigned digits)
       eval_multiply(denom, temp);
       sign = -sign;
       eval_multiply(next_term, n);
-      eval_multiply(temp, next_term, next_term);
+      eval_square(temp, next_term);
       if(sign < 0)
          temp.negate();
       eval_add(num, temp);
@@ -104,6 +486,8 @@ void calc_e(T& result, unsigned digits)
       result = string_val;
       return;
    }
+   if(calc_e_binary_split(result, digits, static_cast<typename boost::multiprecision::detail::binary_splitting_integer<T>::type*>(0)))
+      return;
 
    T lim;
    lim = ui_type(1);
@@ -153,6 +537,8 @@ void calc_pi(T& result, unsigned digits)
       result = string_val;
       return;
    }
+   if(calc_pi_binary_split(result, digits, static_cast<typename boost::multiprecision::detail::binary_splitting_integer<T>::type*>(0)))
+      return;
 
    T a;
    a = ui_type(1);
@@ -195,7 +581,7 @@ void calc_pi(T& result, unsigned digits)
       eval_sqrt(b, B);
       eval_add(a, b);
       eval_ldexp(a, a, -1);
-      eval_multiply(A, a, a);
+      eval_square(A, a);
       eval_subtract(B, A, result);
       eval_ldexp(B, B, 1);
       eval_subtract(result, A, B);
@@ -216,6 +602,67 @@ void calc_pi(T& result, unsigned digits)
    eval_divide(result, B, D);
 }
 
+template <class T>
+void calc_euler(T& result, unsigned digits)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   //
+   // 1100 digits in string form:
+   //
+   const char* string_val = "0."
+         "5772156649015328606065120900824024310421593359399235988057672348848677267776646709369470632917467495"
+         "1463144724980708248096050401448654283622417399764492353625350033374293733773767394279259525824709491"
+         "6008735203948165670853233151776611528621199501507984793745085705740029921354786146694029604325421519"
+         "0587755352673313992540129674205137541395491116851028079842348775872050384310939973613725530608893312"
+         "6760017247953783675927135157722610273492913940798430103417771778088154957066107501016191663340152278"
+         "9358679654972520362128792265559536696281763887927268013243101047650596370394739495763890657296792960"
+         "1009015125195950922243501409349871228247949747195646976318506676129063811051824197444867836380861749"
+         "4551698927923018773910729457815543160050021828440960537724342032854783670151773943987003023703395183"
+         "2869000155819398804270741154222781971652301107356583396734871765049194181230004065469314299929777956"
+         "9303100503086303418569803231083691640025892970890985486825777364288253954925873629596133298574739302"
+         "3734388470703702844129201664178502487333790805627549984345907616431671031467107223700218107450444186";
+   //
+   // Check if we can just construct from string:
+   //
+   if(digits  < 3640) // 3640 binary digits ~ 1100 decimal digits
+   {
+      result = string_val;
+      return;
+   }
+   if(calc_euler_binary_split(result, digits, static_cast<typename boost::multiprecision::detail::binary_splitting_integer<T>::type*>(0)))
+      return;
+   //
+   // Otherwise sum the same series directly, with A(k) = t(k) (H(k) - ln(n)) and B(k) = t(k):
+   //
+   // A(k) = (A(k-1) n^2 / k + B(k)) / k,  B(k) = B(k-1) n^2 / k^2
+   //
+   unsigned m = 0;
+   while((1uL << m) < digits * 0.1733 + 1)
+      ++m;
+   unsigned n = 1u << m;
+   unsigned limit = static_cast<unsigned>(3.5912 * n) + 2;
+   T A, B, U, V;
+   calc_log2(A, digits);
+   eval_multiply(A, static_cast<ui_type>(m));
+   A.negate();
+   B = static_cast<ui_type>(1u);
+   U = A;
+   V = B;
+   for(unsigned k = 1; k < limit; ++k)
+   {
+      eval_ldexp(B, B, static_cast<int>(2 * m));
+      eval_divide(B, static_cast<ui_type>(k));
+      eval_divide(B, static_cast<ui_type>(k));
+      eval_ldexp(A, A, static_cast<int>(2 * m));
+      eval_divide(A, static_cast<ui_type>(k));
+      eval_add(A, B);
+      eval_divide(A, static_cast<ui_type>(k));
+      eval_add(U, A);
+      eval_add(V, B);
+   }
+   eval_divide(result, U, V);
+}
+
 template <class T, const T& (*F)(void)>
 struct constant_initializer
 {
@@ -295,6 +742,24 @@ const T& get_constant_pi()
    return result;
 }
 
+template <class T>
+const T& get_constant_euler()
+{
+   static BOOST_MP_THREAD_LOCAL T result;
+   static BOOST_MP_THREAD_LOCAL bool b = false;
+   static BOOST_MP_THREAD_LOCAL long digits = boost::multiprecision::detail::digits2<number<T> >::value();
+   if(!b || (digits != boost::multiprecision::detail::digits2<number<T> >::value()))
+   {
+      calc_euler(result, boost::multiprecision::detail::digits2<number<T, et_on> >::value());
+      b = true;
+      digits = boost::multiprecision::detail::digits2<number<T> >::value();
+   }
+
+   constant_initializer<T, &get_constant_euler<T> >::do_nothing();
+
+   return result;
+}
+
 template <class T>
 const T& get_constant_one_over_epsilon()
 {
@@ -49,12 +49,14 @@ inline void pow_imp(T& result, const T& t, const U& p, const mpl::false_&)
    U p2(p);
 
    // The variable x stores the binary powers of t.
-   T x(t);
+   boost::multiprecision::detail::scratch<T, 1> temps;
+   T& x = temps[0];
+   x = t;
 
    while(U(p2 /= 2) != U(0))
    {
       // Square x for each binary power.
-      eval_multiply(x, x);
+      eval_square(x, x);
 
       const bool has_binary_power = (U(p2 % U(2)) != U(0));
 
@@ -93,6 +95,187 @@ inline typename enable_if<is_integral<U> >::type eval_pow(T& result, const T& t,
    detail::pow_imp(result, t, p, boost::is_signed<U>());
 }
 
+namespace detail{
+
+//
+// In all the calls we make, the parameters of the hypergeometric series below are multiples of
+// 1/2, so that the ratio of consecutive terms t(k+1) / (t(k) x) is num(k) / den(k) for small
+// integers num(k) and den(k).  This records twice each of the (at most two) numerator and
+// denominator parameters, the k + 1 from the factorial is implicit:
+//
+struct hyp_series_ratio
+{
+   hyp_series_ratio() : p(0), q(0) {}
+   void add_numerator(boost::long_long_type twice_a) { a[p++] = twice_a; }
+   void add_denominator(boost::long_long_type twice_b) { b[q++] = twice_b; }
+   boost::long_long_type num(unsigned k)const
+   {
+      // Each parameter contributes (A + 2k) / 2, so balance the factors of 2 between num and den:
+      boost::long_long_type r = 1;
+      for(unsigned i = 0; i < p; ++i)
+         r *= a[i] + 2 * static_cast<boost::long_long_type>(k);
+      for(unsigned i = p; i < q; ++i)
+         r *= 2;
+      return r;
+   }
+   boost::long_long_type den(unsigned k)const
+   {
+      boost::long_long_type r = static_cast<boost::long_long_type>(k) + 1;
+      for(unsigned i = 0; i < q; ++i)
+         r *= b[i] + 2 * static_cast<boost::long_long_type>(k);
+      for(unsigned i = q; i < p; ++i)
+         r *= 2;
+      return r;
+   }
+   unsigned p, q;
+   boost::long_long_type a[2], b[2];
+};
+
+//
+// Sets twice_a to 2a and returns true if a is a multiple of 1/2 small enough for hyp_series_ratio:
+//
+template <class T>
+bool is_small_half_integer(const T& a, boost::long_long_type& twice_a)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::int32_t, T>::type si_type;
+   static const si_type limit = 1 << 15;
+
+   T t;
+   eval_add(t, a, a);
+   if((eval_fpclassify(t) != FP_NORMAL) && (eval_fpclassify(t) != FP_ZERO))
+      return false;
+   if((t.compare(limit) > 0) || (t.compare(si_type(-limit)) < 0))
+      return false;
+   eval_convert_to(&twice_a, t);
+   T u;
+   u = static_cast<si_type>(twice_a);
+   return u.compare(t) == 0;
+}
+
+//
+// Multiplies r by num / den:
+//
+template <class T>
+void hyp_series_scale(T& r, boost::long_long_type num, boost::long_long_type den)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   bool neg = (num < 0) != (den < 0);
+   if(num < 0)
+      num = -num;
+   if(den < 0)
+      den = -den;
+   if(num != 1)
+      eval_multiply(r, static_cast<ui_type>(num));
+   if(den != 1)
+      eval_divide(r, static_cast<ui_type>(den));
+   if(neg)
+      r.negate();
+}
+
+//
+// The number of terms m per block when a series of n terms is summed by rectangular splitting,
+// shared with the fixed point version in cpp_bin_float/transcendental.hpp:
+//
+inline unsigned rectangular_block_size(unsigned n)
+{
+   unsigned m = static_cast<unsigned>(std::sqrt(static_cast<double>(n)));
+   return m < 2 ? 2 : m;
+}
+
+//
+// Sets result to the sum of the series whose terms have ratio t(k+1) / t(k) = x num(k) / den(k),
+// with t(0) = 1, summed until the terms fall below the precision of T relative to the sum of the
+// first two, as in the term by term loops of the hypergeometric functions, by rectangular
+// splitting (see eval_rectangular_series in cpp_bin_float/transcendental.hpp).  The number of
+// terms is found up front from the binary exponents of x and of the sum of the first two terms,
+// rounded so as to overestimate it.  Returns false, leaving result unchanged, if the series needs
+// more terms than the term by term loops allow, or num(k) or den(k) do not fit in 32 bits, so
+// that the caller can fall back on those loops:
+//
+template <class T>
+bool hyp_series_sum(T& result, const T& x, const hyp_series_ratio& ratio)
+{
+   typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
+   typedef typename boost::multiprecision::detail::canonical<double, T>::type fp_type;
+   typedef typename T::exponent_type exp_type;
+   static const boost::long_long_type max_factor = 0xFFFFFFFFuLL;
+
+   BOOST_ASSERT(&result != &x);
+   if(eval_fpclassify(x) != FP_NORMAL)
+      return false;
+   const long digits = boost::multiprecision::detail::digits2<number<T, et_on> >::value();
+   const unsigned series_limit = digits < 100 ? 100 : static_cast<unsigned>(digits);
+   //
+   // |x| < 2^log2_x, and the sum of the first two terms is at least 2^(log2_lim + digits - 1):
+   //
+   boost::multiprecision::detail::scratch<T, 1> temps;
+   T& t = temps[0];
+   exp_type e;
+   eval_frexp(t, x, &e);
+   if(eval_get_sign(t) < 0)
+      t.negate();
+   const double log2_x = static_cast<double>(e) - (t.compare(fp_type(0.7071)) < 0 ? 0.5 : 0);
+   if((ratio.num(0) > max_factor) || (ratio.num(0) < -max_factor) || (ratio.den(0) > max_factor) || (ratio.den(0) < -max_factor))
+      return false;
+   t = x;
+   hyp_series_scale(t, ratio.num(0), ratio.den(0));
+   eval_add(t, ui_type(1));
+   if(eval_get_sign(t) == 0)
+      return false;
+   eval_frexp(t, t, &e);
+   const double log2_lim = static_cast<double>(e) - digits;
+   //
+   // Find the number of terms n:
+   //
+   double log2_t = 0;
+   unsigned n = 1;
+   for(;;)
+   {
+      boost::long_long_type nk = ratio.num(n - 1);
+      boost::long_long_type dk = ratio.den(n - 1);
+      if((dk == 0) || (nk > max_factor) || (nk < -max_factor) || (dk > max_factor) || (dk < -max_factor))
+         return false;
+      if(nk == 0)
+         break;
+      log2_t += log2_x + std::log(std::fabs(static_cast<double>(nk) / static_cast<double>(dk))) / 0.6931471805599453;
+      if(++n >= series_limit)
+         return false;
+      if(log2_t < log2_lim)
+         break;
+   }
+   const unsigned m = rectangular_block_size(n);
+   const unsigned blocks = (n + m - 1) / m;
+   const unsigned max_power = blocks > 1 ? m : n - 1;
+
+   boost::multiprecision::detail::scratch_array<T> powers(max_power + 1);
+   powers[0] = ui_type(1);
+   if(max_power)
+      powers[1] = x;
+   for(unsigned j = 2; j <= max_power; ++j)
+      eval_multiply(powers[j], powers[j - 1], x);
+
+   bool first = true;
+   for(unsigned b = blocks; b-- > 0;)
+   {
+      if(!first)
+         eval_multiply(result, powers[m]);
+      for(unsigned j = (std::min)(m, n - b * m); j-- > 0;)
+      {
+         if(first)
+         {
+            result = powers[j];
+            first = false;
+            continue;
+         }
+         hyp_series_scale(result, ratio.num(b * m + j), ratio.den(b * m + j));
+         eval_add(result, powers[j]);
+      }
+   }
+   return true;
+}
+
+} // namespace detail
+
 template <class T>
 void hyp0F0(T& H0F0, const T& x)
 {
@@ -103,14 +286,18 @@ void hyp0F0(T& H0F0, const T& x)
    typedef typename mpl::front<typename T::unsigned_types>::type ui_type;
 
    BOOST_ASSERT(&H0F0 != &x);
+   if(detail::hyp_series_sum(H0F0, x, detail::hyp_series_ratio()))
+      return;
+
    long tol = boost::multiprecision::detail::digits2<number<T, et_on> >::value();
-   T t;
 
-   T x_pow_n_div_n_fact(x);
+   boost::multiprecision::detail::scratch<T, 2> temps;
+   T& x_pow_n_div_n_fact = temps[0];
+   T& lim                = temps[1];
+   x_pow_n_div_n_fact = x;
 
    eval_add(H0F0, x_pow_n_div_n_fact, ui_type(1));
 
-   T lim;
    eval_ldexp(lim, H0F0, 1 - tol);
    if(eval_get_sign(lim) < 0)
       lim.negate();
@@ -151,19 +338,32 @@ void hyp1F0(T& H1F0, const T& a, const T& x)
    BOOST_ASSERT(&H1F0 != &x);
    BOOST_ASSERT(&H1F0 != &a);
 
-   T x_pow_n_div_n_fact(x);
-   T pochham_a         (a);
-   T ap                (a);
+   boost::long_long_type twice_a;
+   if(detail::is_small_half_integer(a, twice_a))
+   {
+      detail::hyp_series_ratio ratio;
+      ratio.add_numerator(twice_a);
+      if(detail::hyp_series_sum(H1F0, x, ratio))
+         return;
+   }
 
-   eval_multiply(H1F0, pochham_a, x_pow_n_div_n_fact);
-   eval_add(H1F0, si_type(1));
-   T lim;
+   //
+   // Otherwise the coefficients need full precision multiplications anyway, but we can at least
+   // make it one per term: with u = (a + n - 1) x, updated by adding x, term(n) = term(n-1) u / n.
+   //
+   boost::multiprecision::detail::scratch<T, 3> temps;
+   T& u    = temps[0];
+   T& lim  = temps[1];
+   T& term = temps[2];
+   eval_multiply(u, a, x);
+   term = u;
+
+   eval_add(H1F0, term, si_type(1));
    eval_ldexp(lim, H1F0, 1 - boost::multiprecision::detail::digits2<number<T, et_on> >::value());
    if(eval_get_sign(lim) < 0)
       lim.negate();
 
    si_type n;
-   T term, part;
 
    const si_type series_limit =
       boost::multiprecision::detail::digits2<number<T, et_on> >::value() < 100
@@ -171,16 +371,17 @@ void hyp1F0(T& H1F0, const T& a, const T& x)
    // Series expansion of hyperg_1f0(a; ; x).
    for(n = 2; n < series_limit; n++)
    {
-      eval_multiply(x_pow_n_div_n_fact, x);
-      eval_divide(x_pow_n_div_n_fact, n);
-      eval_increment(ap);
-      eval_multiply(pochham_a, ap);
-      eval_multiply(term, pochham_a, x_pow_n_div_n_fact);
+      eval_add(u, x);
+      eval_multiply(term, u);
+      eval_divide(term, n);
       eval_add(H1F0, term);
-      if(eval_get_sign(term) < 0)
+      bool neg = eval_get_sign(term) < 0;
+      if(neg)
          term.negate();
       if(lim.compare(term) >= 0)
          break;
+      if(neg)
+         term.negate();
    }
    if(n >= series_limit)
       BOOST_THROW_EXCEPTION(std::runtime_error("H1F0 failed to converge"));
@@ -226,8 +427,11 @@ void eval_exp(T& result, const T& x)
    }
 
    // Get local copy of argument and force it to be positive.
-   T xx = x;
-   T exp_series;
+   boost::multiprecision::detail::scratch<T, 3> temps;
+   T& xx         = temps[0];
+   T& exp_series = temps[1];
+   T& lim        = temps[2];
+   xx = x;
    if(isneg)
       xx.negate();
 
@@ -237,7 +441,6 @@ void eval_exp(T& result, const T& x)
       //
       // Use series for exp(x) - 1:
       //
-      T lim;
       if(std::numeric_limits<number<T, et_on> >::is_specialized)
          lim = std::numeric_limits<number<T, et_on> >::epsilon().backend();
       else
@@ -372,7 +575,11 @@ void eval_log(T& result, const T& arg)
    }
 
    exp_type e;
-   T t;
+   boost::multiprecision::detail::scratch<T, 4> temps;
+   T& t   = temps[0];
+   T& pow = temps[1];
+   T& lim = temps[2];
+   T& t2  = temps[3];
    eval_frexp(t, arg, &e);
    bool alternate = false;
 
@@ -388,9 +595,7 @@ void eval_log(T& result, const T& arg)
    eval_subtract(t, ui_type(1)); /* -0.3 <= t <= 0.3 */
    if(!alternate)
       t.negate(); /* 0 <= t <= 0.33333 */
-   T pow = t;
-   T lim;
-   T t2;
+   pow = t;
 
    if(alternate)
       eval_add(result, t);
@@ -558,9 +763,13 @@ inline void eval_pow(T& result, const T& x, const T& a)
       return;
    }
 
+   boost::multiprecision::detail::scratch<T, 3> temps;
+   T& t  = temps[0];
+   T& da = temps[1];
+   T& fa = temps[2];
+
    if(s < 0)
    {
-      T t, da;
       t = a;
       t.negate();
       eval_pow(da, x, t);
@@ -579,7 +788,6 @@ inline void eval_pow(T& result, const T& x, const T& a)
       -min_an;
 
 
-   T fa;
 #ifndef BOOST_NO_EXCEPTIONS
    try
    {
@@ -656,8 +864,6 @@ inline void eval_pow(T& result, const T& x, const T& a)
       return;
    }
 
-   T t, da;
-
    eval_subtract(da, a, an);
 
    if((x.compare(fp_type(0.5)) >= 0) && (x.compare(fp_type(0.9)) < 0) && (an < max_an) && (an > min_an))
@@ -27,22 +27,35 @@ void hyp0F1(T& result, const T& b, const T& x)
    // http://functions.wolfram.com/HypergeometricFunctions/Hypergeometric0F1/06/01/01/
    // There are no checks on input range or parameter boundaries.
 
-   T x_pow_n_div_n_fact(x);
-   T pochham_b         (b);
-   T bp                (b);
+   boost::long_long_type twice_b;
+   if(detail::is_small_half_integer(b, twice_b))
+   {
+      detail::hyp_series_ratio ratio;
+      ratio.add_denominator(twice_b);
+      if(detail::hyp_series_sum(result, x, ratio))
+         return;
+   }
+
+   boost::multiprecision::detail::scratch<T, 5> temps;
+   T& x_pow_n_div_n_fact = temps[0];
+   T& pochham_b          = temps[1];
+   T& bp                 = temps[2];
+   T& tol                = temps[3];
+   T& term               = temps[4];
+   x_pow_n_div_n_fact = x;
+   pochham_b          = b;
+   bp                 = b;
 
    eval_divide(result, x_pow_n_div_n_fact, pochham_b);
    eval_add(result, ui_type(1));
 
    si_type n;
 
-   T tol;
    tol = ui_type(1);
    eval_ldexp(tol, tol, 1 - boost::multiprecision::detail::digits2<number<T, et_on> >::value());
    eval_multiply(tol, result);
    if(eval_get_sign(tol) < 0)
       tol.negate();
-   T term;
 
    const int series_limit = 
       boost::multiprecision::detail::digits2<number<T, et_on> >::value() < 100
@@ -105,7 +118,12 @@ void eval_sin(T& result, const T& x)
    }
 
    // Local copy of the argument
-   T xx = x;
+   boost::multiprecision::detail::scratch<T, 4> temps;
+   T& xx   = temps[0];
+   T& n_pi = temps[1];
+   T& t    = temps[2];
+   T& t2   = temps[3];
+   xx = x;
 
    // Analyze and prepare the phase of the argument.
    // Make a local, positive copy of the argument, xx.
@@ -118,7 +136,6 @@ void eval_sin(T& result, const T& x)
       b_negate_sin = !b_negate_sin;
    }
 
-   T n_pi, t;
    // Remove even multiples of pi.
    if(xx.compare(get_constant_pi<T>()) > 0)
    {
@@ -172,9 +189,8 @@ void eval_sin(T& result, const T& x)
    }
    else if(b_near_zero)
    {
-      eval_multiply(t, xx, xx);
+      eval_square(t, xx);
       eval_divide(t, si_type(-4));
-      T t2;
       t2 = fp_type(1.5);
       hyp0F1(result, t2, t);
       BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
@@ -182,9 +198,8 @@ void eval_sin(T& result, const T& x)
    }
    else if(b_near_pi_half)
    {
-      eval_multiply(t, t);
+      eval_square(t, t);
       eval_divide(t, si_type(-4));
-      T t2;
       t2 = fp_type(0.5);
       hyp0F1(result, t2, t);
       BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
@@ -202,9 +217,8 @@ void eval_sin(T& result, const T& x)
       eval_divide(xx, n_three_pow_scale);
 
       // Now with small arguments, we are ready for a series expansion.
-      eval_multiply(t, xx, xx);
+      eval_square(t, xx);
       eval_divide(t, si_type(-4));
-      T t2;
       t2 = fp_type(1.5);
       hyp0F1(result, t2, t);
       BOOST_MATH_INSTRUMENT_CODE(result.str(0, std::ios_base::scientific));
@@ -215,7 +229,7 @@ void eval_sin(T& result, const T& x)
       {
          // Rescale the cosine value using the multiple angle identity.
          eval_multiply(t2, result, ui_type(3));
-         eval_multiply(t, result, result);
+         eval_square(t, result);
          eval_multiply(t, result);
          eval_multiply(t, ui_type(4));
          eval_subtract(result, t2, t);
@@ -261,7 +275,11 @@ void eval_cos(T& result, const T& x)
    }
 
    // Local copy of the argument
-   T xx = x;
+   boost::multiprecision::detail::scratch<T, 3> temps;
+   T& xx   = temps[0];
+   T& n_pi = temps[1];
+   T& t    = temps[2];
+   xx = x;
 
    // Analyze and prepare the phase of the argument.
    // Make a local, positive copy of the argument, xx.
@@ -273,7 +291,6 @@ void eval_cos(T& result, const T& x)
       xx.negate();
    }
 
-   T n_pi, t;
    // Remove even multiples of pi.
    if(xx.compare(get_constant_pi<T>()) > 0)
    {
@@ -335,7 +352,7 @@ void eval_cos(T& result, const T& x)
    }
    else if(b_near_zero)
    {
-      eval_multiply(t, xx, xx);
+      eval_square(t, xx);
       eval_divide(t, si_type(-4));
       n_pi = fp_type(0.5f);
       hyp0F1(result, n_pi, t);
@@ -376,27 +393,46 @@ void hyp2F1(T& result, const T& a, const T& b, const T& c, const T& x)
 
    typedef typename boost::multiprecision::detail::canonical<boost::uint32_t, T>::type ui_type;
 
-   T x_pow_n_div_n_fact(x);
-   T pochham_a         (a);
-   T pochham_b         (b);
-   T pochham_c         (c);
-   T ap                (a);
-   T bp                (b);
-   T cp                (c);
+   boost::long_long_type twice_a, twice_b, twice_c;
+   if(detail::is_small_half_integer(a, twice_a) && detail::is_small_half_integer(b, twice_b) && detail::is_small_half_integer(c, twice_c))
+   {
+      detail::hyp_series_ratio ratio;
+      ratio.add_numerator(twice_a);
+      ratio.add_numerator(twice_b);
+      ratio.add_denominator(twice_c);
+      if(detail::hyp_series_sum(result, x, ratio))
+         return;
+   }
+
+   boost::multiprecision::detail::scratch<T, 9> temps;
+   T& x_pow_n_div_n_fact = temps[0];
+   T& pochham_a          = temps[1];
+   T& pochham_b          = temps[2];
+   T& pochham_c          = temps[3];
+   T& ap                 = temps[4];
+   T& bp                 = temps[5];
+   T& cp                 = temps[6];
+   T& lim                = temps[7];
+   T& term               = temps[8];
+   x_pow_n_div_n_fact = x;
+   pochham_a          = a;
+   pochham_b          = b;
+   pochham_c          = c;
+   ap                 = a;
+   bp                 = b;
+   cp                 = c;
 
    eval_multiply(result, pochham_a, pochham_b);
    eval_divide(result, pochham_c);
    eval_multiply(result, x_pow_n_div_n_fact);
    eval_add(result, ui_type(1));
 
-   T lim;
    eval_ldexp(lim, result, 1 - boost::multiprecision::detail::digits2<number<T, et_on> >::value());
 
    if(eval_get_sign(lim) < 0)
       lim.negate();
 
    ui_type n;
-   T term;
 
    const unsigned series_limit = 
       boost::multiprecision::detail::digits2<number<T, et_on> >::value() < 100
@@ -638,13 +674,17 @@ void eval_atan(T& result, const T& x)
 
    const bool b_neg = eval_get_sign(x) < 0;
 
-   T xx(x);
+   boost::multiprecision::detail::scratch<T, 4> temps;
+   T& xx = temps[0];
+   xx = x;
    if(b_neg)
       xx.negate();
 
    if(xx.compare(fp_type(0.1)) < 0)
    {
-      T t1, t2, t3;
+      T& t1 = temps[1];
+      T& t2 = temps[2];
+      T& t3 = temps[3];
       t1 = ui_type(1);
       t2 = fp_type(0.5f);
       t3 = fp_type(1.5f);
@@ -657,7 +697,9 @@ void eval_atan(T& result, const T& x)
 
    if(xx.compare(fp_type(10)) > 0)
    {
-      T t1, t2, t3;
+      T& t1 = temps[1];
+      T& t2 = temps[2];
+      T& t3 = temps[3];
       t1 = fp_type(0.5f);
       t2 = ui_type(1u);
       t3 = fp_type(1.5f);
@@ -688,7 +730,9 @@ void eval_atan(T& result, const T& x)
    boost::intmax_t current_precision = eval_ilogb(result);
    boost::intmax_t target_precision = current_precision - 1 - (std::numeric_limits<number<T> >::digits * 2) / 3;
 
-   T s, c, t;
+   T& s = temps[1];
+   T& c = temps[2];
+   T& t = temps[3];
    while(current_precision > target_precision)
    {
       eval_sin(s, result);
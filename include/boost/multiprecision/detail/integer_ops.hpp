@@ -125,6 +125,50 @@ inline void eval_lcm(B& result, const B& a, const B& b)
       result.negate();
 }
 
+//
+// Extended Euclidean algorithm: sets g = gcd(a, b) and s, t such that a * s + b * t = g.
+//
+template <class B>
+inline void eval_gcdext(B& g, B& s, B& t, const B& a, const B& b)
+{
+   typedef typename mpl::front<typename B::unsigned_types>::type ui_type;
+   using default_ops::eval_get_sign;
+   using default_ops::eval_is_zero;
+
+   B u(a), v(b), s0, s1, q, r;
+   int a_sign = eval_get_sign(u);
+   if(a_sign < 0)
+      u.negate();
+   if(eval_get_sign(v) < 0)
+      v.negate();
+   s0 = static_cast<ui_type>(a_sign ? 1u : 0u);
+   s1 = static_cast<ui_type>(0u);
+   while(!eval_is_zero(v))
+   {
+      // (u, v) = (v, u % v) and (s0, s1) = (s1, s0 - q * s1):
+      eval_qr(u, v, q, r);
+      u.swap(v);
+      v.swap(r);
+      eval_multiply(q, s1);
+      eval_subtract(s0, q);
+      s0.swap(s1);
+   }
+   if(a_sign < 0)
+      s0.negate();
+   // t = (g - a * s) / b, or 0 when b is 0:
+   if(eval_is_zero(b))
+      r = static_cast<ui_type>(0u);
+   else
+   {
+      eval_multiply(q, a, s0);
+      eval_subtract(r, u, q);
+      eval_divide(r, b);
+   }
+   g.swap(u);
+   s.swap(s0);
+   t.swap(r);
+}
+
 }
 
 template <class Backend, expression_template_option ExpressionTemplates>
@@ -160,6 +204,16 @@ inline typename enable_if_c<number_category<Backend>::value == number_kind_integ
    divide_qr(number<Backend, ExpressionTemplates>(x), number<Backend, ExpressionTemplates>(y), q, r);
 }
 
+template <class Backend, expression_template_option ExpressionTemplates>
+inline typename enable_if_c<number_category<Backend>::value == number_kind_integer>::type 
+   gcdext(const number<Backend, ExpressionTemplates>& a, const number<Backend, ExpressionTemplates>& b,
+   number<Backend, ExpressionTemplates>& g, number<Backend, ExpressionTemplates>& s, number<Backend, ExpressionTemplates>& t)
+{
+   BOOST_STATIC_ASSERT_MSG(is_signed_number<Backend>::value, "gcdext requires a signed type, as the cofactors may be negative.");
+   using default_ops::eval_gcdext;
+   eval_gcdext(g.backend(), s.backend(), t.backend(), a.backend(), b.backend());
+}
+
 template <class Backend, expression_template_option ExpressionTemplates, class Integer>
 inline typename enable_if<mpl::and_<is_integral<Integer>, mpl::bool_<number_category<Backend>::value == number_kind_integer> >, Integer>::type 
    integer_modulus(const number<Backend, ExpressionTemplates>& x, Integer val)
@@ -292,6 +346,7 @@ void eval_powm(Backend& result, const Backend& a, const Backend& p, const Backen
    using default_ops::eval_bit_test;
    using default_ops::eval_get_sign;
    using default_ops::eval_multiply;
+   using default_ops::eval_square;
    using default_ops::eval_modulus;
    using default_ops::eval_right_shift;
 
@@ -300,8 +355,14 @@ void eval_powm(Backend& result, const Backend& a, const Backend& p, const Backen
 
    check_sign_of_backend(p, mpl::bool_<std::numeric_limits<number<Backend> >::is_signed>());
    
-   double_type x, y(a), b(p), t;
+   boost::multiprecision::detail::scratch<double_type, 4> temps;
+   double_type& x = temps[0];
+   double_type& y = temps[1];
+   double_type& b = temps[2];
+   double_type& t = temps[3];
    x = ui_type(1u);
+   y = a;
+   b = p;
 
    while(eval_get_sign(b) > 0)
    {
@@ -310,7 +371,7 @@ void eval_powm(Backend& result, const Backend& a, const Backend& p, const Backen
          eval_multiply(t, x, y);
          eval_modulus(x, t, c);
       }
-      eval_multiply(t, y, y);
+      eval_square(t, y);
       eval_modulus(y, t, c);
       eval_right_shift(b, ui_type(1));
    }
@@ -329,6 +390,7 @@ void eval_powm(Backend& result, const Backend& a, const Backend& p, Integer c)
    using default_ops::eval_bit_test;
    using default_ops::eval_get_sign;
    using default_ops::eval_multiply;
+   using default_ops::eval_square;
    using default_ops::eval_modulus;
    using default_ops::eval_right_shift;
 
@@ -339,8 +401,14 @@ void eval_powm(Backend& result, const Backend& a, const Backend& p, Integer c)
       BOOST_THROW_EXCEPTION(std::runtime_error("powm requires a positive exponent."));
    }
 
-   double_type x, y(a), b(p), t;
+   boost::multiprecision::detail::scratch<double_type, 4> temps;
+   double_type& x = temps[0];
+   double_type& y = temps[1];
+   double_type& b = temps[2];
+   double_type& t = temps[3];
    x = ui_type(1u);
+   y = a;
+   b = p;
 
    while(eval_get_sign(b) > 0)
    {
@@ -349,7 +417,7 @@ void eval_powm(Backend& result, const Backend& a, const Backend& p, Integer c)
          eval_multiply(t, x, y);
          eval_modulus(x, t, static_cast<i1_type>(c));
       }
-      eval_multiply(t, y, y);
+      eval_square(t, y);
       eval_modulus(y, t, static_cast<i1_type>(c));
       eval_right_shift(b, ui_type(1));
    }
@@ -366,11 +434,16 @@ typename enable_if<is_unsigned<Integer> >::type eval_powm(Backend& result, const
    using default_ops::eval_bit_test;
    using default_ops::eval_get_sign;
    using default_ops::eval_multiply;
+   using default_ops::eval_square;
    using default_ops::eval_modulus;
    using default_ops::eval_right_shift;
 
-   double_type x, y(a), t;
+   boost::multiprecision::detail::scratch<double_type, 3> temps;
+   double_type& x = temps[0];
+   double_type& y = temps[1];
+   double_type& t = temps[2];
    x = ui_type(1u);
+   y = a;
 
    while(b > 0)
    {
@@ -379,7 +452,7 @@ typename enable_if<is_unsigned<Integer> >::type eval_powm(Backend& result, const
          eval_multiply(t, x, y);
          eval_modulus(x, t, c);
       }
-      eval_multiply(t, y, y);
+      eval_square(t, y);
       eval_modulus(y, t, c);
       b >>= 1;
    }
@@ -408,11 +481,16 @@ typename enable_if<is_unsigned<Integer1> >::type eval_powm(Backend& result, cons
    using default_ops::eval_bit_test;
    using default_ops::eval_get_sign;
    using default_ops::eval_multiply;
+   using default_ops::eval_square;
    using default_ops::eval_modulus;
    using default_ops::eval_right_shift;
 
-   double_type x, y(a), t;
+   boost::multiprecision::detail::scratch<double_type, 3> temps;
+   double_type& x = temps[0];
+   double_type& y = temps[1];
+   double_type& t = temps[2];
    x = ui_type(1u);
+   y = a;
 
    while(b > 0)
    {
@@ -421,7 +499,7 @@ typename enable_if<is_unsigned<Integer1> >::type eval_powm(Backend& result, cons
          eval_multiply(t, x, y);
          eval_modulus(x, t, static_cast<i1_type>(c));
       }
-      eval_multiply(t, y, y);
+      eval_square(t, y);
       eval_modulus(y, t, static_cast<i1_type>(c));
       b >>= 1;
    }
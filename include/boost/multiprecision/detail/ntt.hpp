@@ -0,0 +1,298 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Number theoretic transform (NTT) multiplication, shared by cpp_int and cpp_dec_float.
+//
+// Values are arrays of "digits" in some base B <= 2^32, least significant digit first.
+// The digits are convolved modulo three NTT-friendly primes, and the exact convolution
+// is recovered with the Chinese Remainder Theorem (Garner's algorithm) before carries
+// are propagated in base B.  Each term of the convolution of an a digit value by a b
+// digit value is less than min(a, b) * B^2, and since we support products of at most
+// 2^23 digits (the largest transform supported by all three primes) that's less than
+// 2^22 * 2^64, which is just below the product of the three primes (~7.87e25).
+//
+#ifndef BOOST_MP_DETAIL_NTT_HPP
+#define BOOST_MP_DETAIL_NTT_HPP
+
+#include <boost/cstdint.hpp>
+#include <boost/assert.hpp>
+#include <boost/static_assert.hpp>
+#include <vector>
+#include <algorithm>
+
+namespace boost{ namespace multiprecision{ namespace detail{
+
+//
+// Arithmetic modulo a prime P = k * 2^n + 1 < 2^31 with primitive root 3.  The transforms
+// keep all values in Montgomery form (x * 2^32 mod P) so that modular multiplication needs
+// no division, the constants required are all computed at compile time:
+//
+template <boost::uint32_t P>
+struct ntt_prime
+{
+   // -1/P mod 2^32 by Newton iteration, each step doubles the number of correct bits:
+   static const boost::uint32_t inv0 = P;
+   static const boost::uint32_t inv1 = inv0 * (2u - P * inv0);
+   static const boost::uint32_t inv2 = inv1 * (2u - P * inv1);
+   static const boost::uint32_t inv3 = inv2 * (2u - P * inv2);
+   static const boost::uint32_t inv4 = inv3 * (2u - P * inv3);
+   static const boost::uint32_t neg_inv = 0u - inv4;
+   // 2^32 mod P and 2^64 mod P:
+   static const boost::uint32_t r1 = static_cast<boost::uint32_t>((static_cast<boost::uint64_t>(1u) << 32) % P);
+   static const boost::uint32_t r2 = static_cast<boost::uint32_t>(static_cast<boost::uint64_t>(r1) * r1 % P);
+
+   static boost::uint32_t redc(boost::uint64_t t)
+   {
+      boost::uint32_t m = static_cast<boost::uint32_t>(t) * neg_inv;
+      boost::uint32_t u = static_cast<boost::uint32_t>((t + static_cast<boost::uint64_t>(m) * P) >> 32);
+      return u >= P ? u - P : u;
+   }
+   static boost::uint32_t add(boost::uint32_t a, boost::uint32_t b)
+   {
+      boost::uint32_t r = a + b;
+      return r >= P ? r - P : r;
+   }
+   static boost::uint32_t subtract(boost::uint32_t a, boost::uint32_t b)
+   {
+      return a >= b ? a - b : a + P - b;
+   }
+   // Montgomery product, a * b / 2^32 mod P:
+   static boost::uint32_t multiply(boost::uint32_t a, boost::uint32_t b)
+   {
+      return redc(static_cast<boost::uint64_t>(a) * b);
+   }
+   static boost::uint32_t to_montgomery(boost::uint32_t a)
+   {
+      return multiply(a % P, r2);
+   }
+   static boost::uint32_t from_montgomery(boost::uint32_t a)
+   {
+      return redc(a);
+   }
+   // a^e with both a and the result in Montgomery form:
+   static boost::uint32_t pow(boost::uint32_t a, boost::uint64_t e)
+   {
+      boost::uint32_t r = r1;
+      while(e)
+      {
+         if(e & 1u)
+            r = multiply(r, a);
+         a = multiply(a, a);
+         e >>= 1;
+      }
+      return r;
+   }
+   static boost::uint32_t inverse(boost::uint32_t a)
+   {
+      return pow(a, P - 2);
+   }
+   //
+   // Plain modular arithmetic on values which are not in Montgomery form:
+   //
+   static boost::uint32_t multiply_plain(boost::uint32_t a, boost::uint32_t b)
+   {
+      return static_cast<boost::uint32_t>(static_cast<boost::uint64_t>(a) * b % P);
+   }
+   static boost::uint32_t inverse_plain(boost::uint32_t a)
+   {
+      return from_montgomery(inverse(to_montgomery(a)));
+   }
+   //
+   // Fills in the table of roots of unity used by the transforms: the roots for the
+   // butterflies of span h are stored contiguously at [h, 2h), so the table has n entries.
+   // When "invert" is set the table is for the inverse transform:
+   //
+   static void make_roots(std::vector<boost::uint32_t>& table, std::size_t n, bool invert)
+   {
+      BOOST_ASSERT((P - 1) % n == 0);
+      table.resize((std::max)(n, static_cast<std::size_t>(2u)));
+      std::size_t half = n / 2;
+      if(half)
+      {
+         boost::uint32_t w = pow(to_montgomery(3), (P - 1) / n);
+         if(invert)
+            w = inverse(w);
+         table[half] = r1;
+         for(std::size_t i = 1; i < half; ++i)
+            table[half + i] = multiply(table[half + i - 1], w);
+         for(std::size_t h = half / 2; h; h /= 2)
+         {
+            for(std::size_t i = 0; i < h; ++i)
+               table[h + i] = table[2 * (h + i)];
+         }
+      }
+   }
+   //
+   // In place forward transform of the n = 2^k values in a (decimation in frequency),
+   // the output is in bit reversed order, which doesn't matter as we only multiply
+   // pointwise before transforming back:
+   //
+   static void transform(boost::uint32_t* a, std::size_t n, const boost::uint32_t* roots)
+   {
+      BOOST_ASSERT((n & (n - 1)) == 0);
+      for(std::size_t half = n / 2; half; half >>= 1)
+      {
+         const boost::uint32_t* w = roots + half;
+         for(std::size_t i = 0; i < n; i += 2 * half)
+         {
+            boost::uint32_t* p = a + i;
+            boost::uint32_t* q = p + half;
+            for(std::size_t j = 0; j < half; ++j)
+            {
+               boost::uint32_t u = p[j];
+               boost::uint32_t v = q[j];
+               p[j] = add(u, v);
+               q[j] = multiply(subtract(u, v), w[j]);
+            }
+         }
+      }
+   }
+   //
+   // Inverse transform (decimation in time) taking bit reversed input and producing
+   // output in natural order, including the final scaling by 1/n:
+   //
+   static void inverse_transform(boost::uint32_t* a, std::size_t n, const boost::uint32_t* roots)
+   {
+      BOOST_ASSERT((n & (n - 1)) == 0);
+      for(std::size_t half = 1; half < n; half <<= 1)
+      {
+         const boost::uint32_t* w = roots + half;
+         for(std::size_t i = 0; i < n; i += 2 * half)
+         {
+            boost::uint32_t* p = a + i;
+            boost::uint32_t* q = p + half;
+            for(std::size_t j = 0; j < half; ++j)
+            {
+               boost::uint32_t u = p[j];
+               boost::uint32_t v = multiply(q[j], w[j]);
+               p[j] = add(u, v);
+               q[j] = subtract(u, v);
+            }
+         }
+      }
+      boost::uint32_t scale = inverse(to_montgomery(static_cast<boost::uint32_t>(n % P)));
+      for(std::size_t i = 0; i < n; ++i)
+         a[i] = multiply(a[i], scale);
+   }
+   //
+   // Sets r to the cyclic convolution of a and b modulo P, where a has an digits,
+   // b has bn digits and n is the transform length.  When "square" is set b is ignored.
+   // The result is returned in normal (not Montgomery) form:
+   //
+   static void convolve(std::vector<boost::uint32_t>& r, const boost::uint32_t* a, std::size_t an, const boost::uint32_t* b, std::size_t bn, std::size_t n, bool square)
+   {
+      std::vector<boost::uint32_t> roots;
+      make_roots(roots, n, false);
+      r.assign(n, 0);
+      for(std::size_t i = 0; i < an; ++i)
+         r[i] = to_montgomery(a[i]);
+      transform(&r[0], n, &roots[0]);
+      if(square)
+      {
+         for(std::size_t i = 0; i < n; ++i)
+            r[i] = multiply(r[i], r[i]);
+      }
+      else
+      {
+         std::vector<boost::uint32_t> t(n, 0);
+         for(std::size_t i = 0; i < bn; ++i)
+            t[i] = to_montgomery(b[i]);
+         transform(&t[0], n, &roots[0]);
+         for(std::size_t i = 0; i < n; ++i)
+            r[i] = multiply(r[i], t[i]);
+      }
+      make_roots(roots, n, true);
+      inverse_transform(&r[0], n, &roots[0]);
+      for(std::size_t i = 0; i < n; ++i)
+         r[i] = from_montgomery(r[i]);
+   }
+};
+
+static const boost::uint32_t ntt_p1 = 998244353u;   // 119 * 2^23 + 1
+static const boost::uint32_t ntt_p2 = 167772161u;   // 5 * 2^25 + 1
+static const boost::uint32_t ntt_p3 = 469762049u;   // 7 * 2^26 + 1
+//
+// The longest transform we support, the product may have at most this many digits:
+//
+static const std::size_t ntt_max_length = static_cast<std::size_t>(1u) << 23;
+
+inline std::size_t ntt_transform_length(std::size_t digits)
+{
+   std::size_t n = 1;
+   while(n < digits)
+      n <<= 1;
+   return n;
+}
+
+//
+// Sets r to the an + bn digit product of a and b, all of which are stored in base "Base"
+// with the least significant digit first.  r may not overlap a or b, and a and b may
+// be the same array in which case only two forward transforms are performed.
+//
+template <boost::uint64_t Base>
+void ntt_multiply(boost::uint32_t* r, const boost::uint32_t* a, std::size_t an, const boost::uint32_t* b, std::size_t bn)
+{
+   BOOST_STATIC_ASSERT(Base <= (static_cast<boost::uint64_t>(1u) << 32));
+   BOOST_ASSERT(an + bn <= ntt_max_length);
+
+   const bool square = (a == b) && (an == bn);
+   const std::size_t n = ntt_transform_length(an + bn - 1);
+
+   std::vector<boost::uint32_t> c1, c2, c3;
+   ntt_prime<ntt_p1>::convolve(c1, a, an, b, bn, n, square);
+   ntt_prime<ntt_p2>::convolve(c2, a, an, b, bn, n, square);
+   ntt_prime<ntt_p3>::convolve(c3, a, an, b, bn, n, square);
+   //
+   // Constants for Garner's algorithm:
+   //
+   static const boost::uint32_t inv_p1_mod_p2 = ntt_prime<ntt_p2>::inverse_plain(ntt_p1 % ntt_p2);
+   static const boost::uint32_t inv_p1p2_mod_p3 = ntt_prime<ntt_p3>::inverse_plain(ntt_prime<ntt_p3>::multiply_plain(ntt_p1 % ntt_p3, ntt_p2 % ntt_p3));
+   //
+   // The carry is a 96-bit value held in 3 32-bit words, least significant first:
+   //
+   boost::uint32_t carry[3] = { 0, 0, 0 };
+   const std::size_t rn = an + bn;
+   for(std::size_t i = 0; i < rn; ++i)
+   {
+      if(i < n)
+      {
+         //
+         // Recover the coefficient x = v1 + p1 * (v2 + p2 * v3):
+         //
+         boost::uint32_t v1 = c1[i];
+         boost::uint32_t v2 = ntt_prime<ntt_p2>::multiply_plain(ntt_prime<ntt_p2>::subtract(c2[i], v1 % ntt_p2), inv_p1_mod_p2);
+         boost::uint32_t x3 = ntt_prime<ntt_p3>::subtract(c3[i], ntt_prime<ntt_p3>::add(v1 % ntt_p3, ntt_prime<ntt_p3>::multiply_plain(v2, ntt_p1 % ntt_p3)));
+         boost::uint32_t v3 = ntt_prime<ntt_p3>::multiply_plain(x3, inv_p1p2_mod_p3);
+         boost::uint64_t y = v2 + static_cast<boost::uint64_t>(ntt_p2) * v3;
+         boost::uint64_t t0 = static_cast<boost::uint64_t>(ntt_p1) * static_cast<boost::uint32_t>(y);
+         boost::uint64_t t1 = static_cast<boost::uint64_t>(ntt_p1) * static_cast<boost::uint32_t>(y >> 32);
+         boost::uint64_t s = static_cast<boost::uint64_t>(carry[0]) + v1 + static_cast<boost::uint32_t>(t0);
+         carry[0] = static_cast<boost::uint32_t>(s);
+         s >>= 32;
+         s += static_cast<boost::uint64_t>(carry[1]) + (t0 >> 32) + static_cast<boost::uint32_t>(t1);
+         carry[1] = static_cast<boost::uint32_t>(s);
+         s >>= 32;
+         s += static_cast<boost::uint64_t>(carry[2]) + (t1 >> 32);
+         BOOST_ASSERT((s >> 32) == 0);
+         carry[2] = static_cast<boost::uint32_t>(s);
+      }
+      //
+      // Output the next digit and divide the carry by Base:
+      //
+      boost::uint64_t rem = 0;
+      for(int j = 2; j >= 0; --j)
+      {
+         boost::uint64_t cur = (rem << 32) | carry[j];
+         carry[j] = static_cast<boost::uint32_t>(cur / Base);
+         rem = cur % Base;
+      }
+      r[i] = static_cast<boost::uint32_t>(rem);
+   }
+   BOOST_ASSERT((carry[0] == 0) && (carry[1] == 0) && (carry[2] == 0));
+}
+
+}}} // namespaces
+
+#endif
@@ -42,6 +42,7 @@
 //
 #if !defined(BOOST_NO_CXX11_THREAD_LOCAL) && !defined(BOOST_INTEL) && !defined(__MINGW32__)
 #  define BOOST_MP_THREAD_LOCAL thread_local
+#  define BOOST_MP_USING_THREAD_LOCAL
 #else
 #  define BOOST_MP_THREAD_LOCAL
 #endif
@@ -266,6 +267,17 @@ struct canonical
    typedef typename canonical_imp<Val, Backend, tag_type>::type type;
 };
 
+//
+// The integer backend used to compute the constants of a floating point backend by binary splitting
+// (see default_ops::calc_pi and friends), or void when there isn't one, in which case they are
+// computed in the floating point type itself:
+//
+template <class Backend>
+struct binary_splitting_integer
+{
+   typedef void type;
+};
+
 struct terminal{};
 struct negate{};
 struct plus{};
@@ -2299,6 +2299,18 @@ struct is_explicitly_convertible<gmp_float<D1>, gmp_float<D2> > : public mpl::tr
 
 #endif
 
+//
+// Temporaries of variable precision types are not reused:
+//
+template <>
+struct is_workspace_enabled<gmp_float<0> > : public mpl::false_ {};
+
+template <unsigned Digits10>
+struct binary_splitting_integer<gmp_float<Digits10> >
+{
+   typedef gmp_int type;
+};
+
 template <>
 struct digits2<number<gmp_float<0>, et_on> >
 {
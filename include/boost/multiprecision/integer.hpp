@@ -8,6 +8,7 @@
 
 #include <boost/multiprecision/cpp_int.hpp>
 #include <boost/multiprecision/detail/bitscan.hpp>
+#include <vector>
 
 namespace boost{
 namespace multiprecision{
@@ -246,6 +247,230 @@ typename enable_if_c<is_integral<Integer>::value, Integer>::type sqrt(const Inte
    return sqrt(x, r);
 }
 
+namespace detail{
+
+template <class Number>
+struct is_cpp_int_modular_context : public mpl::false_ {};
+template <unsigned MinBits, unsigned MaxBits, cpp_integer_type SignType, cpp_int_check_type Checked, class Allocator, expression_template_option ExpressionTemplates>
+struct is_cpp_int_modular_context<number<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator>, ExpressionTemplates> >
+   : public mpl::bool_<!backends::is_trivial_cpp_int<cpp_int_backend<MinBits, MaxBits, SignType, Checked, Allocator> >::value> {};
+
+template <class Number, bool = is_integral<Number>::value>
+struct modular_product_type
+{
+   typedef Number type;
+};
+template <class Number>
+struct modular_product_type<Number, true>
+{
+   typedef typename double_integer<Number>::type type;
+};
+template <class Backend, expression_template_option ExpressionTemplates>
+struct modular_product_type<number<Backend, ExpressionTemplates>, false>
+{
+   typedef number<typename default_ops::double_precision_type<Backend>::type, ExpressionTemplates> type;
+};
+
+//
+// Generic version, residues are just the values reduced modulo m:
+//
+template <class Number, bool is_cpp_int>
+class modular_context_base
+{
+   typedef typename modular_product_type<Number>::type product_type;
+
+   Number m_mod;
+   product_type m_product_mod;
+
+   void make_positive(Number& result, const mpl::true_&)
+   {
+      if(result < 0)
+         result += m_mod;
+   }
+   void make_positive(Number&, const mpl::false_&) {}
+public:
+   explicit modular_context_base(const Number& m) : m_mod(m), m_product_mod(m) {}
+   const Number& modulus()const { return m_mod; }
+   void to_residue(Number& result, const Number& x)
+   {
+      result = x % m_mod;
+      make_positive(result, mpl::bool_<std::numeric_limits<Number>::is_signed>());
+   }
+   void from_residue(Number& result, const Number& x)
+   {
+      result = x;
+   }
+   void mulmod(Number& result, const Number& a, const Number& b)
+   {
+      product_type t;
+      multiply(t, a, b);
+      t %= m_product_mod;
+      result = static_cast<Number>(t);
+   }
+   void sqrmod(Number& result, const Number& a)
+   {
+      mulmod(result, a, a);
+   }
+   void powm(Number& result, const Number& a, const Number& e)
+   {
+      result = static_cast<Number>(boost::multiprecision::powm(a, e, m_mod));
+   }
+};
+//
+// cpp_int version, residues are in Montgomery form for odd m, and all the
+// arithmetic is done in place on the limbs:
+//
+template <class Number>
+class modular_context_base<Number, true>
+{
+   Number m_mod;
+   backends::detail::cpp_int_modulus m_imp;
+   std::vector<limb_type> m_buffer;
+
+   //
+   // Returns the residue x as exactly n limbs, copying to buffer if it's any shorter.  Values
+   // which are negative or longer than m can't be residues, and would overrun the buffer:
+   //
+   const limb_type* residue_limbs(const Number& x, limb_type* buffer)
+   {
+      unsigned xn = x.backend().size();
+      if((xn > m_imp.size()) || (x < 0))
+      {
+         BOOST_THROW_EXCEPTION(std::runtime_error("modular_context arithmetic requires residues in the range [0, m)."));
+      }
+      BOOST_ASSERT(x < m_mod);
+      if(xn == m_imp.size())
+         return x.backend().limbs();
+      std::memcpy(buffer, x.backend().limbs(), xn * sizeof(limb_type));
+      std::memset(buffer + xn, 0, (m_imp.size() - xn) * sizeof(limb_type));
+      return buffer;
+   }
+   void assign(Number& result, const limb_type* p)
+   {
+      result.backend().sign(false);
+      backends::copy_product_result(result.backend(), p, m_imp.size());
+   }
+public:
+   explicit modular_context_base(const Number& m) : m_mod(m), m_imp(m.backend().limbs(), m.backend().size()), m_buffer(3 * m.backend().size()) {}
+   const Number& modulus()const { return m_mod; }
+   void to_residue(Number& result, const Number& x)
+   {
+      limb_type* r = &m_buffer[0];
+      m_imp.to_residue(r, x.backend().limbs(), x.backend().size(), x < 0);
+      assign(result, r);
+   }
+   void from_residue(Number& result, const Number& x)
+   {
+      limb_type* r = &m_buffer[0];
+      m_imp.from_residue(r, residue_limbs(x, r));
+      assign(result, r);
+   }
+   void mulmod(Number& result, const Number& a, const Number& b)
+   {
+      limb_type* r = &m_buffer[0];
+      m_imp.multiply(r, residue_limbs(a, r + m_imp.size()), residue_limbs(b, r + 2 * m_imp.size()));
+      assign(result, r);
+   }
+   void sqrmod(Number& result, const Number& a)
+   {
+      limb_type* r = &m_buffer[0];
+      const limb_type* pa = residue_limbs(a, r + m_imp.size());
+      m_imp.multiply(r, pa, pa);
+      assign(result, r);
+   }
+   void powm(Number& result, const Number& a, const Number& e)
+   {
+      if(e < 0)
+      {
+         BOOST_THROW_EXCEPTION(std::runtime_error("powm requires a positive exponent."));
+      }
+      limb_type* r = &m_buffer[0];
+      m_imp.powm(r, residue_limbs(a, r + m_imp.size()), e.backend().limbs(), e.backend().size());
+      assign(result, r);
+   }
+};
+
+} // namespace detail
+
+//
+// Holds the values precomputed from a modulus m > 0 so that repeated arithmetic modulo m
+// can avoid any further division.  Values must be converted to residues with to_residue
+// before use, and back again with from_residue, all the arithmetic functions both accept
+// and return residues.  For cpp_int these are the values in Montgomery form when m is odd,
+// for other types (or even m) they are simply the values reduced modulo m.  Objects of this
+// type hold their own workspace, so may not be shared between threads.
+//
+template <class Number>
+class modular_context : public detail::modular_context_base<Number, detail::is_cpp_int_modular_context<Number>::value>
+{
+   typedef detail::modular_context_base<Number, detail::is_cpp_int_modular_context<Number>::value> base_type;
+
+   static const Number& check_modulus(const Number& m)
+   {
+      if(m <= 0)
+      {
+         BOOST_THROW_EXCEPTION(std::runtime_error("modular_context requires a positive modulus."));
+      }
+      return m;
+   }
+public:
+   typedef Number number_type;
+
+   explicit modular_context(const Number& m) : base_type(check_modulus(m)) {}
+
+   using base_type::to_residue;
+   using base_type::from_residue;
+   using base_type::mulmod;
+   using base_type::sqrmod;
+   using base_type::powm;
+
+   Number to_residue(const Number& x)
+   {
+      Number result;
+      base_type::to_residue(result, x);
+      return result;
+   }
+   Number from_residue(const Number& x)
+   {
+      Number result;
+      base_type::from_residue(result, x);
+      return result;
+   }
+   //
+   // In place conversion of the values in [first, last):
+   //
+   template <class Iterator>
+   void to_residues(Iterator first, Iterator last)
+   {
+      for(; first != last; ++first)
+         base_type::to_residue(*first, *first);
+   }
+   template <class Iterator>
+   void from_residues(Iterator first, Iterator last)
+   {
+      for(; first != last; ++first)
+         base_type::from_residue(*first, *first);
+   }
+   Number mulmod(const Number& a, const Number& b)
+   {
+      Number result;
+      base_type::mulmod(result, a, b);
+      return result;
+   }
+   Number sqrmod(const Number& a)
+   {
+      Number result;
+      base_type::sqrmod(result, a);
+      return result;
+   }
+   Number powm(const Number& a, const Number& e)
+   {
+      Number result;
+      base_type::powm(result, a, e);
+      return result;
+   }
+};
+
 }} // namespaces
 
 #endif
@@ -526,6 +526,15 @@ using backends::logged_adaptor;
 template<class Backend>
 struct number_category<backends::logged_adaptor<Backend> > : public number_category<Backend> {};
 
+namespace detail{
+
+template<class Backend>
+struct is_workspace_enabled<backends::logged_adaptor<Backend> > : public is_workspace_enabled<Backend> {};
+template<class Backend>
+struct binary_splitting_integer<backends::logged_adaptor<Backend> > : public binary_splitting_integer<Backend> {};
+
+}
+
 }} // namespaces
 
 namespace std{
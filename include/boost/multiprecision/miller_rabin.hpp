@@ -8,132 +8,676 @@
 
 #include <boost/random.hpp>
 #include <boost/multiprecision/integer.hpp>
+#include <vector>
+#include <algorithm>
+#include <climits>
+
+//
+// The largest prime used for trial division before the probable prime tests.  The limit actually used grows
+// with the size of the value tested, up to this bound.  See performance/miller_rabin_performance.cpp for the
+// benchmarks used to choose this value:
+//
+#ifndef BOOST_MP_TRIAL_DIVISION_BOUND
+#  define BOOST_MP_TRIAL_DIVISION_BOUND 65535
+#endif
+
+//
+// The batch primality tests spread their work over multiple threads where std::thread
+// is available, define BOOST_MP_NO_THREADS to always run them on the calling thread:
+//
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) && !defined(BOOST_NO_CXX11_HDR_ATOMIC) && !defined(BOOST_MP_NO_THREADS)
+#  define BOOST_MP_HAS_THREADS
+#  include <thread>
+#  include <atomic>
+#  include <exception>
+#endif
 
 namespace boost{
 namespace multiprecision{
+
+BOOST_STATIC_ASSERT_MSG((BOOST_MP_TRIAL_DIVISION_BOUND >= 227) && (BOOST_MP_TRIAL_DIVISION_BOUND < 65536), "The trial division bound must be at least 227 and less than 2^16.");
+
 namespace detail{
 
-template <class I>
-bool check_small_factors(const I& n)
+inline bool is_small_prime(unsigned n)
 {
-   static const boost::uint32_t small_factors1[] = {
-      3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u };
-   static const boost::uint32_t pp1 = 223092870u;
+   static const unsigned char p[] = 
+   {
+      3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u, 
+      37u, 41u, 43u, 47u, 53u, 59u, 61u, 67u, 71u, 73u, 
+      79u, 83u, 89u, 97u, 101u, 103u, 107u, 109u, 113u, 
+      127u, 131u, 137u, 139u, 149u, 151u, 157u, 163u, 
+      167u, 173u, 179u, 181u, 191u, 193u, 197u, 199u, 
+      211u, 223u, 227u
+   };
+   for(unsigned i = 0; i < sizeof(p) / sizeof(*p); ++i)
+   {
+      if(n == p[i])
+         return true;
+   }
+   return false;
+}
 
-   boost::uint32_t m1 = integer_modulus(n, pp1);
+template <class I>
+typename enable_if_c<is_convertible<I, unsigned>::value, unsigned>::type
+   cast_to_unsigned(const I& val)
+{
+   return static_cast<unsigned>(val);
+}
+template <class I>
+typename disable_if_c<is_convertible<I, unsigned>::value, unsigned>::type
+   cast_to_unsigned(const I& val)
+{
+   return val.template convert_to<unsigned>();
+}
 
-   for(unsigned i = 0; i < sizeof(small_factors1) / sizeof(small_factors1[0]); ++i)
+//
+// The odd primes below 2^16, used for trial division and sieving:
+//
+inline std::vector<unsigned> make_sieve_primes()
+{
+   static const unsigned limit = 1u << 16;
+   std::vector<char> composite(limit);
+   std::vector<unsigned> primes;
+   for(unsigned i = 3; i < limit; i += 2)
    {
-      BOOST_ASSERT(pp1 % small_factors1[i] == 0);
-      if(m1 % small_factors1[i] == 0)
-         return false;
+      if(!composite[i])
+      {
+         primes.push_back(i);
+         for(unsigned j = i * i; j < limit; j += 2 * i)
+            composite[j] = 1;
+      }
    }
+   return primes;
+}
 
-   static const boost::uint32_t small_factors2[] = {
-      29u, 31u, 37u, 41u, 43u, 47u };
-   static const boost::uint32_t pp2 = 2756205443u;
+inline const std::vector<unsigned>& sieve_primes()
+{
+   static const std::vector<unsigned> primes = make_sieve_primes();
+   return primes;
+}
 
-   m1 = integer_modulus(n, pp2);
+//
+// The sieve primes, grouped into products of consecutive primes which each fit in 32 bits, so that
+// trial division needs only one multiprecision remainder per product rather than one per prime:
+//
+struct small_prime_products
+{
+   std::vector<boost::uint32_t> products;
+   // Index in sieve_primes() of the first factor of each product, plus one final entry:
+   std::vector<unsigned> first;
 
-   for(unsigned i = 0; i < sizeof(small_factors2) / sizeof(small_factors2[0]); ++i)
+   small_prime_products()
    {
-      BOOST_ASSERT(pp2 % small_factors2[i] == 0);
-      if(m1 % small_factors2[i] == 0)
-         return false;
+      const std::vector<unsigned>& primes = sieve_primes();
+      boost::uint64_t p = 1;
+      for(unsigned i = 0; i < primes.size(); ++i)
+      {
+         if(p * primes[i] > (std::numeric_limits<boost::uint32_t>::max)())
+         {
+            products.push_back(static_cast<boost::uint32_t>(p));
+            p = 1;
+         }
+         if(p == 1)
+            first.push_back(i);
+         p *= primes[i];
+      }
+      products.push_back(static_cast<boost::uint32_t>(p));
+      first.push_back(static_cast<unsigned>(primes.size()));
    }
+   //
+   // The number of products needed to cover the primes up to limit:
+   //
+   unsigned count(unsigned limit)const
+   {
+      const std::vector<unsigned>& primes = sieve_primes();
+      unsigned k = 0;
+      while((k < products.size()) && (primes[first[k]] <= limit))
+         ++k;
+      return k;
+   }
+};
 
-   static const boost::uint32_t small_factors3[] = {
-      53u, 59u, 61u, 67u, 71u };
-   static const boost::uint32_t pp3 = 907383479u;
+inline const small_prime_products& get_small_prime_products()
+{
+   static const small_prime_products result;
+   return result;
+}
 
-   m1 = integer_modulus(n, pp3);
+//
+// A product tree over the products of the primes up to BOOST_MP_TRIAL_DIVISION_BOUND: levels[0][j] is the
+// product of the leaf products [j * chunk, (j + 1) * chunk), and levels[k][j] = levels[k-1][2j] * levels[k-1][2j+1].
+// For fixed precision types the tree stops at the first level which would not fit in the type, and is empty when
+// even a single chunk would not fit.  Reducing a large n by the tree from the top down (a remainder tree) replaces
+// most of the single limb divisions of n with the much cheaper multiprecision divisions of the smaller nodes:
+//
+template <class I>
+struct small_prime_product_tree
+{
+   static const unsigned chunk = 8;
+   std::vector<std::vector<I> > levels;
+   unsigned leaves;
 
-   for(unsigned i = 0; i < sizeof(small_factors3) / sizeof(small_factors3[0]); ++i)
+   small_prime_product_tree() : leaves(0)
    {
-      BOOST_ASSERT(pp3 % small_factors3[i] == 0);
-      if(m1 % small_factors3[i] == 0)
+      const small_prime_products& pp = get_small_prime_products();
+      unsigned max_bits = std::numeric_limits<I>::is_bounded ? std::numeric_limits<I>::digits - 1 : UINT_MAX;
+      if(max_bits < 32 * chunk)
+         return;
+      leaves = pp.count(BOOST_MP_TRIAL_DIVISION_BOUND);
+      levels.push_back(std::vector<I>());
+      for(unsigned j = 0; j < leaves; j += chunk)
+      {
+         I p(1);
+         for(unsigned k = j; (k < j + chunk) && (k < leaves); ++k)
+            p *= pp.products[k];
+         levels.back().push_back(p);
+      }
+      while(levels.back().size() > 1)
+      {
+         const std::vector<I>& prev = levels.back();
+         std::vector<I> next;
+         for(unsigned j = 0; j < prev.size(); j += 2)
+         {
+            if(j + 1 == prev.size())
+               next.push_back(prev[j]);
+            else if(msb(prev[j]) + msb(prev[j + 1]) + 2 > max_bits)
+               return;
+            else
+               next.push_back(I(prev[j] * prev[j + 1]));
+         }
+         levels.push_back(next);
+      }
+   }
+   static const small_prime_product_tree& get()
+   {
+      static const small_prime_product_tree result;
+      return result;
+   }
+};
+
+//
+// Calls f(k, r) with r = n mod products[k] for each leaf k in [lo, hi) which lies below the node (level, index),
+// where r_node = n mod the node's product, or n itself.  Stops and returns false as soon as f does:
+//
+template <class I, class F>
+bool small_prime_tree_residues(const small_prime_product_tree<I>& tree, unsigned level, unsigned index, const I& r_node, unsigned lo, unsigned hi, F& f)
+{
+   const small_prime_products& pp = get_small_prime_products();
+   static const unsigned chunk = small_prime_product_tree<I>::chunk;
+   unsigned first = (index * chunk) << level;
+   unsigned last = first + (chunk << level);
+   if((first >= hi) || (last <= lo))
+      return true;
+   const I& product = tree.levels[level][index];
+   I t;
+   const I* r = &r_node;
+   if(*r >= product)
+   {
+      t = *r % product;
+      r = &t;
+   }
+   if(level == 0)
+   {
+      for(unsigned k = (std::max)(first, lo); k < (std::min)(last, hi); ++k)
+      {
+         if(!f(k, integer_modulus(*r, pp.products[k])))
+            return false;
+      }
+      return true;
+   }
+   if(!small_prime_tree_residues(tree, level - 1, 2 * index, *r, lo, hi, f))
+      return false;
+   if(2 * index + 1 < tree.levels[level - 1].size())
+      return small_prime_tree_residues(tree, level - 1, 2 * index + 1, *r, lo, hi, f);
+   return true;
+}
+
+//
+// Calls f(k, n mod products[k]) for each k in [0, count), stopping early if f returns false.  The first few
+// products are done directly, as they are the most likely to reveal a factor, and the remainder tree is used
+// for the rest when n is large enough to benefit:
+//
+template <class I, class F>
+bool for_each_small_prime_residue(const I& n, unsigned count, F& f)
+{
+   const small_prime_products& pp = get_small_prime_products();
+   static const unsigned direct = 12;  // covers the primes up to 263
+   static const unsigned tree_min_bits = 1024;
+   unsigned k = 0;
+   for(; (k < count) && (k < direct); ++k)
+   {
+      if(!f(k, integer_modulus(n, pp.products[k])))
+         return false;
+   }
+   if((count > k) && (n != 0) && (msb(n) >= tree_min_bits))
+   {
+      const small_prime_product_tree<I>& tree = small_prime_product_tree<I>::get();
+      unsigned tree_end = (std::min)(count, tree.leaves);
+      if(tree_end > k)
+      {
+         // Reduce from each node of the top level of the tree down:
+         unsigned top = static_cast<unsigned>(tree.levels.size() - 1);
+         for(unsigned j = 0; j < tree.levels[top].size(); ++j)
+         {
+            if(!small_prime_tree_residues(tree, top, j, n, k, tree_end, f))
+               return false;
+         }
+         k = tree_end;
+      }
+   }
+   for(; k < count; ++k)
+   {
+      if(!f(k, integer_modulus(n, pp.products[k])))
          return false;
    }
+   return true;
+}
 
-   static const boost::uint32_t small_factors4[] = {
-      73u, 79u, 83u, 89u, 97u };
-   static const boost::uint32_t pp4 = 4132280413u;
+//
+// Checks the residues of each product for a zero residue modulo any of its prime factors:
+//
+struct small_factor_check
+{
+   unsigned limit;
+   bool operator()(unsigned k, boost::uint32_t r)
+   {
+      const small_prime_products& pp = get_small_prime_products();
+      const std::vector<unsigned>& primes = sieve_primes();
+      for(unsigned i = pp.first[k]; (i < pp.first[k + 1]) && (primes[i] <= limit); ++i)
+      {
+         if(r % primes[i] == 0)
+            return false;
+      }
+      return true;
+   }
+};
 
-   m1 = integer_modulus(n, pp4);
+//
+// The largest prime used for trial division of a value with the given number of bits: larger values make
+// each probable prime test more expensive, so more trial division pays off:
+//
+inline unsigned trial_division_limit(unsigned bits)
+{
+   unsigned limit = bits * 16;
+   if(limit < 227)
+      limit = 227;
+   return limit > BOOST_MP_TRIAL_DIVISION_BOUND ? BOOST_MP_TRIAL_DIVISION_BOUND : limit;
+}
 
-   for(unsigned i = 0; i < sizeof(small_factors4) / sizeof(small_factors4[0]); ++i)
+//
+// Returns false if n has an odd prime factor up to trial_division_limit(msb(n)), other than n itself:
+//
+template <class I>
+bool check_small_factors(const I& n)
+{
+   unsigned limit = trial_division_limit(msb(n));
+   if(n <= limit)
    {
-      BOOST_ASSERT(pp4 % small_factors4[i] == 0);
-      if(m1 % small_factors4[i] == 0)
-         return false;
+      // An odd n this small is either in the table, or has a factor which is:
+      const std::vector<unsigned>& primes = sieve_primes();
+      return std::binary_search(primes.begin(), primes.end(), cast_to_unsigned(n));
    }
+   small_factor_check check = { limit };
+   return for_each_small_prime_residue(n, get_small_prime_products().count(limit), check);
+}
 
-   static const boost::uint32_t small_factors5[6][4] = {
-      { 101u, 103u, 107u, 109u },
-      { 113u, 127u, 131u, 137u },
-      { 139u, 149u, 151u, 157u },
-      { 163u, 167u, 173u, 179u },
-      { 181u, 191u, 193u, 197u },
-      { 199u, 211u, 223u, 227u }
-   };
-   static const boost::uint32_t pp5[6] = 
-   { 
-      121330189u, 
-      113u * 127u * 131u * 137u, 
-      139u * 149u * 151u * 157u,
-      163u * 167u * 173u * 179u,
-      181u * 191u * 193u * 197u,
-      199u * 211u * 223u * 227u
-   };
+//
+// Stores the residue modulo each sieve prime, given the residues of the products:
+//
+struct sieve_residues
+{
+   unsigned* residues;
+   unsigned  count;
+   bool operator()(unsigned k, boost::uint32_t r)
+   {
+      const small_prime_products& pp = get_small_prime_products();
+      const std::vector<unsigned>& primes = sieve_primes();
+      for(unsigned i = pp.first[k]; (i < pp.first[k + 1]) && (i < count); ++i)
+         residues[i] = r % primes[i];
+      return true;
+   }
+};
 
-   for(unsigned k = 0; k < sizeof(pp5) / sizeof(*pp5); ++k)
+//
+// Strong probable prime test to base x, where x, one and minus_one are residues
+// in ctx, and n - 1 = q * 2^k with q odd:
+//
+template <class I>
+bool strong_probable_prime_test(modular_context<I>& ctx, const I& x, const I& q, unsigned k, const I& one, const I& minus_one)
+{
+   I y;
+   ctx.powm(y, x, q);
+   unsigned j = 0;
+   while(true)
    {
-      m1 = integer_modulus(n, pp5[k]);
+      if(y == minus_one)
+         return true;
+      if(y == one)
+         return j == 0;
+      if(++j == k)
+         return false;
+      ctx.sqrmod(y, y);
+   }
+}
 
-      for(unsigned i = 0; i < 4; ++i)
+//
+// Modular addition, subtraction and halving of residues, without forming any
+// value larger than the modulus n, so that fixed precision types cannot overflow:
+//
+template <class I>
+inline void add_residues(I& result, const I& a, const I& b, const I& n)
+{
+   I t(n - b);
+   if(a >= t)
+      result = a - t;
+   else
+      result = a + b;
+}
+template <class I>
+inline void subtract_residues(I& result, const I& a, const I& b, const I& n)
+{
+   if(a >= b)
+      result = a - b;
+   else
+      result = a + I(n - b);
+}
+template <class I>
+inline void halve_residue(I& x, const I& n)
+{
+   // For odd x, (x + n) / 2 as n is odd too:
+   if(bit_test(x, 0))
+   {
+      x >>= 1;
+      x += n >> 1;
+      ++x;
+   }
+   else
+      x >>= 1;
+}
+
+//
+// Jacobi symbol (a/m) for odd m > 0:
+//
+inline int jacobi_symbol(unsigned a, unsigned m)
+{
+   int result = 1;
+   a %= m;
+   while(a)
+   {
+      while((a & 1u) == 0)
       {
-         BOOST_ASSERT(pp5[k] % small_factors5[k][i] == 0);
-         if(m1 % small_factors5[k][i] == 0)
-            return false;
+         a >>= 1;
+         if(((m & 7u) == 3u) || ((m & 7u) == 5u))
+            result = -result;
       }
+      std::swap(a, m);
+      if(((a & 3u) == 3u) && ((m & 3u) == 3u))
+         result = -result;
+      a %= m;
    }
-   return true;
+   return m == 1 ? result : 0;
 }
 
-inline bool is_small_prime(unsigned n)
+//
+// Jacobi symbol (d/n) for small d, and odd n > |d|:
+//
+template <class I>
+int jacobi_symbol(int d, const I& n)
 {
-   static const unsigned char p[] = 
+   unsigned a = d < 0 ? static_cast<unsigned>(-d) : static_cast<unsigned>(d);
+   const unsigned n_mod_8 = integer_modulus(n, 8u);
+   const unsigned n_mod_4 = n_mod_8 & 3u;
+   // (-1/n) = -1 when n = 3 mod 4:
+   int result = (d < 0) && (n_mod_4 == 3u) ? -1 : 1;
+   // Remove factors of 2 from a, (2/n) = -1 when n = 3 or 5 mod 8:
+   while((a & 1u) == 0)
    {
-      3u, 5u, 7u, 11u, 13u, 17u, 19u, 23u, 29u, 31u, 
-      37u, 41u, 43u, 47u, 53u, 59u, 61u, 67u, 71u, 73u, 
-      79u, 83u, 89u, 97u, 101u, 103u, 107u, 109u, 113u, 
-      127u, 131u, 137u, 139u, 149u, 151u, 157u, 163u, 
-      167u, 173u, 179u, 181u, 191u, 193u, 197u, 199u, 
-      211u, 223u, 227u
-   };
-   for(unsigned i = 0; i < sizeof(p) / sizeof(*p); ++i)
-   {
-      if(n == p[i])
-         return true;
+      a >>= 1;
+      if((n_mod_8 == 3u) || (n_mod_8 == 5u))
+         result = -result;
    }
-   return false;
+   // Quadratic reciprocity, (a/n) = (n/a) unless both are 3 mod 4:
+   if(((a & 3u) == 3u) && (n_mod_4 == 3u))
+      result = -result;
+   return result * jacobi_symbol(integer_modulus(n, a), a);
 }
 
 template <class I>
-typename enable_if_c<is_convertible<I, unsigned>::value, unsigned>::type
-   cast_to_unsigned(const I& val)
+bool is_perfect_square(const I& n)
 {
-   return static_cast<unsigned>(val);
+   // Newton iteration for floor(sqrt(n)), starting from above:
+   I x = I(1) << (msb(n) / 2 + 1);
+   while(true)
+   {
+      I y = x + n / x;
+      y >>= 1;
+      if(y >= x)
+         break;
+      x = y;
+   }
+   return x * x == n;
 }
+
+//
+// Strong Lucas probable prime test, with the parameters chosen by Selfridge's method A:
+// D is the first of 5, -7, 9, -11, ... for which (D/n) = -1, then P = 1 and Q = (1 - D) / 4.
+// n must be odd, and have no factors less than 229:
+//
 template <class I>
-typename disable_if_c<is_convertible<I, unsigned>::value, unsigned>::type
-   cast_to_unsigned(const I& val)
+bool strong_lucas_test(modular_context<I>& ctx, const I& n)
 {
-   return val.template convert_to<unsigned>();
+   int d = 5;
+   unsigned tries = 0;
+   while(true)
+   {
+      int j = jacobi_symbol(d, n);
+      if(j < 0)
+         break;
+      if(j == 0)
+         return false;  // d and n have a common factor, and d < n
+      // There is no suitable D when n is a square, so check for that before we search too long:
+      if((++tries == 10) && is_perfect_square(n))
+         return false;
+      d = d > 0 ? -(d + 2) : 2 - d;
+   }
+   int q = (1 - d) / 4;
+   I one, d_res, q_res;
+   ctx.to_residue(one, I(1));
+   ctx.to_residue(d_res, d < 0 ? I(n - static_cast<unsigned>(-d)) : I(static_cast<unsigned>(d)));
+   ctx.to_residue(q_res, q < 0 ? I(n - static_cast<unsigned>(-q)) : I(static_cast<unsigned>(q)));
+   //
+   // n + 1 = e * 2^s with e odd, compute U_e, V_e and Q^e, working from the most
+   // significant bit of e down, with:
+   //
+   // U_2k = U_k * V_k,  V_2k = V_k^2 - 2 Q^k
+   // U_k+1 = (P U_k + V_k) / 2,  V_k+1 = (D U_k + P V_k) / 2
+   //
+   I e(n);
+   ++e;
+   unsigned s = lsb(e);
+   e >>= s;
+   I u(one), v(one), qk(q_res), t;
+   for(unsigned b = msb(e); b-- > 0;)
+   {
+      ctx.mulmod(u, u, v);
+      ctx.sqrmod(v, v);
+      add_residues(t, qk, qk, n);
+      subtract_residues(v, v, t, n);
+      ctx.sqrmod(qk, qk);
+      if(bit_test(e, b))
+      {
+         ctx.mulmod(t, d_res, u);
+         add_residues(u, u, v, n);
+         halve_residue(u, n);
+         add_residues(v, v, t, n);
+         halve_residue(v, n);
+         ctx.mulmod(qk, qk, q_res);
+      }
+   }
+   if(u == 0)
+      return true;
+   for(unsigned r = 0; r < s; ++r)
+   {
+      if(v == 0)
+         return true;
+      ctx.sqrmod(v, v);
+      add_residues(t, qk, qk, n);
+      subtract_residues(v, v, t, n);
+      ctx.sqrmod(qk, qk);
+   }
+   return false;
+}
+
+//
+// Calls f(i) for each i in [0, n), spread over up to "threads" threads, or one thread per
+// hardware thread when threads is zero.  The first exception thrown by f is rethrown here:
+//
+template <class F>
+void parallel_for_each_index(std::size_t n, unsigned threads, F& f)
+{
+#ifdef BOOST_MP_HAS_THREADS
+   if(!threads)
+      threads = std::thread::hardware_concurrency();
+   if(threads > n)
+      threads = static_cast<unsigned>(n);
+   if(threads > 1)
+   {
+      struct worker
+      {
+         F* f;
+         std::size_t n;
+         std::atomic<std::size_t>* next;
+         std::exception_ptr* error;
+         void operator()()
+         {
+            try
+            {
+               for(std::size_t i = (*next)++; i < n; i = (*next)++)
+                  (*f)(i);
+            }
+            catch(...)
+            {
+               *error = std::current_exception();
+               *next = n;  // stop the other threads early
+            }
+         }
+      };
+      std::atomic<std::size_t> next(0);
+      std::vector<std::exception_ptr> errors(threads);
+      std::vector<std::thread> pool;
+      for(unsigned i = 0; i < threads; ++i)
+      {
+         worker w = { &f, n, &next, &errors[i] };
+         pool.push_back(std::thread(w));
+      }
+      for(unsigned i = 0; i < threads; ++i)
+         pool[i].join();
+      for(unsigned i = 0; i < threads; ++i)
+      {
+         if(errors[i])
+            std::rethrow_exception(errors[i]);
+      }
+      return;
+   }
+#else
+   (void)threads;
+#endif
+   for(std::size_t i = 0; i < n; ++i)
+      f(i);
 }
 
 } // namespace detail
 
+//
+// Trial division of the values n, n + step, n + 2 * step, ... by the primes up to some bound.  The residues of
+// the current value modulo each prime are kept, so that moving on to the next value costs one single precision
+// addition per prime, rather than the multiprecision remainders needed to start from scratch:
+//
+template <class I>
+class trial_division_sieve
+{
+public:
+   //
+   // Uses the same bound as the primality tests use for values the size of n:
+   //
+   explicit trial_division_sieve(const I& n)
+      : m_value(n)
+   {
+      init(detail::trial_division_limit(n != 0 ? msb(n) : 0));
+   }
+   trial_division_sieve(const I& n, unsigned bound)
+      : m_value(n)
+   {
+      init(bound);
+   }
+   //
+   // Moves on to the value + step:
+   //
+   trial_division_sieve& operator+=(unsigned step)
+   {
+      const std::vector<unsigned>& primes = detail::sieve_primes();
+      for(unsigned i = 0; i < m_count; ++i)
+      {
+         unsigned p = primes[i];
+         unsigned r = m_residues[i] + (step < p ? step : step % p);
+         m_residues[i] = r >= p ? r - p : r;
+      }
+      m_value += step;
+      return *this;
+   }
+   const I& value()const
+   {
+      return m_value;
+   }
+   unsigned bound()const
+   {
+      return m_bound;
+   }
+   //
+   // Returns true if the current value has a prime factor up to the bound, other than the value itself:
+   //
+   bool has_small_factor()const
+   {
+      if(!bit_test(m_value, 0))
+         return (m_bound >= 2) && (m_value != 2);
+      const std::vector<unsigned>& primes = detail::sieve_primes();
+      for(unsigned i = 0; i < m_count; ++i)
+      {
+         if((m_residues[i] == 0) && (m_value != primes[i]))
+            return true;
+      }
+      return false;
+   }
+   //
+   // The residue of the value modulo the i'th odd prime, for i < the number of odd primes up to the bound:
+   //
+   unsigned residue(unsigned i)const
+   {
+      return m_residues[i];
+   }
+
+private:
+   void init(unsigned bound)
+   {
+      if(bound >= (1u << 16))
+         BOOST_THROW_EXCEPTION(std::domain_error("The trial division bound must be less than 2^16."));
+      m_bound = bound;
+      const std::vector<unsigned>& primes = detail::sieve_primes();
+      m_count = static_cast<unsigned>(std::upper_bound(primes.begin(), primes.end(), bound) - primes.begin());
+      m_residues.resize(m_count);
+      if(m_count)
+      {
+         detail::sieve_residues store = { &m_residues[0], m_count };
+         detail::for_each_small_prime_residue(m_value, detail::get_small_prime_products().count(bound), store);
+      }
+   }
+
+   I                     m_value;
+   unsigned              m_bound, m_count;
+   std::vector<unsigned> m_residues;
+};
+
 template <class I, class Engine>
 typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type 
    miller_rabin_test(const I& n, unsigned trials, Engine& gen)
@@ -156,11 +700,18 @@ typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::ty
 
    number_type nm1 = n - 1;
    //
+   // All the arithmetic is done on residues modulo n, so that the modulus
+   // related setup is done just once for all the trials:
+   //
+   modular_context<number_type> ctx(n);
+   number_type one = ctx.to_residue(number_type(1));
+   number_type minus_one = ctx.to_residue(nm1);
+   //
    // Begin with a single Fermat test - it excludes a lot of candidates:
    //
-   number_type q(228), x, y; // We know n is greater than this, as we've excluded small factors
-   x = powm(q, nm1, n);
-   if(x != 1u)
+   number_type q(228), x; // We know n is greater than this, as we've excluded small factors
+   ctx.powm(x, ctx.to_residue(q), nm1);
+   if(x != one)
       return false;
 
    q = n - 1;
@@ -174,23 +725,9 @@ typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::ty
    //
    for(unsigned i = 0; i < trials; ++i)
    {
-      x = dist(gen);
-      y = powm(x, q, n);
-      unsigned j = 0;
-      while(true)
-      {
-         if(y == nm1)
-            break;
-         if(y == 1)
-         {
-            if(j == 0)
-               break;
-            return false; // test failed
-         }
-         if(++j == k)
-            return false; // failed
-         y = powm(y, 2, n);
-      }
+      ctx.to_residue(x, dist(gen));
+      if(!detail::strong_probable_prime_test(ctx, x, q, k, one, minus_one))
+         return false; // test failed
    }
    return true;  // Yeheh! probably prime.
 #ifdef BOOST_MSVC
@@ -206,6 +743,159 @@ typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::ty
    return miller_rabin_test(x, trials, gen);
 }
 
+//
+// Baillie-PSW test: a strong probable prime test to base 2, followed by a strong Lucas
+// test.  No composite number is known to pass both, and there are none below 2^64, so
+// the result is exact for smaller n:
+//
+template <class I>
+typename enable_if_c<number_category<I>::value == number_kind_integer, bool>::type 
+   baillie_psw_test(const I& n)
+{
+   typedef I number_type;
+
+   if(n == 2)
+      return true;
+   if(bit_test(n, 0) == 0)
+      return false;
+   if(n <= 227)
+      return detail::is_small_prime(detail::cast_to_unsigned(n));
+   if(!detail::check_small_factors(n))
+      return false;
+
+   modular_context<number_type> ctx(n);
+   number_type one = ctx.to_residue(number_type(1));
+   number_type minus_one = ctx.to_residue(number_type(n - 1));
+   number_type q(n - 1);
+   unsigned k = lsb(q);
+   q >>= k;
+   if(!detail::strong_probable_prime_test(ctx, ctx.to_residue(number_type(2)), q, k, one, minus_one))
+      return false;
+   return detail::strong_lucas_test(ctx, n);
+}
+
+namespace detail{
+
+template <class I>
+struct baillie_psw_task
+{
+   const I* candidates;
+   char* results;
+   void operator()(std::size_t i)
+   {
+      results[i] = boost::multiprecision::baillie_psw_test(candidates[i]);
+   }
+};
+
+} // namespace detail
+
+//
+// Applies the Baillie-PSW test to each value in [first, last), writing the results to out,
+// the tests are spread over up to "threads" threads, or one per hardware thread when zero:
+//
+template <class ForwardIterator, class OutputIterator>
+OutputIterator baillie_psw_test(ForwardIterator first, ForwardIterator last, OutputIterator out, unsigned threads = 0)
+{
+   typedef typename std::iterator_traits<ForwardIterator>::value_type number_type;
+   std::vector<number_type> candidates(first, last);
+   std::vector<char> results(candidates.size());
+   if(!candidates.empty())
+   {
+      detail::baillie_psw_task<number_type> task = { &candidates[0], &results[0] };
+      detail::parallel_for_each_index(candidates.size(), threads, task);
+   }
+   for(std::size_t i = 0; i < results.size(); ++i)
+      *out++ = results[i] != 0;
+   return out;
+}
+
+//
+// Writes the probable primes in [first, last) to out in increasing order.  Each block of the
+// interval is first sieved by the primes below 2^16, and the survivors are then passed to the
+// Baillie-PSW test, spread over up to "threads" threads, or one per hardware thread when zero:
+//
+template <class I, class OutputIterator>
+typename enable_if_c<number_category<I>::value == number_kind_integer, OutputIterator>::type 
+   find_probable_primes(const I& first, const I& last, OutputIterator out, unsigned threads = 0)
+{
+   typedef I number_type;
+   static const unsigned block_size = 1u << 16;
+   const std::vector<unsigned>& primes = detail::sieve_primes();
+
+   number_type start(first);
+   if(start < 2)
+      start = 2;
+   if((start == 2) && (last > 2))
+   {
+      *out++ = start;
+      ++start;
+   }
+   if(!bit_test(start, 0))
+      ++start;
+   if(start >= last)
+      return out;
+   std::vector<char> composite;
+   std::vector<number_type> candidates;
+   std::vector<char> results;
+   // The residues of base modulo each prime are updated as we go, rather than recalculated for each block:
+   trial_division_sieve<number_type> sieve(start, (1u << 16) - 1);
+   while(sieve.value() < last)
+   {
+      const number_type& base = sieve.value();
+      // Sieve the odd values base, base + 2, ... base + 2 * (len - 1):
+      number_type remaining(last - base);
+      unsigned len = remaining > 2 * block_size ? block_size : (detail::cast_to_unsigned(remaining) + 1) / 2;
+      composite.assign(len, 0);
+      for(unsigned i = 0; i < primes.size(); ++i)
+      {
+         unsigned p = primes[i];
+         std::size_t j;
+         if(base <= p)
+         {
+            // Don't strike out p itself, start from p^2 instead:
+            j = (static_cast<std::size_t>(p) * p - detail::cast_to_unsigned(base)) / 2;
+         }
+         else
+         {
+            // Offset of the first odd multiple of p which is at least base:
+            unsigned r = sieve.residue(i);
+            j = r ? p - r : 0;
+            if(j & 1u)
+               j += p;
+            j /= 2;
+         }
+         for(; j < len; j += p)
+            composite[j] = 1;
+      }
+      candidates.clear();
+      for(unsigned i = 0; i < len; ++i)
+      {
+         if(!composite[i])
+            candidates.push_back(number_type(base + 2 * i));
+      }
+      results.assign(candidates.size(), 0);
+      if(!candidates.empty())
+      {
+         detail::baillie_psw_task<number_type> task = { &candidates[0], &results[0] };
+         detail::parallel_for_each_index(candidates.size(), threads, task);
+      }
+      for(std::size_t i = 0; i < candidates.size(); ++i)
+      {
+         if(results[i])
+            *out++ = candidates[i];
+      }
+      sieve += 2 * len;
+   }
+   return out;
+}
+
+template <class tag, class Arg1, class Arg2, class Arg3, class Arg4>
+bool baillie_psw_test(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n)
+{
+   typedef typename detail::expression<tag, Arg1, Arg2, Arg3, Arg4>::result_type number_type;
+   return baillie_psw_test(number_type(n));
+}
+
 template <class tag, class Arg1, class Arg2, class Arg3, class Arg4, class Engine>
 bool miller_rabin_test(const detail::expression<tag, Arg1, Arg2, Arg3, Arg4> & n, unsigned trials, Engine& gen)
 {
@@ -1086,16 +1086,23 @@ void generic_interconvert(To& to, const mpfi_float_backend<D>& from, const mpl::
 
 } // namespace backends
 
-#ifdef BOOST_NO_SFINAE_EXPR
-
 namespace detail{
 
+#ifdef BOOST_NO_SFINAE_EXPR
+
 template<unsigned D1, unsigned D2>
 struct is_explicitly_convertible<backends::mpfi_float_backend<D1>, backends::mpfi_float_backend<D2> > : public mpl::true_ {};
 
-}
 #endif
 
+//
+// Temporaries of variable precision types are not reused:
+//
+template<>
+struct is_workspace_enabled<backends::mpfi_float_backend<0> > : public mpl::false_ {};
+
+}
+
 template<>
 struct number_category<detail::canonical<mpfi_t, backends::mpfi_float_backend<0> >::type> : public mpl::int_<number_kind_floating_point>{};
 template <unsigned Digits10>
@@ -1526,17 +1526,23 @@ inline std::size_t hash_value(const mpfr_float_backend<Digits10, AllocateType>&
 
 } // namespace backends
 
-#ifdef BOOST_NO_SFINAE_EXPR
-
 namespace detail{
 
+#ifdef BOOST_NO_SFINAE_EXPR
+
 template<unsigned D1, unsigned D2, mpfr_allocation_type A1, mpfr_allocation_type A2>
 struct is_explicitly_convertible<backends::mpfr_float_backend<D1, A1>, backends::mpfr_float_backend<D2, A2> > : public mpl::true_ {};
 
-}
-
 #endif
 
+//
+// Temporaries of variable precision types are not reused:
+//
+template<mpfr_allocation_type A>
+struct is_workspace_enabled<backends::mpfr_float_backend<0, A> > : public mpl::false_ {};
+
+}
+
 template<>
 struct number_category<detail::canonical<mpfr_t, backends::mpfr_float_backend<0> >::type> : public mpl::int_<number_kind_floating_point>{};
 
@@ -0,0 +1,266 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// A size class pool allocator for the limb (or digit) storage of the arbitrary precision backends.
+//
+// Each request is rounded up to a power of two size class, and freed blocks are kept on a per thread
+// free list for that class, so that the temporaries created and destroyed by expression heavy code are
+// recycled without going back to the system allocator.  The free lists are thread local, so there is
+// no locking at all: a block freed by a thread other than the one which allocated it simply joins the
+// freeing thread's list.  Each list holds a bounded number of blocks, anything beyond that, and any
+// request larger than the largest size class, goes straight to ::operator new and ::operator delete.
+//
+#ifndef BOOST_MP_POOL_ALLOCATOR_HPP
+#define BOOST_MP_POOL_ALLOCATOR_HPP
+
+#include <boost/multiprecision/detail/number_base.hpp>
+#include <boost/multiprecision/detail/bitscan.hpp>
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <limits>
+
+//
+// The largest block, in bytes, which is kept for reuse, and the total number of bytes which each
+// thread may keep on each free list:
+//
+#ifndef BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK
+#  define BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK 262144
+#endif
+#ifndef BOOST_MP_POOL_ALLOCATOR_MAX_CACHE
+#  define BOOST_MP_POOL_ALLOCATOR_MAX_CACHE 1048576
+#endif
+
+namespace boost{ namespace multiprecision{
+
+namespace detail{
+
+static const std::size_t pool_min_block = 32;
+
+//
+// The number of size classes, pool_min_block << i for i in [0, pool_class_count):
+//
+template <std::size_t N, std::size_t Block, bool Done = (Block >= N)>
+struct pool_class_count_imp
+{
+   static const unsigned value = 1 + pool_class_count_imp<N, Block * 2>::value;
+};
+template <std::size_t N, std::size_t Block>
+struct pool_class_count_imp<N, Block, true>
+{
+   static const unsigned value = 1;
+};
+
+static const unsigned pool_class_count = pool_class_count_imp<BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK, pool_min_block>::value;
+
+BOOST_STATIC_ASSERT_MSG(BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK >= pool_min_block, "The largest pooled block must be at least 32 bytes.");
+
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+
+struct pool_free_block
+{
+   pool_free_block* next;
+};
+
+//
+// The per thread state, which is trivially constructible and destructible, so that it is still safe to
+// use while other thread local objects are being destroyed:
+//
+struct pool_state
+{
+   pool_free_block* heads[pool_class_count];
+   unsigned         counts[pool_class_count];
+   bool             registered, destroyed;
+};
+
+inline pool_state& get_pool_state()
+{
+   static BOOST_MP_THREAD_LOCAL pool_state state;
+   return state;
+}
+
+inline void release_pool(pool_state& state)
+{
+   for(unsigned i = 0; i < pool_class_count; ++i)
+   {
+      while(state.heads[i])
+      {
+         pool_free_block* p = state.heads[i];
+         state.heads[i] = p->next;
+         ::operator delete(p);
+      }
+      state.counts[i] = 0;
+   }
+}
+
+//
+// Returns the cached blocks to the system when the thread exits, after which blocks bypass the pool:
+//
+struct pool_reaper
+{
+   ~pool_reaper()
+   {
+      pool_state& state = get_pool_state();
+      release_pool(state);
+      state.destroyed = true;
+   }
+};
+
+inline void register_pool_reaper(pool_state& state)
+{
+   static BOOST_MP_THREAD_LOCAL pool_reaper reaper;
+   (void)reaper;
+   state.registered = true;
+}
+
+#endif
+
+//
+// The size class for a block of n bytes, or pool_class_count if the block is too large to pool:
+//
+inline unsigned pool_size_class(std::size_t n)
+{
+   if(n > BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK)
+      return pool_class_count;
+   if(n <= pool_min_block)
+      return 0;
+   // pool_min_block is 2^5:
+   return find_msb(n - 1) - 4;
+}
+
+inline void* pool_allocate(std::size_t n)
+{
+   unsigned c = pool_size_class(n);
+   if(c == pool_class_count)
+      return ::operator new(n);
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+   pool_state& state = get_pool_state();
+   if(pool_free_block* p = state.heads[c])
+   {
+      state.heads[c] = p->next;
+      --state.counts[c];
+      return p;
+   }
+#endif
+   return ::operator new(pool_min_block << c);
+}
+
+inline void pool_deallocate(void* p, std::size_t n)
+{
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+   unsigned c = pool_size_class(n);
+   if(c != pool_class_count)
+   {
+      pool_state& state = get_pool_state();
+      if(!state.destroyed && (state.counts[c] < (std::max)(std::size_t(4), BOOST_MP_POOL_ALLOCATOR_MAX_CACHE / (pool_min_block << c))))
+      {
+         if(!state.registered)
+            register_pool_reaper(state);
+         pool_free_block* b = static_cast<pool_free_block*>(p);
+         b->next = state.heads[c];
+         state.heads[c] = b;
+         ++state.counts[c];
+         return;
+      }
+   }
+#else
+   (void)n;
+#endif
+   ::operator delete(p);
+}
+
+} // namespace detail
+
+//
+// Stateless allocator, all instances are interchangeable:
+//
+template <class T>
+class pool_allocator
+{
+public:
+   typedef T              value_type;
+   typedef T*             pointer;
+   typedef const T*       const_pointer;
+   typedef T&             reference;
+   typedef const T&       const_reference;
+   typedef std::size_t    size_type;
+   typedef std::ptrdiff_t difference_type;
+
+   template <class U>
+   struct rebind
+   {
+      typedef pool_allocator<U> other;
+   };
+
+   pool_allocator() BOOST_NOEXCEPT {}
+   template <class U>
+   pool_allocator(const pool_allocator<U>&) BOOST_NOEXCEPT {}
+
+   pointer allocate(size_type n, const void* = 0)
+   {
+      if(n > max_size())
+         BOOST_THROW_EXCEPTION(std::bad_alloc());
+      return static_cast<pointer>(detail::pool_allocate(n * sizeof(T)));
+   }
+   void deallocate(pointer p, size_type n)
+   {
+      detail::pool_deallocate(p, n * sizeof(T));
+   }
+   size_type max_size()const BOOST_NOEXCEPT
+   {
+      return (std::numeric_limits<size_type>::max)() / sizeof(T);
+   }
+   pointer address(reference x)const BOOST_NOEXCEPT
+   {
+      return &x;
+   }
+   const_pointer address(const_reference x)const BOOST_NOEXCEPT
+   {
+      return &x;
+   }
+   void construct(pointer p, const T& val)
+   {
+      new(static_cast<void*>(p)) T(val);
+   }
+   void destroy(pointer p)
+   {
+      p->~T();
+   }
+};
+
+template <>
+class pool_allocator<void>
+{
+public:
+   typedef void           value_type;
+   typedef void*          pointer;
+   typedef const void*    const_pointer;
+
+   template <class U>
+   struct rebind
+   {
+      typedef pool_allocator<U> other;
+   };
+
+   pool_allocator() BOOST_NOEXCEPT {}
+   template <class U>
+   pool_allocator(const pool_allocator<U>&) BOOST_NOEXCEPT {}
+};
+
+template <class T, class U>
+inline bool operator == (const pool_allocator<T>&, const pool_allocator<U>&) BOOST_NOEXCEPT
+{
+   return true;
+}
+template <class T, class U>
+inline bool operator != (const pool_allocator<T>&, const pool_allocator<U>&) BOOST_NOEXCEPT
+{
+   return false;
+}
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,304 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Reusable storage for the temporaries of the multi-step backend algorithms (exp, log, pow,
+// the trig functions and powm).
+//
+// Rather than constructing and destroying each of its temporaries on every call, an algorithm
+// takes them from the current thread's workspace for its backend type and hands them back on
+// exit, so that an arbitrary precision backend only pays for allocating its storage the first
+// time round.  Temporaries are handed out in strict last in first out order, so nested calls
+// simply take the next ones along.  By default each thread has its own workspace for each
+// backend type, a scoped_workspace object redirects the current thread to one supplied by
+// the caller instead, which may then be inspected, preallocated or released at will.
+//
+// The temporaries hold whatever value they last held, so they must always be assigned to
+// before being read.  Backends whose precision may vary at runtime have no workspace, as a
+// temporary created at one precision may be reused at another.
+//
+#ifndef BOOST_MP_WORKSPACE_HPP
+#define BOOST_MP_WORKSPACE_HPP
+
+#include <boost/multiprecision/detail/number_base.hpp>
+#include <boost/assert.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace boost{ namespace multiprecision{
+
+template <class Backend>
+class workspace;
+
+namespace detail{
+
+//
+// Set to false for backends whose temporaries may not be reused:
+//
+template <class Backend>
+struct is_workspace_enabled : public mpl::true_ {};
+
+//
+// Without thread local storage there is no shared workspace, and the temporaries are plain locals:
+//
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+template <class Backend, unsigned N, bool Enabled = is_workspace_enabled<Backend>::value>
+#else
+template <class Backend, unsigned N, bool Enabled = false>
+#endif
+class scratch;
+
+//
+// As scratch, but with the number of temporaries chosen at runtime:
+//
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+template <class Backend, bool Enabled = is_workspace_enabled<Backend>::value>
+#else
+template <class Backend, bool Enabled = false>
+#endif
+class scratch_array;
+
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+
+//
+// The per thread state, which is trivially destructible so that it is still valid after the
+// default workspace has been destroyed at thread exit:
+//
+template <class Backend>
+struct workspace_state
+{
+   workspace<Backend>* current;
+   bool                destroyed;
+};
+
+template <class Backend>
+inline workspace_state<Backend>& get_workspace_state()
+{
+   static BOOST_MP_THREAD_LOCAL workspace_state<Backend> state;
+   return state;
+}
+
+template <class Backend>
+struct default_workspace;
+
+//
+// The current thread's workspace, or null once the thread's default workspace has gone:
+//
+template <class Backend>
+inline workspace<Backend>* current_workspace()
+{
+   workspace_state<Backend>& state = get_workspace_state<Backend>();
+   if(!state.current && !state.destroyed)
+   {
+      static BOOST_MP_THREAD_LOCAL default_workspace<Backend> w;
+      state.current = &w;
+   }
+   return state.current;
+}
+
+#endif
+
+} // namespace detail
+
+template <class Backend>
+class workspace
+{
+public:
+   workspace() : m_used(0) {}
+   ~workspace()
+   {
+      BOOST_ASSERT(m_used == 0);
+      for(std::size_t i = 0; i < m_items.size(); ++i)
+         delete m_items[i];
+   }
+   //
+   // The number of temporaries held, and the number currently in use:
+   //
+   std::size_t size()const BOOST_NOEXCEPT { return m_items.size(); }
+   std::size_t in_use()const BOOST_NOEXCEPT { return m_used; }
+   //
+   // Creates temporaries until at least n are held:
+   //
+   void reserve(std::size_t n)
+   {
+      m_items.reserve(n);
+      while(m_items.size() < n)
+         m_items.push_back(new Backend());
+   }
+   //
+   // Destroys the temporaries which are not currently in use:
+   //
+   void shrink()
+   {
+      for(std::size_t i = m_used; i < m_items.size(); ++i)
+         delete m_items[i];
+      m_items.resize(m_used);
+   }
+private:
+   workspace(const workspace&);
+   workspace& operator=(const workspace&);
+
+   //
+   // Sets p[0..n) to the next n temporaries, all of which are created first so that
+   // nothing is handed out if that fails:
+   //
+   void acquire(Backend** p, std::size_t n)
+   {
+      reserve(m_used + n);
+      for(std::size_t i = 0; i < n; ++i)
+         p[i] = m_items[m_used + i];
+      m_used += n;
+   }
+   void release(std::size_t n) BOOST_NOEXCEPT
+   {
+      BOOST_ASSERT(n <= m_used);
+      m_used -= n;
+   }
+
+   template <class B, unsigned N, bool E>
+   friend class detail::scratch;
+   template <class B, bool E>
+   friend class detail::scratch_array;
+
+   std::vector<Backend*> m_items;
+   std::size_t           m_used;
+};
+
+//
+// Makes w the current thread's workspace for Backend for the lifetime of this object:
+//
+template <class Backend>
+class scoped_workspace
+{
+public:
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+   explicit scoped_workspace(workspace<Backend>& w) : m_previous(detail::get_workspace_state<Backend>().current)
+   {
+      detail::get_workspace_state<Backend>().current = &w;
+   }
+   ~scoped_workspace()
+   {
+      detail::get_workspace_state<Backend>().current = m_previous;
+   }
+#else
+   explicit scoped_workspace(workspace<Backend>&) {}
+#endif
+private:
+   scoped_workspace(const scoped_workspace&);
+   scoped_workspace& operator=(const scoped_workspace&);
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+   workspace<Backend>* m_previous;
+#endif
+};
+
+namespace detail{
+
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+
+template <class Backend>
+struct default_workspace : public workspace<Backend>
+{
+   ~default_workspace()
+   {
+      workspace_state<Backend>& state = get_workspace_state<Backend>();
+      if(state.current == this)
+         state.current = 0;
+      state.destroyed = true;
+   }
+};
+
+//
+// N temporaries taken from the current workspace, or from a private one when there is none:
+//
+template <class Backend, unsigned N, bool Enabled>
+class scratch
+{
+public:
+   scratch() : m_workspace(current_workspace<Backend>())
+   {
+      if(!m_workspace)
+         m_workspace = &m_local;
+      m_workspace->acquire(m_values, N);
+   }
+   ~scratch()
+   {
+      m_workspace->release(N);
+   }
+   Backend& operator[](unsigned i) BOOST_NOEXCEPT
+   {
+      BOOST_ASSERT(i < N);
+      return *m_values[i];
+   }
+private:
+   scratch(const scratch&);
+   scratch& operator=(const scratch&);
+
+   workspace<Backend>* m_workspace;
+   workspace<Backend>  m_local;
+   Backend*            m_values[N];
+};
+
+template <class Backend, bool Enabled>
+class scratch_array
+{
+public:
+   explicit scratch_array(std::size_t n) : m_workspace(current_workspace<Backend>()), m_values(n)
+   {
+      if(!m_workspace)
+         m_workspace = &m_local;
+      if(n)
+         m_workspace->acquire(&m_values[0], n);
+   }
+   ~scratch_array()
+   {
+      m_workspace->release(m_values.size());
+   }
+   Backend& operator[](std::size_t i) BOOST_NOEXCEPT
+   {
+      BOOST_ASSERT(i < m_values.size());
+      return *m_values[i];
+   }
+private:
+   scratch_array(const scratch_array&);
+   scratch_array& operator=(const scratch_array&);
+
+   workspace<Backend>*   m_workspace;
+   workspace<Backend>    m_local;
+   std::vector<Backend*> m_values;
+};
+
+#endif
+
+template <class Backend, unsigned N>
+class scratch<Backend, N, false>
+{
+public:
+   Backend& operator[](unsigned i) BOOST_NOEXCEPT
+   {
+      BOOST_ASSERT(i < N);
+      return m_values[i];
+   }
+private:
+   Backend m_values[N];
+};
+
+template <class Backend>
+class scratch_array<Backend, false>
+{
+public:
+   explicit scratch_array(std::size_t n) : m_values(n) {}
+   Backend& operator[](std::size_t i) BOOST_NOEXCEPT
+   {
+      BOOST_ASSERT(i < m_values.size());
+      return m_values[i];
+   }
+private:
+   std::vector<Backend> m_values;
+};
+
+} // namespace detail
+
+}} // namespaces
+
+#endif
@@ -0,0 +1,247 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compares cpp_int using std::allocator with cpp_int_pooled on expression heavy code which
+// creates and destroys many temporaries, and reports how many allocations each operation makes.
+// Then does the same for cpp_dec_float with std::allocator, pool_allocator and no allocator.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+static unsigned long allocation_count = 0;
+
+//
+// std::allocator, counting each allocation:
+//
+template <class T>
+struct counting_allocator : public std::allocator<T>
+{
+   template <class U>
+   struct rebind
+   {
+      typedef counting_allocator<U> other;
+   };
+   counting_allocator() {}
+   template <class U>
+   counting_allocator(const counting_allocator<U>&) {}
+   T* allocate(std::size_t n, const void* = 0)
+   {
+      ++allocation_count;
+      return std::allocator<T>::allocate(n);
+   }
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+//
+// One step of each workload, on values of roughly equal size:
+//
+template <class T>
+void horner(const std::vector<T>& v, T& result)
+{
+   // Polynomial evaluation, reduced by the last value to keep the size constant:
+   result = v[0];
+   for(unsigned i = 1; i < v.size() - 1; ++i)
+      result = (result * v[v.size() - 1] + v[i]) % v[v.size() - 2];
+}
+template <class T>
+void mixed(const std::vector<T>& v, T& result)
+{
+   // Sums of products, as in a dot product or determinant:
+   result = 0;
+   for(unsigned i = 0; i + 3 < v.size(); ++i)
+      result += v[i] * v[i + 1] - v[i + 2] * v[i + 3];
+}
+template <class T>
+void divide(const std::vector<T>& v, T& result)
+{
+   // Quotients and remainders, each creating several temporaries:
+   result = 0;
+   for(unsigned i = 0; i + 1 < v.size(); ++i)
+      result += (v[i] * v[i]) / v[i + 1] + (v[i] << 64) % v[i + 1];
+}
+
+template <class T>
+double time_workload(void (*f)(const std::vector<T>&, T&), unsigned bits, unsigned long* allocations)
+{
+   std::vector<T> v;
+   for(unsigned i = 0; i < 20; ++i)
+      v.push_back(generate_random<T>(bits - (i % 3) * 16));
+   T result;
+   unsigned count = 0;
+   allocation_count = 0;
+   f(v, result);
+   if(allocations)
+      *allocations = allocation_count / v.size();
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      f(v, result);
+      ++count;
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / (count * v.size());
+}
+
+typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<0, 0, boost::multiprecision::signed_magnitude, boost::multiprecision::unchecked, counting_allocator<boost::multiprecision::limb_type> > > cpp_int_counted;
+
+template <class Counted, class Pooled, class Other>
+void test(const char* name, void (*f1)(const std::vector<Counted>&, Counted&), void (*f2)(const std::vector<Pooled>&, Pooled&), void (*f3)(const std::vector<Other>&, Other&))
+{
+   std::cout << name << ":\n";
+   std::cout << std::setw(8) << "Bits" << std::setw(16) << "Allocs/step" << std::setw(16) << "cpp_int (us)" << std::setw(16) << "pooled (us)" << std::setw(10) << "Ratio";
+#ifdef TEST_MPZ
+   std::cout << std::setw(16) << "mpz_int (us)";
+#endif
+   std::cout << std::endl;
+   for(unsigned bits = 128; bits <= 16384; bits *= 2)
+   {
+      unsigned long allocations;
+      double t1 = time_workload(f1, bits, &allocations);
+      double t2 = time_workload(f2, bits, 0);
+      std::cout << std::setw(8) << bits << std::setw(16) << allocations << std::setw(16) << std::setprecision(4) << t1 * 1e6 << std::setw(16) << t2 * 1e6 << std::setw(10) << t1 / t2;
+#ifdef TEST_MPZ
+      std::cout << std::setw(16) << time_workload(f3, bits, 0) * 1e6;
+#else
+      (void)f3;
+#endif
+      std::cout << std::endl;
+   }
+}
+
+//
+// cpp_dec_float workloads, each the sort of thing for which the default_ops functions create
+// many temporaries:
+//
+template <class T>
+void dec_arithmetic(const std::vector<T>& v, T& result)
+{
+   result = 0;
+   for(unsigned i = 0; i + 2 < v.size(); ++i)
+      result += v[i] * v[i + 1] / v[i + 2] - v[i];
+}
+template <class T>
+void dec_sqrt(const std::vector<T>& v, T& result)
+{
+   for(unsigned i = 0; i < v.size(); ++i)
+      result = sqrt(v[i]);
+}
+template <class T>
+void dec_exp(const std::vector<T>& v, T& result)
+{
+   for(unsigned i = 0; i < v.size(); ++i)
+      result = exp(v[i]);
+}
+template <class T>
+void dec_log(const std::vector<T>& v, T& result)
+{
+   for(unsigned i = 0; i < v.size(); ++i)
+      result = log(v[i]);
+}
+
+template <class T>
+double time_dec_float(void (*f)(const std::vector<T>&, T&), unsigned long* allocations)
+{
+   std::vector<T> v;
+   for(unsigned i = 0; i < 10; ++i)
+      v.push_back(T(i + 2) / 7);
+   T result;
+   unsigned count = 0;
+   allocation_count = 0;
+   f(v, result);
+   if(allocations)
+      *allocations = allocation_count / v.size();
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      f(v, result);
+      ++count;
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / (count * v.size());
+}
+
+template <unsigned Digits>
+void test_dec_float()
+{
+   using namespace boost::multiprecision;
+   typedef number<cpp_dec_float<Digits, boost::int32_t, counting_allocator<boost::uint32_t> > > counted_type;
+   typedef number<cpp_dec_float<Digits, boost::int32_t, pool_allocator<void> > >                pooled_type;
+   typedef number<cpp_dec_float<Digits> >                                                       fixed_type;
+
+   static const char* names[] = { "Arithmetic", "sqrt", "exp", "log" };
+   void (*counted[])(const std::vector<counted_type>&, counted_type&) = { &dec_arithmetic<counted_type>, &dec_sqrt<counted_type>, &dec_exp<counted_type>, &dec_log<counted_type> };
+   void (*pooled[])(const std::vector<pooled_type>&, pooled_type&) = { &dec_arithmetic<pooled_type>, &dec_sqrt<pooled_type>, &dec_exp<pooled_type>, &dec_log<pooled_type> };
+   void (*fixed[])(const std::vector<fixed_type>&, fixed_type&) = { &dec_arithmetic<fixed_type>, &dec_sqrt<fixed_type>, &dec_exp<fixed_type>, &dec_log<fixed_type> };
+
+   for(unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+   {
+      unsigned long allocations;
+      double t1 = time_dec_float(counted[i], &allocations);
+      double t2 = time_dec_float(pooled[i], 0);
+      double t3 = time_dec_float(fixed[i], 0);
+      std::cout << std::setw(8) << Digits << std::setw(12) << names[i] << std::setw(16) << allocations << std::setw(20) << std::setprecision(4) << t1 * 1e6 << std::setw(16) << t2 * 1e6 << std::setw(16) << t3 * 1e6 << std::endl;
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+#ifdef TEST_MPZ
+   typedef mpz_int other_type;
+#else
+   typedef cpp_int other_type;
+#endif
+   test("Horner", &horner<cpp_int_counted>, &horner<cpp_int_pooled>, &horner<other_type>);
+   test("Sum of products", &mixed<cpp_int_counted>, &mixed<cpp_int_pooled>, &mixed<other_type>);
+   test("Divide and remainder", &divide<cpp_int_counted>, &divide<cpp_int_pooled>, &divide<other_type>);
+
+   std::cout << "cpp_dec_float:\n";
+   std::cout << std::setw(8) << "Digits" << std::setw(12) << "Function" << std::setw(16) << "Allocs/step" << std::setw(20) << "std::allocator (us)" << std::setw(16) << "pooled (us)" << std::setw(16) << "void (us)" << std::endl;
+   test_dec_float<100>();
+   test_dec_float<500>();
+   test_dec_float<1000>();
+   return 0;
+}
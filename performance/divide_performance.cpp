@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Division timings for cpp_int across a range of sizes, used to choose
+// BOOST_MP_BZ_DIVISION_CUTOFF and BOOST_MP_NEWTON_DIVISION_CUTOFF.  Build once as is,
+// and once with both cutoffs set to 1000000 to obtain long division timings for
+// comparison, the crossover points are where the two sets of results meet.  Also timed
+// are division by a single limb, and repeated division by the same value via divisor<>.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+//
+// Returns the time in seconds for a single division of a value of "bits" * 2 bits
+// by one of "bits" bits:
+//
+template <class T>
+double time_divide(unsigned bits)
+{
+   std::vector<T> a, b;
+   for(unsigned i = 0; i < 10; ++i)
+   {
+      a.push_back(generate_random<T>(2 * bits));
+      b.push_back(generate_random<T>(bits));
+   }
+   T r;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+         r = a[i] / b[i];
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+//
+// As above, but for division by a single limb value, and by a divisor<T> which has been
+// prepared in advance:
+//
+template <class T>
+double time_divide_limb(unsigned bits)
+{
+   std::vector<T> a;
+   for(unsigned i = 0; i < 10; ++i)
+      a.push_back(generate_random<T>(bits));
+   boost::multiprecision::limb_type b = static_cast<boost::multiprecision::limb_type>(generate_random<T>(sizeof(boost::multiprecision::limb_type) * CHAR_BIT - 3));
+   T r;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+         r = a[i] / b;
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+template <class T>
+double time_divide_divisor(unsigned bits)
+{
+   std::vector<T> a;
+   for(unsigned i = 0; i < 10; ++i)
+      a.push_back(generate_random<T>(2 * bits));
+   boost::multiprecision::divisor<T> b(generate_random<T>(bits));
+   T r;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+         r = a[i] / b;
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+template <unsigned Bits>
+void test_fixed()
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<2 * Bits, 2 * Bits, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void> > fixed_type;
+   std::cout << std::setw(10) << Bits << std::setw(16) << time_divide<fixed_type>(Bits) << std::endl;
+}
+
+int main()
+{
+   static const unsigned limb_bits = sizeof(boost::multiprecision::limb_type) * CHAR_BIT;
+
+   std::cout << "Burnikel-Ziegler cutoff: " << BOOST_MP_BZ_DIVISION_CUTOFF << " limbs, Newton cutoff: " << BOOST_MP_NEWTON_DIVISION_CUTOFF << " limbs\n\n";
+   std::cout << std::setw(10) << "Bits" << std::setw(16) << "cpp_int"
+#ifdef TEST_MPZ
+      << std::setw(16) << "mpz_int" << std::setw(10) << "ratio"
+#endif
+      << std::endl;
+   //
+   // Divisor sizes in limbs, dense around the default cutoffs:
+   //
+   static const unsigned sizes[] = { 8, 16, 32, 48, 64, 80, 96, 128, 192, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768 };
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      unsigned bits = sizes[i] * limb_bits;
+      double t1 = time_divide<boost::multiprecision::cpp_int>(bits);
+      std::cout << std::setw(10) << bits << std::setw(16) << t1;
+#ifdef TEST_MPZ
+      double t2 = time_divide<boost::multiprecision::mpz_int>(bits);
+      std::cout << std::setw(16) << t2 << std::setw(10) << t1 / t2;
+#endif
+      std::cout << std::endl;
+   }
+   std::cout << "\nDivision of a value of Bits bits by a single limb:\n";
+   static const unsigned limb_sizes[] = { 2, 4, 8, 32, 128, 512 };
+   for(unsigned i = 0; i < sizeof(limb_sizes) / sizeof(limb_sizes[0]); ++i)
+   {
+      unsigned bits = limb_sizes[i] * limb_bits;
+      double t1 = time_divide_limb<boost::multiprecision::cpp_int>(bits);
+      std::cout << std::setw(10) << bits << std::setw(16) << t1;
+#ifdef TEST_MPZ
+      double t2 = time_divide_limb<boost::multiprecision::mpz_int>(bits);
+      std::cout << std::setw(16) << t2 << std::setw(10) << t1 / t2;
+#endif
+      std::cout << std::endl;
+   }
+   std::cout << "\nAs the first table, but for repeated division by the same value, via divisor<cpp_int>:\n";
+   for(unsigned i = 0; i < 8; ++i)
+   {
+      unsigned bits = (i ? sizes[i - 1] : 2) * limb_bits;
+      std::cout << std::setw(10) << bits << std::setw(16) << time_divide<boost::multiprecision::cpp_int>(bits)
+         << std::setw(16) << time_divide_divisor<boost::multiprecision::cpp_int>(bits) << std::endl;
+   }
+   std::cout << "\nFixed precision types:\n";
+   test_fixed<4096>();
+   test_fixed<8192>();
+   test_fixed<16384>();
+   test_fixed<32768>();
+   return 0;
+}
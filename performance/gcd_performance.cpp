@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// GCD timings for cpp_int across a range of sizes, used to choose BOOST_MP_LEHMER_GCD_CUTOFF
+// and BOOST_MP_HGCD_CUTOFF.  Build once as is, and once with both cutoffs set to 1000000
+// to obtain binary GCD timings for comparison.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+//
+// Returns the time in seconds for a single gcd (or gcdext) of two values of "bits" bits:
+//
+template <class T>
+double time_gcd(unsigned bits, bool extended)
+{
+   std::vector<T> a, b;
+   for(unsigned i = 0; i < 10; ++i)
+   {
+      a.push_back(generate_random<T>(bits));
+      b.push_back(generate_random<T>(bits - 16));
+   }
+   T g, s, t;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+      {
+         if(extended)
+            gcdext(a[i], b[i], g, s, t);
+         else
+            g = gcd(a[i], b[i]);
+      }
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+template <unsigned Bits>
+void test_fixed()
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<Bits, Bits, boost::multiprecision::signed_magnitude, boost::multiprecision::unchecked, void> > fixed_type;
+   std::cout << std::setw(10) << Bits << std::setw(16) << time_gcd<fixed_type>(Bits, false) << std::endl;
+}
+
+int main()
+{
+   static const unsigned limb_bits = sizeof(boost::multiprecision::limb_type) * CHAR_BIT;
+
+   std::cout << "Lehmer cutoff: " << BOOST_MP_LEHMER_GCD_CUTOFF << " limbs, half-GCD cutoff: " << BOOST_MP_HGCD_CUTOFF << " limbs\n\n";
+   std::cout << std::setw(10) << "Bits" << std::setw(16) << "gcd" << std::setw(16) << "gcdext"
+#ifdef TEST_MPZ
+      << std::setw(16) << "mpz_int gcd" << std::setw(10) << "ratio"
+#endif
+      << std::endl;
+   //
+   // Sizes in limbs, dense around the default cutoffs:
+   //
+   static const unsigned sizes[] = { 2, 3, 4, 6, 8, 16, 32, 64, 96, 128, 160, 192, 256, 512, 1024, 2048, 4096, 8192 };
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      unsigned bits = sizes[i] * limb_bits;
+      double t1 = time_gcd<boost::multiprecision::cpp_int>(bits, false);
+      std::cout << std::setw(10) << bits << std::setw(16) << t1 << std::setw(16) << time_gcd<boost::multiprecision::cpp_int>(bits, true);
+#ifdef TEST_MPZ
+      double t2 = time_gcd<boost::multiprecision::mpz_int>(bits, false);
+      std::cout << std::setw(16) << t2 << std::setw(10) << t1 / t2;
+#endif
+      std::cout << std::endl;
+   }
+   std::cout << "\nFixed precision types:\n";
+   test_fixed<256>();
+   test_fixed<1024>();
+   test_fixed<4096>();
+   return 0;
+}
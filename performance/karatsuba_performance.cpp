@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Multiplication timings for cpp_int across a range of sizes, used to choose
+// BOOST_MP_KARATSUBA_CUTOFF, BOOST_MP_TOOM3_CUTOFF and BOOST_MP_NTT_CUTOFF.  Build once
+// as is, and once with -DBOOST_MP_KARATSUBA_CUTOFF=1000000 to obtain schoolbook timings
+// for comparison, the crossover points are where the two sets of results meet.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+//
+// Returns the time in seconds for a single multiplication of two values of "bits" bits:
+//
+template <class T>
+double time_multiply(unsigned bits)
+{
+   std::vector<T> a, b;
+   for(unsigned i = 0; i < 10; ++i)
+   {
+      a.push_back(generate_random<T>(bits));
+      b.push_back(generate_random<T>(bits));
+   }
+   T r;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+         r = a[i] * b[i];
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+template <unsigned Bits>
+void test_fixed()
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<2 * Bits, 2 * Bits, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void> > fixed_type;
+   std::cout << std::setw(10) << Bits << std::setw(16) << time_multiply<fixed_type>(Bits) << std::endl;
+}
+
+int main()
+{
+   static const unsigned limb_bits = sizeof(boost::multiprecision::limb_type) * CHAR_BIT;
+
+   std::cout << "Karatsuba cutoff: " << BOOST_MP_KARATSUBA_CUTOFF << " limbs, Toom-3 cutoff: " << BOOST_MP_TOOM3_CUTOFF << " limbs, NTT cutoff: " << BOOST_MP_NTT_CUTOFF << " limbs\n\n";
+   std::cout << std::setw(10) << "Bits" << std::setw(16) << "cpp_int"
+#ifdef TEST_MPZ
+      << std::setw(16) << "mpz_int" << std::setw(10) << "ratio"
+#endif
+      << std::endl;
+   //
+   // Sizes in limbs, from the schoolbook range upwards, dense around the default cutoffs:
+   //
+   static const unsigned sizes[] = { 4, 8, 12, 16, 24, 32, 40, 48, 56, 64, 96, 128, 160, 192, 224, 256, 384, 512, 1024, 2048, 3072, 4096, 8192, 16384 };
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      unsigned bits = sizes[i] * limb_bits;
+      double t1 = time_multiply<boost::multiprecision::cpp_int>(bits);
+      std::cout << std::setw(10) << bits << std::setw(16) << t1;
+#ifdef TEST_MPZ
+      double t2 = time_multiply<boost::multiprecision::mpz_int>(bits);
+      std::cout << std::setw(16) << t2 << std::setw(10) << t1 / t2;
+#endif
+      std::cout << std::endl;
+   }
+   std::cout << "\nFixed precision types:\n";
+   test_fixed<4096>();
+   test_fixed<8192>();
+   test_fixed<16384>();
+   test_fixed<32768>();
+   test_fixed<65536>();
+   return 0;
+}
@@ -0,0 +1,183 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Timings for the linear time cpp_int operations whose inner loops are the limb kernels in
+// cpp_int/intel_intrinsics.hpp: addition, subtraction, and, or, xor and complement.  Build once
+// as is, and once with -DBOOST_MP_NO_LIMB_INTRINSICS to obtain the timings of the portable
+// loops for comparison.  The SIMD kernels are only used when the target allows, so build with
+// for example -mavx2 or -march=native to compare those too.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+enum operation
+{
+   op_add,
+   op_subtract,
+   op_and,
+   op_or,
+   op_xor,
+   op_complement
+};
+
+const char* names[] = { "add", "subtract", "and", "or", "xor", "complement" };
+
+template <class T>
+inline void apply(T& r, const T& a, const T& b, operation op)
+{
+   switch(op)
+   {
+   case op_add:
+      r = a + b;
+      break;
+   case op_subtract:
+      r = a - b;
+      break;
+   case op_and:
+      r = a & b;
+      break;
+   case op_or:
+      r = a | b;
+      break;
+   case op_xor:
+      r = a ^ b;
+      break;
+   case op_complement:
+      r = ~a;
+      break;
+   }
+}
+
+//
+// Returns the time in seconds for a single operation on two values of "bits" bits:
+//
+template <class T>
+double time_op(unsigned bits, operation op)
+{
+   std::vector<T> a, b;
+   for(unsigned i = 0; i < 10; ++i)
+   {
+      a.push_back(generate_random<T>(bits));
+      b.push_back(generate_random<T>(bits) >> 1);
+   }
+   T r;
+   //
+   // Run once first, so that r has all the storage it will need:
+   //
+   for(unsigned i = 0; i < a.size(); ++i)
+      apply(r, a[i], b[i], op);
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+         apply(r, a[i], b[i], op);
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+template <unsigned Bits>
+void test_fixed()
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<Bits, Bits, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void> > fixed_type;
+   std::cout << std::setw(10) << Bits;
+   for(unsigned op = op_add; op <= op_complement; ++op)
+      std::cout << std::setw(12) << time_op<fixed_type>(Bits, static_cast<operation>(op));
+   std::cout << std::endl;
+}
+
+int main()
+{
+#ifdef BOOST_MP_HAS_ADDCARRY
+   std::cout << "Carry chains: _addcarry/_subborrow intrinsics\n";
+#else
+   std::cout << "Carry chains: portable\n";
+#endif
+#if defined(BOOST_MP_HAS_AVX512)
+   std::cout << "Bitwise operations: AVX-512\n\n";
+#elif defined(BOOST_MP_HAS_AVX2)
+   std::cout << "Bitwise operations: AVX2\n\n";
+#elif defined(BOOST_MP_HAS_SSE2)
+   std::cout << "Bitwise operations: SSE2\n\n";
+#else
+   std::cout << "Bitwise operations: portable\n\n";
+#endif
+   static const unsigned sizes[] = { 256, 512, 1024, 2048, 4096, 8192, 16384 };
+
+   std::cout << "cpp_int:\n" << std::setw(10) << "Bits";
+   for(unsigned op = op_add; op <= op_complement; ++op)
+      std::cout << std::setw(12) << names[op];
+   std::cout << std::endl;
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      std::cout << std::setw(10) << sizes[i];
+      for(unsigned op = op_add; op < op_complement; ++op)
+         std::cout << std::setw(12) << time_op<boost::multiprecision::cpp_int>(sizes[i], static_cast<operation>(op));
+      // The complement of a signed type is just a negation, so there is nothing to time:
+      std::cout << std::setw(12) << "-" << std::endl;
+   }
+#ifdef TEST_MPZ
+   std::cout << "\nmpz_int:\n";
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      std::cout << std::setw(10) << sizes[i];
+      for(unsigned op = op_add; op < op_complement; ++op)
+         std::cout << std::setw(12) << time_op<boost::multiprecision::mpz_int>(sizes[i], static_cast<operation>(op));
+      std::cout << std::endl;
+   }
+#endif
+   std::cout << "\nFixed precision unsigned types:\n";
+   test_fixed<256>();
+   test_fixed<512>();
+   test_fixed<1024>();
+   test_fixed<2048>();
+   test_fixed<4096>();
+   test_fixed<8192>();
+   test_fixed<16384>();
+   return 0;
+}
@@ -22,7 +22,9 @@
 #endif
 #include <boost/multiprecision/miller_rabin.hpp>
 #include <boost/chrono.hpp>
+#include <iterator>
 #include <map>
+#include <vector>
 
 template <class Clock>
 struct stopwatch
@@ -121,6 +123,104 @@ boost::chrono::duration<double> test_miller_rabin(const char* name)
    return t;
 }
 
+//
+// Throughput, in candidates per second, of the single value, batch, and interval primality
+// tests applied to the same odd 256-bit candidates:
+//
+std::map<std::string, std::map<std::string, double> > throughput;
+
+template <class IntType>
+void test_throughput(const char* name)
+{
+   using namespace boost::random;
+   using namespace boost::multiprecision;
+
+   static const unsigned count = 20000;
+
+   independent_bits_engine<mt11213b, 256, IntType> gen;
+   mt19937 gen2;
+   IntType first = gen() | 1;
+   std::vector<IntType> candidates;
+   for(unsigned i = 0; i < count; ++i)
+      candidates.push_back(IntType(first + 2 * i));
+   unsigned result_count = 0;
+   std::vector<bool> results;
+   std::vector<IntType> primes;
+
+   stopwatch<boost::chrono::high_resolution_clock> c;
+   for(unsigned i = 0; i < count; ++i)
+      result_count += miller_rabin_test(candidates[i], 25, gen2);
+   throughput[name]["miller_rabin_test"] = count / boost::chrono::duration<double>(c.elapsed()).count();
+
+   c.reset();
+   for(unsigned i = 0; i < count; ++i)
+      result_count += baillie_psw_test(candidates[i]);
+   throughput[name]["baillie_psw_test"] = count / boost::chrono::duration<double>(c.elapsed()).count();
+
+   c.reset();
+   baillie_psw_test(candidates.begin(), candidates.end(), std::back_inserter(results), 1);
+   throughput[name]["batch (1 thread)"] = count / boost::chrono::duration<double>(c.elapsed()).count();
+
+   results.clear();
+   c.reset();
+   baillie_psw_test(candidates.begin(), candidates.end(), std::back_inserter(results));
+   throughput[name]["batch (all threads)"] = count / boost::chrono::duration<double>(c.elapsed()).count();
+
+   c.reset();
+   find_probable_primes(first, IntType(first + 2 * count), std::back_inserter(primes), 1);
+   throughput[name]["find_probable_primes (1 thread)"] = count / boost::chrono::duration<double>(c.elapsed()).count();
+
+   primes.clear();
+   c.reset();
+   find_probable_primes(first, IntType(first + 2 * count), std::back_inserter(primes));
+   throughput[name]["find_probable_primes (all threads)"] = count / boost::chrono::duration<double>(c.elapsed()).count();
+
+   std::cout << "Throughput for " << name << " (candidates per second):" << std::endl;
+   for(std::map<std::string, double>::const_iterator i = throughput[name].begin(); i != throughput[name].end(); ++i)
+      std::cout << "   " << std::setw(36) << std::left << i->first << " = " << i->second << std::endl;
+   std::cout << "Number of primes found = " << primes.size() << std::endl;
+}
+
+//
+// Time per candidate for miller_rabin_test on consecutive odd values of increasing size, and for
+// trial_division_sieve walking the same values.  Build with BOOST_MP_TRIAL_DIVISION_BOUND=227 for
+// comparison with trial division by the smallest primes only:
+//
+void test_trial_division()
+{
+   using namespace boost::multiprecision;
+
+   boost::random::mt19937 gen;
+   for(unsigned bits = 256; bits <= 4096; bits *= 2)
+   {
+      cpp_int n = 1;
+      while(msb(n) < bits)
+      {
+         n <<= 32;
+         n |= gen();
+      }
+      n |= 1;
+      unsigned count = 8 * 1024 * 1024 / (bits * bits / 64);
+      unsigned result_count = 0;
+
+      stopwatch<boost::chrono::high_resolution_clock> c;
+      cpp_int m(n);
+      for(unsigned i = 0; i < count; ++i, m += 2)
+         result_count += miller_rabin_test(m, 25, gen);
+      double t1 = boost::chrono::duration<double>(c.elapsed()).count();
+
+      c.reset();
+      trial_division_sieve<cpp_int> sieve(n);
+      unsigned survivors = 0;
+      for(unsigned i = 0; i < count; ++i, sieve += 2)
+         survivors += !sieve.has_small_factor();
+      double t2 = boost::chrono::duration<double>(c.elapsed()).count();
+
+      std::cout << "Time per candidate at " << std::setw(5) << bits << " bits: miller_rabin_test = " << t1 / count
+         << "s, trial_division_sieve = " << t2 / count << "s (" << result_count << " primes, " << survivors << " survivors of " << count << ")" << std::endl;
+   }
+}
+
 void generate_quickbook()
 {
    std::cout << "[table\n[[Integer Type][Relative Performance (Actual time in parenthesis)]]\n";
@@ -135,6 +235,22 @@ void generate_quickbook()
    }
    
    std::cout << "]\n";
+
+   if(throughput.empty())
+      return;
+   std::cout << "[table\n[[Integer Type]";
+   const std::map<std::string, double>& columns = throughput.begin()->second;
+   for(std::map<std::string, double>::const_iterator k = columns.begin(); k != columns.end(); ++k)
+      std::cout << "[" << k->first << "]";
+   std::cout << "]\n";
+   for(std::map<std::string, std::map<std::string, double> >::const_iterator r = throughput.begin(); r != throughput.end(); ++r)
+   {
+      std::cout << "[[" << r->first << "]";
+      for(std::map<std::string, double>::const_iterator k = r->second.begin(); k != r->second.end(); ++k)
+         std::cout << "[" << k->second << "]";
+      std::cout << "]\n";
+   }
+   std::cout << "]\n";
 }
 
 int main()
@@ -149,11 +265,15 @@ int main()
    test_miller_rabin<number<cpp_int_backend<1024> > >("cpp_int (1024-bit cache)");
    test_miller_rabin<int1024_t>("int1024_t");
    test_miller_rabin<checked_int1024_t>("checked_int1024_t");
+   test_throughput<cpp_int>("cpp_int");
+   test_throughput<uint256_t>("uint256_t");
+   test_trial_division();
 #endif
 #ifdef TEST_MPZ
    test_miller_rabin<number<gmp_int, et_off> >("mpz_int (no Expression templates)");
    test_miller_rabin<mpz_int>("mpz_int");
    std::cout << "Time for mpz_int (native Miller Rabin Test) = " << test_miller_rabin_gmp() << std::endl;
+   test_throughput<mpz_int>("mpz_int");
 #endif
 #ifdef TEST_TOMMATH
    test_miller_rabin<number<boost::multiprecision::tommath_int, et_off> >("tom_int (no Expression templates)");
@@ -703,6 +703,55 @@ void test(const char* type, unsigned precision)
    report_result(cat, type, "/=(unsigned long long)", precision, t.template test_inplace_divide_hetero<unsigned long long>());
 }
 
+#ifdef TEST_CPP_INT
+//
+// std::allocator, but counting the number of allocations made, so that we can see how many
+// are avoided by a larger internal buffer:
+//
+unsigned long long allocation_count = 0;
+
+template <class T>
+struct counting_allocator : public std::allocator<T>
+{
+   template <class U>
+   struct rebind
+   {
+      typedef counting_allocator<U> other;
+   };
+   counting_allocator() {}
+   template <class U>
+   counting_allocator(const counting_allocator<U>&) {}
+   T* allocate(std::size_t n, const void* = 0)
+   {
+      ++allocation_count;
+      return std::allocator<T>::allocate(n);
+   }
+};
+
+template <class Number>
+void test_allocations(const char* type, unsigned precision)
+{
+   typedef tester<Number, boost::multiprecision::number_kind_integer> tester_type;
+   bits_wanted = precision;
+   allocation_count = 0;
+   tester_type t;
+   // Per value constructed:
+   std::cout << std::left << std::setw(35) << type << std::setw(10) << precision << std::setw(25) << "construct(random)" << allocation_count / 1000.0 << std::endl;
+   //
+   // Then per operation:
+   //
+   static const char* names[] = { "+", "-", "*", "/", "%", "str", "gcd" };
+   static const double counts[] = { 500000, 500000, 500000, 500000, 500000, 500, 500000 };
+   double (tester_type::*tests[])() = { &tester_type::test_add, &tester_type::test_subtract, &tester_type::test_multiply, &tester_type::test_divide, &tester_type::test_mod, &tester_type::test_str, &tester_type::test_gcd };
+   for(unsigned i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+   {
+      allocation_count = 0;
+      (t.*tests[i])();
+      std::cout << std::left << std::setw(35) << type << std::setw(10) << precision << std::setw(25) << names[i] << allocation_count / counts[i] << std::endl;
+   }
+}
+#endif
+
 void quickbook_results()
 {
    //
@@ -803,6 +852,22 @@ int main()
    test<boost::multiprecision::cpp_int>("cpp_int", 256);
    test<boost::multiprecision::cpp_int>("cpp_int", 512);
    test<boost::multiprecision::cpp_int>("cpp_int", 1024);
+
+   test<boost::multiprecision::number<boost::multiprecision::cpp_int_backend<512> > >("cpp_int(512 inline)", 128);
+   test<boost::multiprecision::number<boost::multiprecision::cpp_int_backend<512> > >("cpp_int(512 inline)", 256);
+   test<boost::multiprecision::number<boost::multiprecision::cpp_int_backend<512> > >("cpp_int(512 inline)", 512);
+   test<boost::multiprecision::number<boost::multiprecision::cpp_int_backend<512> > >("cpp_int(512 inline)", 1024);
+   //
+   // Number of memory allocations per operation, with the default internal buffer and with
+   // space for 512 bits:
+   //
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<0, 0, boost::multiprecision::signed_magnitude, boost::multiprecision::unchecked, counting_allocator<boost::multiprecision::limb_type> > > counted_cpp_int;
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_int_backend<512, 0, boost::multiprecision::signed_magnitude, boost::multiprecision::unchecked, counting_allocator<boost::multiprecision::limb_type> > > counted_cpp_int_512;
+   for(unsigned bits = 128; bits <= 1024; bits *= 2)
+   {
+      test_allocations<counted_cpp_int>("cpp_int allocations", bits);
+      test_allocations<counted_cpp_int_512>("cpp_int(512 inline) allocations", bits);
+   }
 #endif
 #ifdef TEST_CPP_INT_RATIONAL
    test<boost::multiprecision::cpp_rational>("cpp_rational", 128);
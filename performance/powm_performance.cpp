@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Timings for powm with full size exponents, for both odd (Montgomery) and even
+// (Barrett) moduli, and for both arbitrary and fixed precision types.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+//
+// Returns the time in seconds for a single powm with all arguments of "bits" bits:
+//
+template <class T>
+double time_powm(unsigned bits, bool odd)
+{
+   T a = generate_random<T>(bits);
+   T p = generate_random<T>(bits);
+   T m = generate_random<T>(bits);
+   if(odd)
+      m |= 1u;
+   else
+      m &= ~T(1u);
+   T r;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      r = powm(a, p, m);
+      ++count;
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+template <class T>
+void test(const char* name, unsigned bits)
+{
+   std::cout << std::setw(20) << name << std::setw(10) << bits
+      << std::setw(16) << time_powm<T>(bits, true) << std::setw(16) << time_powm<T>(bits, false) << std::endl;
+}
+
+template <unsigned Bits>
+void test_fixed()
+{
+   test<boost::multiprecision::number<boost::multiprecision::cpp_int_backend<Bits, Bits, boost::multiprecision::unsigned_magnitude, boost::multiprecision::unchecked, void> > >("fixed", Bits);
+}
+
+int main()
+{
+   std::cout << std::setw(20) << "Type" << std::setw(10) << "Bits" << std::setw(16) << "odd modulus" << std::setw(16) << "even modulus" << std::endl;
+   static const unsigned sizes[] = { 256, 512, 1024, 2048, 4096 };
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      test<boost::multiprecision::cpp_int>("cpp_int", sizes[i]);
+#ifdef TEST_MPZ
+      test<boost::multiprecision::mpz_int>("mpz_int", sizes[i]);
+#endif
+   }
+   test_fixed<256>();
+   test_fixed<512>();
+   test_fixed<1024>();
+   test_fixed<2048>();
+   test_fixed<4096>();
+   return 0;
+}
@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Decimal string conversion timings for cpp_int across a range of sizes, used to choose
+// BOOST_MP_RADIX_OUTPUT_CUTOFF and BOOST_MP_RADIX_INPUT_CUTOFF.  Build once as is, and once
+// with both cutoffs set to 1000000 to obtain block at a time timings for comparison.
+//
+
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/chrono.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+
+template <class Clock>
+struct stopwatch
+{
+   typedef typename Clock::duration duration;
+   stopwatch()
+   {
+      m_start = Clock::now();
+   }
+   duration elapsed()
+   {
+      return Clock::now() - m_start;
+   }
+   void reset()
+   {
+      m_start = Clock::now();
+   }
+
+private:
+   typename Clock::time_point m_start;
+};
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   static boost::random::mt19937 gen;
+   T val = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      val <<= 32;
+      val |= gen();
+   }
+   return val;
+}
+
+//
+// Returns the time in seconds for a single conversion of a value of "bits" bits
+// to a string (or from a string when to_string is false):
+//
+template <class T>
+double time_conversion(unsigned bits, bool to_string)
+{
+   std::vector<T> a;
+   std::vector<std::string> s;
+   for(unsigned i = 0; i < 10; ++i)
+   {
+      a.push_back(generate_random<T>(bits));
+      s.push_back(a.back().str());
+   }
+   T r;
+   std::string rs;
+   unsigned count = 0;
+   stopwatch<boost::chrono::high_resolution_clock> w;
+   do
+   {
+      for(unsigned i = 0; i < a.size(); ++i)
+      {
+         if(to_string)
+            rs = a[i].str();
+         else
+            r = T(s[i]);
+      }
+      count += a.size();
+   } while(boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() < 0.25);
+   return boost::chrono::duration_cast<boost::chrono::duration<double> >(w.elapsed()).count() / count;
+}
+
+int main()
+{
+   static const unsigned limb_bits = sizeof(boost::multiprecision::limb_type) * CHAR_BIT;
+
+   std::cout << "Radix output cutoff: " << BOOST_MP_RADIX_OUTPUT_CUTOFF << " limbs, input cutoff: " << BOOST_MP_RADIX_INPUT_CUTOFF << " limbs\n\n";
+   std::cout << std::setw(10) << "Bits" << std::setw(16) << "str()" << std::setw(16) << "construct"
+#ifdef TEST_MPZ
+      << std::setw(16) << "mpz_int str()" << std::setw(16) << "mpz construct"
+#endif
+      << std::endl;
+   //
+   // Sizes in limbs, dense around the default cutoffs:
+   //
+   static const unsigned sizes[] = { 8, 16, 24, 32, 40, 48, 64, 96, 128, 192, 256, 384, 512, 1024, 4096, 16384 };
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      unsigned bits = sizes[i] * limb_bits;
+      std::cout << std::setw(10) << bits << std::setw(16) << time_conversion<boost::multiprecision::cpp_int>(bits, true)
+         << std::setw(16) << time_conversion<boost::multiprecision::cpp_int>(bits, false);
+#ifdef TEST_MPZ
+      std::cout << std::setw(16) << time_conversion<boost::multiprecision::mpz_int>(bits, true)
+         << std::setw(16) << time_conversion<boost::multiprecision::mpz_int>(bits, false);
+#endif
+      std::cout << std::endl;
+   }
+   return 0;
+}
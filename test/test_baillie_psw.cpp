@@ -0,0 +1,192 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compare baillie_psw_test, and the batch and interval forms, to a sieve for small values,
+// to GMP for random values, and to known pseudoprimes for the individual tests.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/miller_rabin.hpp>
+#include <boost/math/special_functions/prime.hpp>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "test.hpp"
+
+static const unsigned sieve_limit = 200000;
+
+std::vector<char> make_sieve()
+{
+   std::vector<char> is_prime(sieve_limit, 1);
+   is_prime[0] = is_prime[1] = 0;
+   for(unsigned i = 2; i * i < sieve_limit; ++i)
+   {
+      if(is_prime[i])
+      {
+         for(unsigned j = i * i; j < sieve_limit; j += i)
+            is_prime[j] = 0;
+      }
+   }
+   return is_prime;
+}
+
+template <class I>
+void test()
+{
+   using namespace boost::random;
+   using namespace boost::multiprecision;
+
+   typedef I test_type;
+
+   static const unsigned test_bits =
+      std::numeric_limits<test_type>::digits && (std::numeric_limits<test_type>::digits <= 256)
+      ? std::numeric_limits<test_type>::digits
+      : 256;
+
+   std::vector<char> is_prime = make_sieve();
+   //
+   // Every value below the sieve limit:
+   //
+   for(unsigned i = 0; i < sieve_limit; ++i)
+   {
+      if(baillie_psw_test(test_type(i)) != (is_prime[i] != 0))
+         std::cout << "n = " << i << std::endl;
+      BOOST_CHECK_EQUAL(baillie_psw_test(test_type(i)), is_prime[i] != 0);
+   }
+   //
+   // The primes in the table:
+   //
+   for(unsigned i = 1; i < boost::math::max_prime; ++i)
+      BOOST_TEST(baillie_psw_test(test_type(boost::math::prime(i))));
+   //
+   // Strong pseudoprimes to base 2, which must be caught by the Lucas test, including
+   // squares of the Wieferich primes for which no suitable D exists:
+   //
+   static const boost::uint32_t spsp2[] = { 2047u, 3277u, 4033u, 4681u, 8321u, 15841u, 29341u, 42799u, 49141u, 52633u, 65281u, 74665u, 80581u, 85489u, 88357u, 90751u, 1194649u, 12327121u, 25326001u, 3215031751u };
+   for(unsigned i = 0; i < sizeof(spsp2) / sizeof(spsp2[0]); ++i)
+   {
+      BOOST_CHECK(!baillie_psw_test(test_type(spsp2[i])));
+      // But they do pass the Miller-Rabin test with base 2:
+      test_type n(spsp2[i]), q(n - 1);
+      unsigned k = lsb(q);
+      q >>= k;
+      modular_context<test_type> ctx(n);
+      BOOST_CHECK(boost::multiprecision::detail::strong_probable_prime_test(ctx, ctx.to_residue(test_type(2)), q, k, ctx.to_residue(test_type(1)), ctx.to_residue(test_type(n - 1))));
+   }
+   //
+   // Strong Lucas pseudoprimes, which must be caught by the base 2 test:
+   //
+   static const boost::uint32_t slpsp[] = { 5459u, 5777u, 10877u, 16109u, 18971u, 22499u, 24569u, 25199u, 40309u, 58519u, 75077u, 97439u };
+   for(unsigned i = 0; i < sizeof(slpsp) / sizeof(slpsp[0]); ++i)
+   {
+      BOOST_CHECK(!baillie_psw_test(test_type(slpsp[i])));
+      test_type n(slpsp[i]);
+      modular_context<test_type> ctx(n);
+      BOOST_CHECK(boost::multiprecision::detail::strong_lucas_test(ctx, n));
+   }
+   //
+   // Carmichael numbers:
+   //
+   static const boost::uint32_t carmichael[] = { 561u, 1105u, 1729u, 2465u, 2821u, 6601u, 8911u, 10585u, 15841u, 29341u, 41041u, 46657u, 52633u, 62745u, 63973u, 75361u, 101101u, 115921u, 126217u, 162401u, 172081u, 188461u, 252601u, 278545u, 294409u, 314821u, 334153u, 340561u, 399001u, 410041u, 449065u, 488881u, 512461u };
+   for(unsigned i = 0; i < sizeof(carmichael) / sizeof(carmichael[0]); ++i)
+      BOOST_CHECK(!baillie_psw_test(test_type(carmichael[i])));
+   //
+   // Random values compared to GMP:
+   //
+   independent_bits_engine<mt11213b, test_bits, test_type> gen;
+   std::vector<test_type> values;
+   for(unsigned i = 0; i < 10000; ++i)
+   {
+      test_type n = gen();
+      values.push_back(n);
+      bool is_prime_boost = baillie_psw_test(n);
+      bool is_gmp_prime = mpz_probab_prime_p(mpz_int(n).backend().data(), 25) ? true : false;
+      if(is_prime_boost != is_gmp_prime)
+         std::cout << std::hex << std::showbase << "n = " << n << std::endl;
+      BOOST_CHECK_EQUAL(is_prime_boost, is_gmp_prime);
+   }
+   //
+   // The batch form gives the same results, whatever the number of threads:
+   //
+   for(unsigned threads = 0; threads < 4; ++threads)
+   {
+      std::vector<bool> results;
+      baillie_psw_test(values.begin(), values.end(), std::back_inserter(results), threads);
+      BOOST_CHECK_EQUAL(results.size(), values.size());
+      for(unsigned i = 0; i < results.size(); ++i)
+         BOOST_CHECK_EQUAL(results[i], baillie_psw_test(values[i]));
+   }
+   //
+   // Searching an interval, spanning several sieve blocks, gives the same result as
+   // testing each value in turn:
+   //
+   std::vector<test_type> primes;
+   find_probable_primes(test_type(0), test_type(sieve_limit), std::back_inserter(primes));
+   std::vector<test_type> expected;
+   for(unsigned i = 0; i < sieve_limit; ++i)
+   {
+      if(is_prime[i])
+         expected.push_back(i);
+   }
+   BOOST_CHECK(primes == expected);
+   for(unsigned threads = 1; threads < 4; ++threads)
+   {
+      for(unsigned i = 0; i < 3; ++i)
+      {
+         test_type first = gen() >> 1;
+         test_type last = first + 140000 + i;
+         first += i;
+         primes.clear();
+         expected.clear();
+         find_probable_primes(first, last, std::back_inserter(primes), threads);
+         for(test_type n = first; n < last; ++n)
+         {
+            if(baillie_psw_test(n))
+               expected.push_back(n);
+         }
+         BOOST_CHECK(primes == expected);
+      }
+   }
+   // Empty and small intervals:
+   primes.clear();
+   find_probable_primes(test_type(20), test_type(20), std::back_inserter(primes));
+   find_probable_primes(test_type(3), test_type(2), std::back_inserter(primes));
+   BOOST_CHECK(primes.empty());
+   find_probable_primes(test_type(2), test_type(4), std::back_inserter(primes));
+   BOOST_CHECK_EQUAL(primes.size(), 2u);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<boost::uint64_t>();
+   test<cpp_int>();
+   test<number<cpp_int_backend<64, 64, unsigned_magnitude, checked, void>, et_off> >();
+   test<checked_uint128_t>();
+   test<uint512_t>();
+   test<mpz_int>();
+   //
+   // Some large known primes and near misses:
+   //
+   BOOST_CHECK(baillie_psw_test(cpp_int(18446744073709551557uLL)));  // 2^64 - 59
+   BOOST_CHECK(baillie_psw_test(boost::uint64_t(18446744073709551557uLL)));
+   BOOST_CHECK(!baillie_psw_test(boost::uint64_t(18446744073709551615uLL)));
+   cpp_int m = (cpp_int(1) << 127) - 1;
+   BOOST_CHECK(baillie_psw_test(m));
+   BOOST_CHECK(!baillie_psw_test(m * m));
+   BOOST_CHECK(baillie_psw_test(checked_uint128_t(m)));
+   m = (cpp_int(1) << 521) - 1;
+   BOOST_CHECK(baillie_psw_test(m));
+   BOOST_CHECK(!baillie_psw_test(m + 2));
+   BOOST_CHECK(!baillie_psw_test(cpp_int((cpp_int(1) << 127) - 1) * cpp_int((cpp_int(1) << 89) - 1)));
+
+   return boost::report_errors();
+}
@@ -9,10 +9,11 @@
 #  define _SCL_SECURE_NO_WARNINGS
 #endif
 
-#if !defined(TEST_MPF_50) && !defined(TEST_CPP_DEC_FLOAT) && !defined(TEST_MPFR_50)
+#if !defined(TEST_MPF_50) && !defined(TEST_CPP_DEC_FLOAT) && !defined(TEST_MPFR_50) && !defined(TEST_CPP_BIN_FLOAT)
 #  define TEST_MPF_50
 #  define TEST_CPP_DEC_FLOAT
 #  define TEST_MPFR_50
+#  define TEST_CPP_BIN_FLOAT
 
 #ifdef _MSC_VER
 #pragma message("CAUTION!!: No backend type specified so testing everything.... this will take some time!!")
@@ -32,6 +33,9 @@
 #ifdef TEST_CPP_DEC_FLOAT
 #include <boost/multiprecision/cpp_dec_float.hpp>
 #endif
+#ifdef TEST_CPP_BIN_FLOAT
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#endif
 
 #include "test.hpp"
 
@@ -153,6 +157,46 @@ static const char* e =
 "50461950136658543663271254963990854914420001457476081930221206602433009641270489"
 "43903971771951806990869986066365832322787";
 
+static const char* euler = 
+"0.577215664901532860606512090082402431042159335939923598805767234884867726777664"
+"67093694706329174674951463144724980708248096050401448654283622417399764492353625"
+"35003337429373377376739427925952582470949160087352039481656708532331517766115286"
+"21199501507984793745085705740029921354786146694029604325421519058775535267331399"
+"25401296742051375413954911168510280798423487758720503843109399736137255306088933"
+"12676001724795378367592713515772261027349291394079843010341777177808815495706610"
+"75010161916633401522789358679654972520362128792265559536696281763887927268013243"
+"10104765059637039473949576389065729679296010090151251959509222435014093498712282"
+"47949747195646976318506676129063811051824197444867836380861749455169892792301877"
+"39107294578155431600500218284409605377243420328547836701517739439870030237033951"
+"83286900015581939880427074115422278197165230110735658339673487176504919418123000"
+"40654693142999297779569303100503086303418569803231083691640025892970890985486825"
+"77736428825395492587362959613329857473930237343884707037028441292016641785024873"
+"33790805627549984345907616431671031467107223700218107450444186647591348036690255"
+"32458625442225345181387912434573501361297782278288148945909863846006293169471887"
+"14958752549236649352047324364109726827616087759508809512620840454447799229915724"
+"82925162512784276596570832146102982146179519579590959227042089896279712553632179"
+"48873764210660607065982561990102880756125199137511678217643619057058440783573501"
+"58005607745793421314498850078641517161519456570617043245075008168705230789093704"
+"61430668481791649684254915049672431218378387535648949508684541023406016225085155"
+"83867234944187880440940770106883795111307872023426395226920971608856908382511378"
+"71283682049117892594478486199118529391029309905925526691727446892044386971114717"
+"45715745732039352091223160850868275588901094516811810168749754709693666712102063"
+"04827165895049327314860874940207006742590918248759621373842311442653135029230317"
+"51722572216283248838112458957438623987037576628551303314392999540185313414158621"
+"27886480761100301521196578006811777376350168183897338966398689579329914563886443"
+"10370608078174489957958324579418962026049841043922507860460362527726022919682995"
+"86098833901378717142269178838195298445607916051972797360475910251099577913351579"
+"17722515025492932463250287476779484215840507599290401855764599018626926776437266"
+"05711768133655908815548107470000623363725288949554636971433012007913085552639595"
+"49782302314403914974049474682594732084618524605877669488287953010406349172292185"
+"80087067706904279267432844469685149718256780958416544918514575331964063311993738"
+"21573450874988325560888873528019019155089688554682592454445277281730573010806061"
+"77011363773182462924660081277162101867744684959514281790145111948934228834482530"
+"75311870186097612246231767497755641246198385640148412358717724955422482016151765"
+"79940806296834242890572594739269638633838743805471319676429268372490760875073785"
+"28370230468650349051203422721743668979284862972908892678977703262462391226188876"
+"5300577862743606094443";
+
 template <class T>
 inline bool is_mpfr(const T&)
 {
@@ -173,13 +217,19 @@ void test()
    T num, expect;
    num.backend() = boost::multiprecision::default_ops::get_constant_pi<backend_type>();
    expect = static_cast<T>(pi);
-   BOOST_CHECK_CLOSE_FRACTION(num, expect, std::numeric_limits<T>::epsilon() * (is_mpfr(num) ? 1200 : 2));
+   BOOST_CHECK_CLOSE_FRACTION(num, expect, std::numeric_limits<T>::epsilon() * (is_mpfr(num) ? 1200 : 1));
    num.backend() = boost::multiprecision::default_ops::get_constant_ln2<backend_type>();
    expect = static_cast<T>(ln2);
    BOOST_CHECK_CLOSE_FRACTION(num, expect, std::numeric_limits<T>::epsilon() * (is_mpfr(num) ? 30 : 1));
    num.backend() = boost::multiprecision::default_ops::get_constant_e<backend_type>();
    expect = static_cast<T>(e);
    BOOST_CHECK_CLOSE_FRACTION(num, expect, std::numeric_limits<T>::epsilon() * (is_mpfr(num) ? 2 : 1));
+   if(!is_mpfr(num))
+   {
+      num.backend() = boost::multiprecision::default_ops::get_constant_euler<backend_type>();
+      expect = static_cast<T>(euler);
+      BOOST_CHECK_CLOSE_FRACTION(num, expect, std::numeric_limits<T>::epsilon() * 2);
+   }
 }
 
 int main()
@@ -192,6 +242,10 @@ int main()
 #endif
 #ifdef TEST_MPF_50
    test<boost::multiprecision::number<boost::multiprecision::gmp_float<2000> > >();
+#endif
+#ifdef TEST_CPP_BIN_FLOAT
+   test<boost::multiprecision::number<boost::multiprecision::cpp_bin_float<2000> > >();
+   test<boost::multiprecision::number<boost::multiprecision::cpp_bin_float<6000, boost::multiprecision::digit_base_2> > >();
 #endif
    return boost::report_errors();
 }
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// At high precision cpp_bin_float division and square root use Newton iteration, and round
+// the result directly unless it lies too close to a rounding boundary.  Compare both with the
+// exact quotient and root formed by cpp_int and then rounded, for random values, and for exact
+// results and values within one unit of them, which are where the fallback path is taken.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+//
+// Rounds the integer x, with a sticky bit for any part of the exact value below it, to T:
+//
+template <class T>
+T round_to(const boost::multiprecision::cpp_int& x, bool sticky, int exponent)
+{
+   using boost::multiprecision::cpp_int;
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_bin_float<2 * std::numeric_limits<T>::digits + 8, boost::multiprecision::digit_base_2> > wide_type;
+   // wide_type holds the value plus the sticky bit exactly, so the conversion to T is the only rounding:
+   wide_type w(cpp_int((x << 1) | (sticky ? 1 : 0)));
+   return T(ldexp(w, exponent - 1));
+}
+
+template <class T>
+boost::multiprecision::cpp_int mantissa(const T& a, int& e)
+{
+   T f = frexp(a, &e);
+   e -= std::numeric_limits<T>::digits;
+   return ldexp(f, std::numeric_limits<T>::digits).template convert_to<boost::multiprecision::cpp_int>();
+}
+
+template <class T>
+void check_divide(const T& a, const T& b)
+{
+   using boost::multiprecision::cpp_int;
+   const int digits = std::numeric_limits<T>::digits;
+   int ea, eb;
+   cpp_int ma = mantissa(a, ea);
+   cpp_int mb = mantissa(b, eb);
+   cpp_int q, r;
+   divide_qr(cpp_int(ma << (digits + 2)), mb, q, r);
+   T e = round_to<T>(q, r != 0, ea - eb - digits - 2);
+   BOOST_CHECK_EQUAL(T(a / b), e);
+   BOOST_CHECK_EQUAL(T(-a / b), -e);
+   T x = a;
+   x /= b;
+   BOOST_CHECK_EQUAL(x, e);
+}
+
+template <class T>
+void check_sqrt(const T& a)
+{
+   using boost::multiprecision::cpp_int;
+   const int digits = std::numeric_limits<T>::digits;
+   int ea;
+   cpp_int ma = mantissa(a, ea);
+   if(ea & 1)
+   {
+      ma <<= 1;
+      --ea;
+   }
+   ma <<= 2 * (digits + 2);
+   cpp_int r;
+   cpp_int s = sqrt(ma, r);
+   T e = round_to<T>(s, r != 0, ea / 2 - digits - 2);
+   BOOST_CHECK_EQUAL(T(sqrt(a)), e);
+}
+
+template <class T>
+T random_value(int bits = std::numeric_limits<T>::digits)
+{
+   T result = 0;
+   for(int i = 0; i < bits; i += 32)
+      result = ldexp(result, 32) + gen();
+   return ldexp(result, static_cast<int>(gen() % 200) - 100 - bits);
+}
+
+template <class T>
+void test()
+{
+   const int digits = std::numeric_limits<T>::digits;
+
+   for(unsigned i = 0; i < 500; ++i)
+   {
+      T a = random_value<T>();
+      T b = random_value<T>();
+      check_divide(a, b);
+      check_sqrt(a);
+      //
+      // Exact quotients and roots, and their neighbours:
+      //
+      T c = random_value<T>(digits / 2 - 32);
+      T d = random_value<T>(digits / 2 - 32);
+      T p = c * d;
+      check_divide(p, c);
+      check_divide(T(boost::math::float_next(p)), c);
+      check_divide(T(boost::math::float_prior(p)), c);
+      check_sqrt(T(c * c));
+      check_sqrt(T(boost::math::float_next(T(c * c))));
+      check_sqrt(T(boost::math::float_prior(T(c * c))));
+   }
+   //
+   // Divisors and squares close to a power of two:
+   //
+   T one_minus = 1 - ldexp(T(1), -digits);
+   for(int i = 0; i < 50; ++i)
+   {
+      T a = random_value<T>();
+      check_divide(a, one_minus);
+      check_divide(a, T(1 + ldexp(T(1), 1 - digits)));
+      check_divide(one_minus, a);
+   }
+   check_sqrt(one_minus);
+   check_sqrt(T(one_minus / 2));
+   check_sqrt(T(1 + ldexp(T(1), 1 - digits)));
+   check_sqrt(T(2 + ldexp(T(1), 2 - digits)));
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_bin_float_50>();
+   test<cpp_bin_float_100>();
+   test<number<cpp_bin_float<300> > >();
+   test<number<cpp_bin_float<1500> > >();
+   test<number<cpp_bin_float<4000, digit_base_2> > >();
+   test<number<cpp_bin_float<4001, digit_base_2> > >();
+   test<number<cpp_bin_float<3000> > >();
+   test<number<cpp_bin_float<1500, digit_base_10, std::allocator<char> > > >();
+
+   return boost::report_errors();
+}
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// cpp_bin_float multiplication computes only the high half of the product of the mantissas
+// where it can, so compare it with the exact product formed by cpp_int and then rounded, both
+// for random values and for products which lie on, or within a few bits of, a rounding
+// boundary - including ones where the difference is confined to the lowest limb.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+template <class T>
+T exact_product(const T& a, const T& b)
+{
+   using boost::multiprecision::cpp_int;
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_bin_float<2 * std::numeric_limits<T>::digits, boost::multiprecision::digit_base_2> > wide_type;
+
+   int ea, eb;
+   T fa = frexp(a, &ea);
+   T fb = frexp(b, &eb);
+   cpp_int ma = ldexp(fa, std::numeric_limits<T>::digits).template convert_to<cpp_int>();
+   cpp_int mb = ldexp(fb, std::numeric_limits<T>::digits).template convert_to<cpp_int>();
+   // The product has at most twice the digits of T, so wide_type holds it exactly, and the
+   // conversion to T is then the only rounding:
+   wide_type p(ma * mb);
+   return T(ldexp(p, ea + eb - 2 * std::numeric_limits<T>::digits));
+}
+
+template <class T>
+void check_product(const T& a, const T& b)
+{
+   T r = a * b;
+   T e = exact_product(a, b);
+   BOOST_CHECK_EQUAL(r, e);
+   BOOST_CHECK_EQUAL(T(-a * b), -e);
+   BOOST_CHECK_EQUAL(T(b * a), e);
+   r = a;
+   r *= b;
+   BOOST_CHECK_EQUAL(r, e);
+}
+
+template <class T>
+T random_value()
+{
+   T result = 0;
+   for(int bits = 0; bits < std::numeric_limits<T>::digits; bits += 32)
+      result = ldexp(result, 32) + gen();
+   return ldexp(result, static_cast<int>(gen() % 200) - 100 - std::numeric_limits<T>::digits);
+}
+
+template <class T>
+void test()
+{
+   using boost::multiprecision::cpp_int;
+   const int digits = std::numeric_limits<T>::digits;
+
+   for(unsigned i = 0; i < 2000; ++i)
+      check_product(random_value<T>(), random_value<T>());
+   //
+   // With mantissas a = 2^(digits-1) + n and b = 2^(digits-1) + x, where n * x < 2^(digits-1), the
+   // product is 2^(2*digits-2) + (x+n) * 2^(digits-1) + n * x, so the bits of n * x are exactly
+   // the bits rounded off, and the parity of x + n decides which way ties go.  Try ties, values
+   // either side of a tie, and values just above an exact result, with the difference moved
+   // through every bit position at the two ends, and through a sample of those in between:
+   //
+   cpp_int half = cpp_int(1) << (digits - 2);
+   for(unsigned n = 1; n <= 2; ++n)
+   {
+      T a = ldexp(T(cpp_int((cpp_int(1) << (digits - 1)) + n)), -digits);
+      cpp_int tie = half / n;
+      for(int j = 0; j < digits - 3; j += (j < 160) || (j > digits - 160) ? 1 : 37)
+      {
+         cpp_int bit = cpp_int(1) << j;
+         cpp_int low = bit > 1 ? cpp_int(ldexp(random_value<T>(), digits).template convert_to<cpp_int>() % (bit - 1)) : cpp_int(0);
+         cpp_int x[] = { tie, tie + bit, tie - bit, tie + bit - low, tie - bit + low, bit, bit + low, 2 * tie - bit + low };
+         for(unsigned k = 0; k < sizeof(x) / sizeof(x[0]); ++k)
+         {
+            T b = ldexp(T(cpp_int((cpp_int(1) << (digits - 1)) + x[k])), -digits);
+            check_product(a, b);
+            check_product(b, a);
+            check_product(T(ldexp(a, 7)), T(ldexp(b, -3)));
+         }
+      }
+   }
+   //
+   // Products of all ones, which carry all the way up, and of powers of two:
+   //
+   T ones = 1 - ldexp(T(1), -digits);
+   check_product(ones, ones);
+   check_product(ones, T(ones - ldexp(T(1), 1 - digits)));
+   check_product(ones, T(0.5));
+   check_product(T(3), T(T(1) / 3));
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_bin_float_50>();
+   test<cpp_bin_float_100>();
+   test<number<cpp_bin_float<256, digit_base_2> > >();
+   test<number<cpp_bin_float<300> > >();
+   test<number<cpp_bin_float<1000> > >();
+   test<number<cpp_bin_float<3000> > >();
+   test<number<cpp_bin_float<100, digit_base_10, std::allocator<char> > > >();
+   test<number<cpp_bin_float<3000, digit_base_10, std::allocator<char> > > >();
+
+   return boost::report_errors();
+}
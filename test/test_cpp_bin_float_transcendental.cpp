@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// cpp_bin_float evaluates exp, log, pow, sin, cos and atan in fixed point with guard bits and
+// rounds once, so the results should be correctly rounded in all but the rarest cases.  Compare
+// them with the generic code running on a cpp_dec_float with more than twice the digits.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+template <class T>
+struct reference_type
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_dec_float<std::numeric_limits<T>::digits10 * 2 + 30> > type;
+};
+
+template <class T>
+T random_value(int min_exp, int max_exp)
+{
+   T result = 0;
+   int bits = 0;
+   for(; bits < std::numeric_limits<T>::digits; bits += 32)
+      result = ldexp(result, 32) + gen();
+   result = ldexp(result, min_exp + static_cast<int>(gen() % (max_exp - min_exp + 1)) - bits);
+   return gen() & 1 ? T(-result) : result;
+}
+
+template <class T>
+void check_result(const char* name, const T& x, const T& result, const typename reference_type<T>::type& expected)
+{
+   typedef typename reference_type<T>::type ref_type;
+   if(!(boost::math::isnormal)(T(expected)))
+   {
+      // Zero, or out of the exponent range of T:
+      BOOST_CHECK_EQUAL(result, T(expected));
+      return;
+   }
+   int e;
+   frexp(T(expected), &e);
+   ref_type ulp = ldexp(ref_type(1), e - std::numeric_limits<T>::digits);
+   ref_type err = abs(ref_type(result) - expected) / ulp;
+   if(err > 0.5001)
+   {
+      BOOST_ERROR("Result is not correctly rounded");
+      std::cout << name << "(" << x.str(0, std::ios_base::scientific) << ") = " << result.str(0, std::ios_base::scientific)
+         << ", error " << err.str(5) << " ulp" << std::endl;
+   }
+}
+
+template <class T>
+void test(unsigned count)
+{
+   typedef typename reference_type<T>::type ref_type;
+   const T a(1.2345);
+   for(unsigned i = 0; i < count; ++i)
+   {
+      T x = random_value<T>(-12, 12);
+      T ax = abs(x);
+      check_result("exp", x, T(exp(x)), ref_type(exp(ref_type(x))));
+      check_result("log", ax, T(log(ax)), ref_type(log(ref_type(ax))));
+      check_result("pow", ax, T(pow(ax, a)), ref_type(pow(ref_type(ax), ref_type(a))));
+      check_result("sin", x, T(sin(x)), ref_type(sin(ref_type(x))));
+      check_result("cos", x, T(cos(x)), ref_type(cos(ref_type(x))));
+      check_result("atan", x, T(atan(x)), ref_type(atan(ref_type(x))));
+      //
+      // Small and large arguments, and values of log close to 1:
+      //
+      x = random_value<T>(-200, -20);
+      ax = abs(x);
+      check_result("exp", x, T(exp(x)), ref_type(exp(ref_type(x))));
+      check_result("sin", x, T(sin(x)), ref_type(sin(ref_type(x))));
+      check_result("cos", x, T(cos(x)), ref_type(cos(ref_type(x))));
+      check_result("atan", x, T(atan(x)), ref_type(atan(ref_type(x))));
+      check_result("log", T(1 + ax), T(log(T(1 + ax))), ref_type(log(ref_type(T(1 + ax)))));
+      check_result("log", T(1 - ax), T(log(T(1 - ax))), ref_type(log(ref_type(T(1 - ax)))));
+      x = random_value<T>(12, 20);
+      ax = abs(x);
+      check_result("log", ax, T(log(ax)), ref_type(log(ref_type(ax))));
+      check_result("sin", x, T(sin(x)), ref_type(sin(ref_type(x))));
+      check_result("cos", x, T(cos(x)), ref_type(cos(ref_type(x))));
+      check_result("atan", x, T(atan(x)), ref_type(atan(ref_type(x))));
+      check_result("pow", ax, T(pow(ax, T(-a))), ref_type(pow(ref_type(ax), ref_type(-a))));
+   }
+   //
+   // Arguments close to multiples of pi/2, where the reduction cancels:
+   //
+   T half_pi = boost::math::constants::half_pi<T>();
+   for(int k = 1; k < 50; ++k)
+   {
+      T x = half_pi * k;
+      check_result("sin", x, T(sin(x)), ref_type(sin(ref_type(x))));
+      check_result("cos", x, T(cos(x)), ref_type(cos(ref_type(x))));
+   }
+   //
+   // Special values:
+   //
+   BOOST_CHECK_EQUAL(exp(T(0)), 1);
+   BOOST_CHECK_EQUAL(log(T(1)), 0);
+   BOOST_CHECK_EQUAL(sin(T(0)), 0);
+   BOOST_CHECK_EQUAL(cos(T(0)), 1);
+   BOOST_CHECK_EQUAL(atan(T(0)), 0);
+   BOOST_CHECK_EQUAL(pow(T(2), T(10)), 1024);
+   BOOST_CHECK_EQUAL(pow(T(9), T(0.5)), 3);
+   BOOST_CHECK_EQUAL(log(T(8)), 3 * boost::math::constants::ln_two<T>());
+   BOOST_CHECK_EQUAL(atan(std::numeric_limits<T>::infinity()), half_pi);
+   BOOST_CHECK_EQUAL(atan(T(1)), T(half_pi / 2));
+   BOOST_CHECK_EQUAL(exp(-std::numeric_limits<T>::infinity()), 0);
+   BOOST_CHECK_EQUAL(exp(T((std::numeric_limits<T>::max)())), std::numeric_limits<T>::infinity());
+   BOOST_CHECK_EQUAL(exp(T(-(std::numeric_limits<T>::max)())), 0);
+   BOOST_CHECK(boost::math::isnan(log(T(-1))));
+   BOOST_CHECK(boost::math::isinf(log(T(0))));
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_bin_float_50>(300);
+   test<cpp_bin_float_quad>(300);
+   test<number<cpp_bin_float<24, digit_base_2> > >(300);
+   test<number<cpp_bin_float<100, digit_base_10, std::allocator<char> > > >(100);
+   test<number<cpp_bin_float<300> > >(20);
+
+   return boost::report_errors();
+}
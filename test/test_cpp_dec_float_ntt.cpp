@@ -0,0 +1,77 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+
+//
+// Tests cpp_dec_float multiplication at precisions high enough to use the
+// number theoretic transform, including those beyond the 14400 digit limit
+// of the schoolbook method.  Integer products are exact, so we can compare
+// against cpp_int.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+std::string generate_random_digits(unsigned digits)
+{
+   std::string result(1, static_cast<char>('1' + gen() % 9));
+   for(unsigned i = 1; i < digits; ++i)
+      result += static_cast<char>('0' + gen() % 10);
+   return result;
+}
+
+template <unsigned Digits10>
+void test()
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_dec_float<Digits10> > mp_type;
+
+   std::cout << "Testing precision " << Digits10 << std::endl;
+
+   for(unsigned i = 0; i < 5; ++i)
+   {
+      // Each product has fewer digits than the precision, so must be exact:
+      std::string sa = generate_random_digits(Digits10 / 2 - gen() % 100);
+      std::string sb = generate_random_digits(Digits10 / 2 - gen() % 100);
+      mp_type a(sa), b(sb);
+      boost::multiprecision::cpp_int ia(sa), ib(sb);
+
+      BOOST_CHECK_EQUAL(mp_type(a * b), mp_type(boost::multiprecision::cpp_int(ia * ib).str()));
+      BOOST_CHECK_EQUAL(mp_type(a * -b), mp_type(boost::multiprecision::cpp_int(ia * -ib).str()));
+      BOOST_CHECK_EQUAL(mp_type(a * a), mp_type(boost::multiprecision::cpp_int(ia * ia).str()));
+      // Scaling by a power of 10 shifts the elements, but leaves the product unchanged:
+      mp_type sa10 = a / 1000;
+      mp_type sb10 = b * 100000000;
+      BOOST_CHECK_EQUAL(mp_type(sa10 * sb10), mp_type(boost::multiprecision::cpp_int(ia * ib * 100000).str()));
+      a *= b;
+      BOOST_CHECK_EQUAL(a, mp_type(boost::multiprecision::cpp_int(ia * ib).str()));
+   }
+   //
+   // Full precision values, the result is rounded so check the relative error:
+   //
+   mp_type eps = std::numeric_limits<mp_type>::epsilon();
+   mp_type two = 2;
+   mp_type root2 = sqrt(two);
+   BOOST_CHECK(abs(root2 * root2 - two) < eps * 4);
+   mp_type third = mp_type(1) / 3;
+   BOOST_CHECK(abs(third * 3 - 1) < eps * 4);
+   BOOST_CHECK(abs(third * third * 9 - 1) < eps * 4);
+}
+
+int main()
+{
+   test<3000>();
+   test<10000>();
+   test<20000>();
+   test<50000>();
+   return boost::report_errors();
+}
@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compare the results of division to gmp, for sizes which exercise Knuth's algorithm D,
+// Burnikel-Ziegler division and Newton reciprocal division, and for both arbitrary and
+// fixed precision types.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+boost::multiprecision::mpz_int generate_random(unsigned bits_wanted)
+{
+   boost::multiprecision::mpz_int result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   return result;
+}
+
+//
+// Conversion from gmp via hex strings, which is fast for large values:
+//
+template <class T>
+T from_mpz(const boost::multiprecision::mpz_int& val)
+{
+   T result(boost::multiprecision::mpz_int(abs(val)).str(0, std::ios_base::hex | std::ios_base::showbase));
+   if(val < 0)
+      result = 0 - result;
+   return result;
+}
+
+template <class T>
+void test_value(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b)
+{
+   using boost::multiprecision::mpz_int;
+   T x(from_mpz<T>(a)), y(from_mpz<T>(b));
+   T q(from_mpz<T>(mpz_int(a / b))), r(from_mpz<T>(mpz_int(a % b)));
+   BOOST_CHECK_EQUAL(T(x / y), q);
+   BOOST_CHECK_EQUAL(T(x % y), r);
+   T q2, r2;
+   divide_qr(x, y, q2, r2);
+   BOOST_CHECK_EQUAL(q2, q);
+   BOOST_CHECK_EQUAL(r2, r);
+   // Aliased arguments:
+   T z(x);
+   z /= y;
+   BOOST_CHECK_EQUAL(z, q);
+   z = x;
+   z %= y;
+   BOOST_CHECK_EQUAL(z, r);
+   z = y;
+   z = x / z;
+   BOOST_CHECK_EQUAL(z, q);
+}
+
+template <class T>
+void test_sizes(unsigned max_bits, bool is_signed)
+{
+   //
+   // Divisors from 2 limbs upwards, with quotients both shorter and longer than the divisor:
+   //
+   for(unsigned bits = 128; bits <= max_bits; bits = bits * 3 / 2)
+   {
+      for(unsigned qbits = 64; bits + qbits <= max_bits; qbits = qbits * 2 + 64)
+      {
+         for(unsigned i = 0; i < 3; ++i)
+         {
+            boost::multiprecision::mpz_int b = generate_random(bits - gen() % 64);
+            if(b == 0)
+               b = 1;
+            test_value<T>(generate_random(bits + qbits), b);
+            if(is_signed)
+            {
+               test_value<T>(-generate_random(bits + qbits), b);
+               test_value<T>(generate_random(bits + qbits), -b);
+            }
+         }
+         //
+         // Values with all bits set, these trigger the rare corrections to the quotient:
+         //
+         boost::multiprecision::mpz_int b = (boost::multiprecision::mpz_int(1) << bits) - 1;
+         test_value<T>((boost::multiprecision::mpz_int(1) << (bits + qbits)) - 1, b);
+         test_value<T>((boost::multiprecision::mpz_int(1) << (bits + qbits)) - 1, b - (b >> 64));
+         test_value<T>(b * ((boost::multiprecision::mpz_int(1) << qbits) - 1), b);
+      }
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test_sizes<cpp_int>(40000, true);
+   test_sizes<number<cpp_int_backend<1024, 1024, unsigned_magnitude, unchecked, void> > >(1024, false);
+   test_sizes<number<cpp_int_backend<8192, 8192, signed_magnitude, unchecked, void> > >(8192, true);
+   test_sizes<number<cpp_int_backend<16384, 16384, unsigned_magnitude, checked, void> > >(16384, false);
+   test_sizes<number<cpp_int_backend<0, 4096, signed_magnitude, checked> > >(4096, true);
+   //
+   // Divisors large enough for Newton division:
+   //
+   test_value<cpp_int>(generate_random(2200000), generate_random(1100000));
+   test_value<cpp_int>(generate_random(3000000), generate_random(1100000) + 1);
+   test_value<cpp_int>((mpz_int(1) << 2200000) - 1, (mpz_int(1) << 1100000) - 1);
+   BOOST_CHECK_THROW(cpp_int(cpp_int(cpp_int(1) << 10000) / cpp_int(0)), std::overflow_error);
+
+   return boost::report_errors();
+}
@@ -0,0 +1,115 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compare division by a divisor<>, and by single limb values (which use a precomputed
+// reciprocal internally), against gmp, for divisors of every size from one limb to beyond
+// BOOST_MP_BZ_DIVISION_CUTOFF, and for both arbitrary and fixed precision types.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+boost::multiprecision::mpz_int generate_random(unsigned bits_wanted)
+{
+   boost::multiprecision::mpz_int result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   // Vary the position of the most significant bit, and so the normalization shift:
+   result >>= gen() % 32;
+   result &= (boost::multiprecision::mpz_int(1) << bits_wanted) - 1;
+   return result == 0 ? boost::multiprecision::mpz_int(1) : result;
+}
+
+template <class T>
+void test_values(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b)
+{
+   using boost::multiprecision::mpz_int;
+   T x(a.str()), y(b.str());
+   boost::multiprecision::divisor<T> d(y);
+   BOOST_CHECK_EQUAL(d.value(), y);
+   T q = x / d;
+   T r = x % d;
+   BOOST_CHECK_EQUAL(q.str(), mpz_int(a / b).str());
+   BOOST_CHECK_EQUAL(r.str(), mpz_int(a % b).str());
+   T q2, r2;
+   divide_qr(x, d, q2, r2);
+   BOOST_CHECK_EQUAL(q2, q);
+   BOOST_CHECK_EQUAL(r2, r);
+   // The arguments may alias:
+   q2 = x;
+   divide_qr(q2, d, q2, r2);
+   BOOST_CHECK_EQUAL(q2, q);
+   BOOST_CHECK_EQUAL(r2, r);
+   // And an expression template is converted first:
+   BOOST_CHECK_EQUAL(T((x + 0) / d), q);
+}
+
+template <class T>
+void test_sizes(unsigned max_bits, bool is_signed)
+{
+   using boost::multiprecision::mpz_int;
+   for(unsigned ybits = 8; ybits <= max_bits; ybits = ybits * 3 / 2)
+   {
+      for(unsigned xbits = ybits / 2; xbits <= max_bits; xbits = xbits * 2)
+      {
+         for(unsigned i = 0; i < 10; ++i)
+         {
+            mpz_int a = generate_random(xbits);
+            mpz_int b = generate_random(ybits);
+            test_values<T>(a, b);
+            if(is_signed)
+            {
+               test_values<T>(mpz_int(-a), b);
+               test_values<T>(a, mpz_int(-b));
+               test_values<T>(mpz_int(-a), mpz_int(-b));
+            }
+            //
+            // Division by a single limb, which is also where integer_modulus goes:
+            //
+            boost::multiprecision::limb_type l = b.convert_to<boost::multiprecision::limb_type>();
+            if(l)
+            {
+               T x(a.str());
+               BOOST_CHECK_EQUAL(T(x / l).str(), mpz_int(a / l).str());
+               BOOST_CHECK_EQUAL(T(x % l).str(), mpz_int(a % l).str());
+               BOOST_CHECK_EQUAL(integer_modulus(x, l), integer_modulus(a, l));
+            }
+         }
+      }
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test_sizes<cpp_int>(30000, true);
+   test_sizes<number<cpp_int_backend<>, et_off> >(2000, true);
+   test_sizes<int512_t>(511, true);
+   test_sizes<number<cpp_int_backend<500, 500, signed_magnitude, unchecked, void> > >(499, true);
+   test_sizes<checked_uint1024_t>(1024, false);
+   test_sizes<int128_t>(127, true);
+   //
+   // Long runs of ones, where the quotient estimate is most often wrong:
+   //
+   cpp_int m = (cpp_int(1) << 5000) - 1;
+   for(unsigned bits = 64; bits < 2000; bits += 61)
+      test_values<cpp_int>(mpz_int(m.str()), mpz_int(cpp_int((cpp_int(1) << bits) - 1).str()));
+
+   BOOST_CHECK_THROW(divisor<cpp_int>(cpp_int(0)), std::overflow_error);
+
+   return boost::report_errors();
+}
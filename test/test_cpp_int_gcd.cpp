@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compare the results of gcd and gcdext to gmp, for sizes which exercise the binary,
+// Lehmer and half-GCD algorithms, and for both arbitrary and fixed precision types.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+boost::multiprecision::mpz_int generate_random(unsigned bits_wanted)
+{
+   boost::multiprecision::mpz_int result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   return result;
+}
+
+//
+// Conversion from gmp via hex strings, which is fast for large values:
+//
+template <class T>
+T from_mpz(const boost::multiprecision::mpz_int& val)
+{
+   T result(boost::multiprecision::mpz_int(abs(val)).str(0, std::ios_base::hex | std::ios_base::showbase));
+   if(val < 0)
+      result = 0 - result;
+   return result;
+}
+
+template <class T>
+boost::multiprecision::mpz_int to_mpz(const T& val)
+{
+   boost::multiprecision::mpz_int result(T(abs(val)).str(0, std::ios_base::hex | std::ios_base::showbase));
+   return val < 0 ? boost::multiprecision::mpz_int(-result) : result;
+}
+
+template <class T>
+void test_gcdext(const T& x, const T& y, const T& g, const boost::mpl::true_&)
+{
+   using boost::multiprecision::mpz_int;
+   T g2, s, t;
+   gcdext(x, y, g2, s, t);
+   BOOST_CHECK_EQUAL(g2, g);
+   // Check the result with gmp, as x * s may overflow a fixed precision type:
+   mpz_int a(to_mpz(x)), b(to_mpz(y)), ms(to_mpz(s)), mt(to_mpz(t)), mg(to_mpz(g));
+   BOOST_CHECK_EQUAL(mpz_int(a * ms + b * mt), mg);
+   // The cofactors are the smallest possible:
+   if((g != 0) && (abs(x) != g) && (abs(y) != g))
+   {
+      BOOST_CHECK(mpz_int(2 * abs(ms)) <= mpz_int(abs(b) / mg));
+      BOOST_CHECK(mpz_int(2 * abs(mt)) <= mpz_int(abs(a) / mg));
+   }
+   // Aliased arguments:
+   T u(x), v(y);
+   gcdext(u, v, u, v, t);
+   BOOST_CHECK_EQUAL(u, g);
+   BOOST_CHECK_EQUAL(v, s);
+}
+
+template <class T>
+void test_gcdext(const T&, const T&, const T&, const boost::mpl::false_&)
+{
+}
+
+template <class T>
+void test_value(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& b)
+{
+   using boost::multiprecision::mpz_int;
+   T x(from_mpz<T>(a)), y(from_mpz<T>(b));
+   T g(from_mpz<T>(mpz_int(gcd(a, b))));
+   BOOST_CHECK_EQUAL(T(gcd(x, y)), g);
+   BOOST_CHECK_EQUAL(T(gcd(y, x)), g);
+   if(!std::numeric_limits<T>::is_bounded)
+      BOOST_CHECK_EQUAL(T(lcm(x, y)), from_mpz<T>(mpz_int(lcm(a, b))));
+   test_gcdext(x, y, g, boost::mpl::bool_<boost::multiprecision::is_signed_number<T>::value>());
+}
+
+template <class T>
+void test_sizes(unsigned max_bits, bool is_signed)
+{
+   using boost::multiprecision::mpz_int;
+   for(unsigned bits = 64; bits <= max_bits; bits = bits * 3 / 2)
+   {
+      for(unsigned i = 0; i < 3; ++i)
+      {
+         mpz_int a = generate_random(bits);
+         mpz_int b = generate_random(bits - gen() % 64);
+         test_value<T>(a, b);
+         // Values of quite different sizes:
+         test_value<T>(a, generate_random(bits / 3 + 32));
+         test_value<T>(a, gen());
+         // A large common factor:
+         mpz_int c = generate_random(bits / 2 - 32);
+         test_value<T>(mpz_int(generate_random(bits / 2) * c), mpz_int(generate_random(bits / 2) * c));
+         test_value<T>(mpz_int(c * generate_random(bits / 3)), c);
+         if(is_signed)
+         {
+            test_value<T>(-a, b);
+            test_value<T>(a, -b);
+            test_value<T>(-a, -b);
+         }
+      }
+      //
+      // Consecutive Fibonacci numbers, where every quotient is 1:
+      //
+      mpz_int f1 = 1, f2 = 1;
+      while(msb(f2) + 2 < bits)
+      {
+         f1 += f2;
+         f1.swap(f2);
+      }
+      test_value<T>(f2, f1);
+      // Powers of two, equal values and zero:
+      mpz_int p = mpz_int(1) << (bits - 1);
+      test_value<T>(p, mpz_int(p >> 17));
+      test_value<T>(mpz_int(p - 1), mpz_int(p - 1));
+      test_value<T>(mpz_int(p - 1), 0);
+      test_value<T>(0, mpz_int(p - 1));
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test_sizes<cpp_int>(30000, true);
+   test_sizes<number<cpp_int_backend<1024, 1024, unsigned_magnitude, unchecked, void> > >(1024, false);
+   test_sizes<number<cpp_int_backend<8192, 8192, signed_magnitude, unchecked, void> > >(8192, true);
+   test_sizes<number<cpp_int_backend<0, 4096, signed_magnitude, checked> > >(4096, true);
+   test_value<cpp_int>(0, 0);
+   //
+   // Values large enough for several levels of half-GCD recursion:
+   //
+   mpz_int c = generate_random(100000);
+   test_value<cpp_int>(generate_random(300000), generate_random(300000));
+   test_value<cpp_int>(mpz_int(generate_random(200000) * c), mpz_int(generate_random(200000) * c));
+
+   return boost::report_errors();
+}
@@ -0,0 +1,157 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of the Karatsuba, Toom-3 and NTT multiplication routines to gmp,
+// values are sized either side of the various cutoff points.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/uniform_int.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+//
+// Returns a random hex string of the requested number of bits, when "ones" is set
+// the value is all ones, which stresses carry propagation:
+//
+std::string generate_random(unsigned bits_wanted, bool ones = false)
+{
+   static const char digits[] = "0123456789abcdef";
+   std::string result("0x");
+   unsigned n = (bits_wanted + 3) / 4;
+   for(unsigned i = 0; i < n; ++i)
+      result += ones ? 'f' : digits[gen() % 16];
+   return result;
+}
+
+//
+// Conversion from gmp via hex strings, which is fast for large values.
+// Only used for positive values:
+//
+template <class T>
+T from_mpz(const boost::multiprecision::mpz_int& val)
+{
+   return T(val.str(0, std::ios_base::hex | std::ios_base::showbase));
+}
+
+template <class T>
+void test_value(const std::string& a, const std::string& b)
+{
+   T x(a), y(b);
+   boost::multiprecision::mpz_int z1(a), z2(b);
+
+   BOOST_CHECK_EQUAL(T(x * y), from_mpz<T>(z1 * z2));
+   T p = x * -y;
+   BOOST_CHECK(p < 0);
+   BOOST_CHECK_EQUAL(T(-p), from_mpz<T>(z1 * z2));
+   BOOST_CHECK_EQUAL(T(x * x), from_mpz<T>(z1 * z1));
+   // In place squaring, result and argument are the same object:
+   T s(-x);
+   s *= s;
+   BOOST_CHECK_EQUAL(s, from_mpz<T>(z1 * z1));
+   x *= y;
+   BOOST_CHECK_EQUAL(x, from_mpz<T>(z1 * z2));
+}
+
+template <class T>
+void test_fixed(unsigned bits)
+{
+   //
+   // Truncating multiplication in a fixed width type, the result must match
+   // gmp modulo 2^bits:
+   //
+   boost::multiprecision::mpz_int mask(1);
+   mask <<= bits;
+   --mask;
+   for(unsigned i = 0; i < 20; ++i)
+   {
+      std::string a = generate_random(bits / 2 + gen() % (bits / 2));
+      std::string b = generate_random(bits / 2 + gen() % (bits / 2));
+      T x(a), y(b);
+      boost::multiprecision::mpz_int z1(a), z2(b);
+      BOOST_CHECK_EQUAL(T(x * y), from_mpz<T>((z1 * z2) & mask));
+   }
+}
+
+template <class T>
+void test_checked(unsigned bits)
+{
+   std::string a = generate_random(bits / 2 + 64);
+   std::string b = generate_random(bits / 2 + 64);
+   T x(a), y(b);
+   BOOST_CHECK_THROW(T(x * y), std::overflow_error);
+   a = generate_random(bits / 2 - 1);
+   b = generate_random(bits / 2 - 1);
+   x = T(a);
+   y = T(b);
+   boost::multiprecision::mpz_int z1(a), z2(b);
+   BOOST_CHECK_EQUAL(T(x * y), from_mpz<T>(z1 * z2));
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   static const unsigned limb_bits = sizeof(limb_type) * CHAR_BIT;
+   //
+   // Balanced values either side of the cutoffs, and well above them:
+   //
+   unsigned sizes[] = { 2, 7, backends::karatsuba_cutoff - 1, backends::karatsuba_cutoff, backends::karatsuba_cutoff + 1, 2 * backends::karatsuba_cutoff + 1,
+      backends::toom3_cutoff - 1, backends::toom3_cutoff, backends::toom3_cutoff + 1, 3 * backends::toom3_cutoff + 2, 1000, 1601 };
+   for(unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i)
+   {
+      std::cout << "Testing balanced values of " << sizes[i] << " limbs" << std::endl;
+      for(unsigned j = 0; j < 5; ++j)
+      {
+         test_value<cpp_int>(generate_random(sizes[i] * limb_bits), generate_random(sizes[i] * limb_bits));
+         // Values that are not an exact number of limbs:
+         test_value<cpp_int>(generate_random(sizes[i] * limb_bits - gen() % limb_bits), generate_random(sizes[i] * limb_bits - gen() % limb_bits));
+      }
+      test_value<cpp_int>(generate_random(sizes[i] * limb_bits, true), generate_random(sizes[i] * limb_bits, true));
+      test_value<cpp_int>(generate_random(sizes[i] * limb_bits, true), generate_random(sizes[i] * limb_bits));
+   }
+   //
+   // Unbalanced values:
+   //
+   std::cout << "Testing unbalanced values" << std::endl;
+   for(unsigned i = 0; i < 100; ++i)
+   {
+      unsigned small = backends::karatsuba_cutoff + gen() % (2 * backends::toom3_cutoff);
+      unsigned large = small + gen() % (5 * small);
+      test_value<cpp_int>(generate_random(large * limb_bits - gen() % limb_bits), generate_random(small * limb_bits - gen() % limb_bits));
+      test_value<cpp_int>(generate_random(small * limb_bits), generate_random(large * limb_bits));
+   }
+   test_value<cpp_int>(generate_random(5000 * limb_bits, true), generate_random(backends::karatsuba_cutoff * limb_bits, true));
+   //
+   // NTT multiplication:
+   //
+   std::cout << "Testing NTT multiplication" << std::endl;
+   test_value<cpp_int>(generate_random(backends::ntt_cutoff * limb_bits - 1), generate_random(backends::ntt_cutoff * limb_bits - 1));
+   test_value<cpp_int>(generate_random(backends::ntt_cutoff * limb_bits), generate_random(backends::ntt_cutoff * limb_bits));
+   test_value<cpp_int>(generate_random(backends::ntt_cutoff * limb_bits, true), generate_random(backends::ntt_cutoff * limb_bits, true));
+   test_value<cpp_int>(generate_random(3 * backends::ntt_cutoff * limb_bits + 17), generate_random(backends::ntt_cutoff * limb_bits + 5));
+   //
+   // Fixed precision types, both truncating and checked:
+   //
+   std::cout << "Testing fixed precision types" << std::endl;
+   test_fixed<number<cpp_int_backend<8192, 8192, unsigned_magnitude, unchecked, void> > >(8192);
+   test_fixed<number<cpp_int_backend<65536, 65536, unsigned_magnitude, unchecked, void> > >(65536);
+   test_fixed<number<cpp_int_backend<8192, 8192, signed_magnitude, unchecked, void> > >(8192);
+   test_fixed<number<cpp_int_backend<8000, 8000, unsigned_magnitude, unchecked, void> > >(8000);
+   test_value<number<cpp_int_backend<65536, 65536, signed_magnitude, checked, void> > >(generate_random(30000), generate_random(30000));
+   test_checked<number<cpp_int_backend<16384, 16384, signed_magnitude, checked, void> > >(16384);
+   test_checked<number<cpp_int_backend<0, 16384, signed_magnitude, checked> > >(16384);
+   test_value<number<cpp_int_backend<0, 100000, signed_magnitude, checked> > >(generate_random(40000), generate_random(40000));
+
+   return boost::report_errors();
+}
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Compare the results of the Montgomery and Barrett powm routines to gmp, for both
+// odd and even moduli over a range of sizes, and for both arbitrary and fixed precision types.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+boost::multiprecision::mpz_int generate_random(unsigned bits_wanted)
+{
+   boost::multiprecision::mpz_int result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   return result;
+}
+
+//
+// Conversion from gmp via hex strings, which is fast for large values:
+//
+template <class T>
+T from_mpz(const boost::multiprecision::mpz_int& val)
+{
+   T result(boost::multiprecision::mpz_int(abs(val)).str(0, std::ios_base::hex | std::ios_base::showbase));
+   if(val < 0)
+      result = 0 - result;
+   return result;
+}
+
+template <class T>
+void test_value(const boost::multiprecision::mpz_int& a, const boost::multiprecision::mpz_int& p, const boost::multiprecision::mpz_int& m)
+{
+   using boost::multiprecision::mpz_int;
+   //
+   // As with the % operator, the result takes the sign of a^p, and the sign of m is ignored:
+   //
+   mpz_int r = powm(mpz_int(abs(a)), p, mpz_int(abs(m)));
+   if((a < 0) && bit_test(p, 0))
+      r = -r;
+   T x(from_mpz<T>(a)), e(from_mpz<T>(p)), mod(from_mpz<T>(m));
+   BOOST_CHECK_EQUAL(T(powm(x, e, mod)), from_mpz<T>(r));
+   if(p <= (std::numeric_limits<unsigned>::max)())
+   {
+      BOOST_CHECK_EQUAL(T(powm(x, p.convert_to<unsigned>(), mod)), from_mpz<T>(r));
+   }
+   // Aliased arguments:
+   T y(x);
+   y = powm(y, e, mod);
+   BOOST_CHECK_EQUAL(y, from_mpz<T>(r));
+   y = mod;
+   y = powm(x, e, y);
+   BOOST_CHECK_EQUAL(y, from_mpz<T>(r));
+}
+
+template <class T>
+void test_sizes(unsigned max_bits, bool is_signed)
+{
+   for(unsigned bits = 64; bits <= max_bits; bits = bits * 3 / 2)
+   {
+      for(unsigned i = 0; i < 10; ++i)
+      {
+         boost::multiprecision::mpz_int m = generate_random(bits - gen() % 32);
+         if(i & 1)
+            m |= 1;
+         else
+            m &= ~boost::multiprecision::mpz_int(1);
+         if(m == 0)
+            m = 2;
+         test_value<T>(generate_random(bits), generate_random(bits), m);
+         test_value<T>(generate_random(bits / 2), generate_random(i < 5 ? 10 : 40), m);
+         if(is_signed)
+         {
+            test_value<T>(-generate_random(bits), generate_random(bits) | 1, m);
+            test_value<T>(generate_random(bits), generate_random(bits), -m);
+         }
+      }
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test_sizes<cpp_int>(3000, true);
+   test_sizes<number<cpp_int_backend<256, 256, unsigned_magnitude, unchecked, void> > >(256, false);
+   test_sizes<number<cpp_int_backend<1024, 1024, signed_magnitude, unchecked, void> > >(1024, true);
+   test_sizes<number<cpp_int_backend<4096, 4096, unsigned_magnitude, checked, void> > >(4096, false);
+   test_sizes<number<cpp_int_backend<0, 2048, signed_magnitude, checked> > >(2048, true);
+   //
+   // Special cases, powers of 2 and 1 as the modulus, and zero exponents:
+   //
+   test_value<cpp_int>(generate_random(300), generate_random(300), mpz_int(1) << 256);
+   test_value<cpp_int>(generate_random(300), generate_random(300), mpz_int(1) << 255);
+   test_value<cpp_int>(generate_random(300), generate_random(300), 1);
+   test_value<cpp_int>(generate_random(300), 0, generate_random(300));
+   test_value<cpp_int>(0, generate_random(300), generate_random(300));
+   test_value<cpp_int>(generate_random(300), generate_random(300), (mpz_int(1) << 256) - 1);
+   BOOST_CHECK_THROW(cpp_int(powm(cpp_int(3), cpp_int(5), cpp_int(0))), std::overflow_error);
+   BOOST_CHECK_THROW(cpp_int(powm(cpp_int(3), cpp_int(-5), cpp_int(7))), std::runtime_error);
+
+   return boost::report_errors();
+}
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compare decimal string conversions to and from gmp, for sizes either side of
+// BOOST_MP_RADIX_OUTPUT_CUTOFF and BOOST_MP_RADIX_INPUT_CUTOFF, and for both arbitrary
+// and fixed precision types.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/gmp.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <sstream>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+boost::multiprecision::mpz_int generate_random(unsigned bits_wanted)
+{
+   boost::multiprecision::mpz_int result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   return result;
+}
+
+template <class T>
+void test_value(const boost::multiprecision::mpz_int& a)
+{
+   std::string s = a.str();
+   T x(s);
+   BOOST_CHECK_EQUAL(x.str(), s);
+   // Check against a conversion via hex, which does not use the decimal code:
+   BOOST_CHECK_EQUAL(T(boost::multiprecision::mpz_int(abs(a)).str(0, std::ios_base::hex | std::ios_base::showbase)), T(abs(x)));
+   // Stream output goes via the same path:
+   std::stringstream ss;
+   ss << std::showpos << x;
+   BOOST_CHECK_EQUAL(ss.str(), a.str(0, std::ios_base::showpos));
+   ss.str("");
+   ss << std::noshowpos << x;
+   T y;
+   ss >> y;
+   BOOST_CHECK_EQUAL(x, y);
+}
+
+template <class T>
+void test_sizes(unsigned max_bits, bool is_signed)
+{
+   using boost::multiprecision::mpz_int;
+   for(unsigned bits = 64; bits <= max_bits; bits = bits * 5 / 4)
+   {
+      mpz_int a = generate_random(bits);
+      test_value<T>(a);
+      if(is_signed)
+         test_value<T>(mpz_int(-a));
+      // Values with long runs of zero or nine digits:
+      mpz_int p = pow(mpz_int(10), bits * 3 / 10);
+      test_value<T>(p);
+      test_value<T>(mpz_int(p - 1));
+      test_value<T>(mpz_int(p + 1));
+      test_value<T>(mpz_int(p * 7 + a % p));
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test_sizes<cpp_int>(300000, true);
+   test_sizes<number<cpp_int_backend<8192, 8192, unsigned_magnitude, unchecked, void> > >(8192, false);
+   test_sizes<number<cpp_int_backend<0, 8192, signed_magnitude, checked> > >(8192, true);
+   //
+   // A very large value, which uses many of the cached powers of ten:
+   //
+   test_value<cpp_int>(generate_random(2000000));
+   //
+   // Unchecked fixed precision types wrap on overflow, whichever method is used:
+   //
+   typedef number<cpp_int_backend<4096, 4096, unsigned_magnitude, unchecked, void> > fixed_type;
+   mpz_int big = generate_random(60000);
+   BOOST_CHECK_EQUAL(fixed_type(big.str()).str(), mpz_int(big % (mpz_int(1) << 4096)).str());
+   //
+   // Checked types throw on overflow:
+   //
+   typedef number<cpp_int_backend<4096, 4096, signed_magnitude, checked, void> > checked_type;
+   BOOST_CHECK_THROW(checked_type(big.str()), std::overflow_error);
+   //
+   // Invalid characters are detected anywhere in the string:
+   //
+   std::string s = big.str();
+   s[s.size() / 3] = 'a';
+   BOOST_CHECK_THROW(cpp_int(s.c_str()), std::runtime_error);
+   s = big.str() + "x";
+   BOOST_CHECK_THROW(cpp_int(s.c_str()), std::runtime_error);
+
+   return boost::report_errors();
+}
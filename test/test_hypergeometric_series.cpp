@@ -0,0 +1,124 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// The generic hypergeometric series sum by rectangular splitting when their parameters are
+// multiples of 1/2, and term by term otherwise.  Check both against closed forms evaluated by
+// cpp_bin_float's own functions at higher precision, including the series which terminate.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include "test.hpp"
+
+template <class T>
+struct reference_type
+{
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_bin_float<std::numeric_limits<T>::digits10 + 20> > type;
+};
+
+template <class T>
+void check_close(const char* name, const T& result, const typename reference_type<T>::type& expected, unsigned max_err)
+{
+   typedef typename reference_type<T>::type ref_type;
+   ref_type err = abs(ref_type(result) - expected) / abs(expected) / ref_type(std::numeric_limits<T>::epsilon());
+   if(err > max_err)
+   {
+      BOOST_ERROR("Series result is too far from the closed form");
+      std::cout << name << ": result " << result << " expected " << expected << " error " << err.str(5) << " eps" << std::endl;
+   }
+}
+
+template <class T>
+T hyp0F0(const T& x)
+{
+   T result;
+   boost::multiprecision::default_ops::hyp0F0(result.backend(), x.backend());
+   return result;
+}
+
+template <class T>
+T hyp1F0(const T& a, const T& x)
+{
+   T result;
+   boost::multiprecision::default_ops::hyp1F0(result.backend(), a.backend(), x.backend());
+   return result;
+}
+
+template <class T>
+T hyp0F1(const T& b, const T& x)
+{
+   T result;
+   boost::multiprecision::default_ops::hyp0F1(result.backend(), b.backend(), x.backend());
+   return result;
+}
+
+template <class T>
+T hyp2F1(const T& a, const T& b, const T& c, const T& x)
+{
+   T result;
+   boost::multiprecision::default_ops::hyp2F1(result.backend(), a.backend(), b.backend(), c.backend(), x.backend());
+   return result;
+}
+
+template <class T>
+void test()
+{
+   typedef typename reference_type<T>::type ref_type;
+   const T half = T(1) / 2;
+   const T three_halves = T(3) / 2;
+   const T third = T(1) / 3;
+
+   for(int i = -20; i <= 20; ++i)
+   {
+      if(i == 0)
+         continue;
+      T x = T(i) / 40;
+      ref_type rx(x);
+      check_close("hyp0F0", hyp0F0(x), ref_type(exp(rx)), 5);
+      T tiny = ldexp(x, -100);
+      check_close("hyp0F0", hyp0F0(tiny), ref_type(exp(ref_type(tiny))), 2);
+      // 1F0(a;;x) = (1 - x)^-a, for half integer a by rectangular splitting, otherwise term by term.
+      // These converge only geometrically, so keep |x| <= 1/4:
+      x /= 2;
+      rx = ref_type(x);
+      check_close("hyp1F0", hyp1F0(half, x), ref_type(pow(1 - rx, ref_type(-0.5))), 5);
+      check_close("hyp1F0", hyp1F0(T(T(-5) / 2), x), ref_type(pow(1 - rx, ref_type(2.5))), 5);
+      // The term by term sum loses a few more digits at high precision, as it always has:
+      check_close("hyp1F0", hyp1F0(third, x), ref_type(pow(1 - rx, ref_type(-third))), 30);
+      check_close("hyp1F0", hyp1F0(T(-0.7), x), ref_type(pow(1 - rx, ref_type(T(0.7)))), 30);
+      // 1F0(-3;;x) is a polynomial:
+      check_close("hyp1F0", hyp1F0(T(-3), x), ref_type(pow(1 - rx, 3)), 5);
+      // 0F1(;3/2;-x^2/4) = sin(x) / x, 0F1(;1/2;-x^2/4) = cos(x), and a parameter which is not a half integer:
+      T y = -x * x / 4;
+      check_close("hyp0F1", hyp0F1(three_halves, y), ref_type(sin(rx) / rx), 5);
+      check_close("hyp0F1", hyp0F1(half, y), ref_type(cos(rx)), 5);
+      check_close("hyp0F1", hyp0F1(T(-half), y), ref_type(cos(rx) + rx * sin(rx)), 5);
+      check_close("hyp0F1", hyp0F1(third, y), hyp0F1(ref_type(third), ref_type(y)), 5);
+      // 2F1(1/2,1/2;3/2;x^2) = asin(x) / x and 2F1(1,1/2;3/2;-x^2) = atan(x) / x:
+      check_close("hyp2F1", hyp2F1(half, half, three_halves, T(x * x)), ref_type(asin(rx) / rx), 5);
+      check_close("hyp2F1", hyp2F1(T(1), half, three_halves, T(-x * x)), ref_type(atan(rx) / rx), 5);
+      // 2F1(-3,b;b;x) = (1 - x)^3 terminates, whether b is a half integer or not:
+      check_close("hyp2F1", hyp2F1(T(-3), half, half, x), ref_type(pow(1 - rx, 3)), 5);
+      check_close("hyp2F1", hyp2F1(T(-3), third, third, x), ref_type(pow(1 - rx, 3)), 5);
+      // 2F1(1,1;2;x) = -log(1 - x) / x:
+      check_close("hyp2F1", hyp2F1(T(1), T(1), T(2), x), ref_type(-log(1 - rx) / rx), 10);
+   }
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_dec_float_50>();
+   test<number<cpp_dec_float<200> > >();
+   test<cpp_bin_float_50>();
+   test<number<cpp_bin_float<500>, et_off> >();
+
+   return boost::report_errors();
+}
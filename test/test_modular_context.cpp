@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+
+//
+// Tests for modular_context, results are compared to the same operations
+// performed with plain % arithmetic.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/integer.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#ifdef TEST_MPZ
+#include <boost/multiprecision/gmp.hpp>
+#endif
+#include <boost/random/mersenne_twister.hpp>
+#include <vector>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+template <class T>
+T generate_random(unsigned bits_wanted)
+{
+   T result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   return result;
+}
+
+template <class T>
+T mod(const T& a, const T& m)
+{
+   T r = a % m;
+   if(r < 0)
+      r += m;
+   return r;
+}
+
+//
+// Reference values are computed in type R, which must be wide enough to hold
+// the product of two values of type T:
+//
+template <class T, class R>
+void test_modulus(const T& m, unsigned bits)
+{
+   boost::multiprecision::modular_context<T> ctx(m);
+   R rm(m);
+   BOOST_CHECK_EQUAL(ctx.modulus(), m);
+   for(unsigned i = 0; i < 20; ++i)
+   {
+      T a = generate_random<T>(bits - gen() % 32);
+      T b = generate_random<T>(bits - gen() % 32);
+      T e = generate_random<T>(gen() % bits + 1);
+      T ra = ctx.to_residue(a);
+      T rb = ctx.to_residue(b);
+      BOOST_CHECK(ra < m);
+      BOOST_CHECK_EQUAL(ctx.from_residue(ra), mod(a, m));
+      BOOST_CHECK_EQUAL(ctx.from_residue(ctx.mulmod(ra, rb)), T(mod(R(R(a) * R(b)), rm)));
+      BOOST_CHECK_EQUAL(ctx.from_residue(ctx.sqrmod(ra)), T(mod(R(R(a) * R(a)), rm)));
+      BOOST_CHECK_EQUAL(ctx.from_residue(ctx.powm(ra, e)), T(powm(mod(a, m), e, m)));
+      BOOST_CHECK_EQUAL(ctx.from_residue(ctx.powm(ra, T(0))), T(mod(T(1), m)));
+      // In place versions:
+      T r(ra);
+      ctx.mulmod(r, r, rb);
+      BOOST_CHECK_EQUAL(r, ctx.mulmod(ra, rb));
+      r = ra;
+      ctx.sqrmod(r, r);
+      BOOST_CHECK_EQUAL(r, ctx.sqrmod(ra));
+      if(std::numeric_limits<T>::is_signed)
+      {
+         T na = 0 - a;
+         BOOST_CHECK_EQUAL(ctx.from_residue(ctx.to_residue(na)), mod(na, m));
+      }
+   }
+   //
+   // Batch conversion:
+   //
+   std::vector<T> v;
+   for(unsigned i = 0; i < 10; ++i)
+      v.push_back(generate_random<T>(bits - 1));
+   std::vector<T> w(v);
+   ctx.to_residues(w.begin(), w.end());
+   for(unsigned i = 0; i < v.size(); ++i)
+      BOOST_CHECK_EQUAL(w[i], ctx.to_residue(v[i]));
+   ctx.from_residues(w.begin(), w.end());
+   for(unsigned i = 0; i < v.size(); ++i)
+      BOOST_CHECK_EQUAL(w[i], mod(v[i], m));
+}
+
+template <class T, class R>
+void test(unsigned max_bits)
+{
+   for(unsigned bits = 64; bits <= max_bits; bits *= 2)
+   {
+      T m = generate_random<T>(bits);
+      bit_set(m, 0);
+      test_modulus<T, R>(m, bits);
+      bit_unset(m, 0);
+      test_modulus<T, R>(m, bits);
+   }
+   test_modulus<T, R>(T(1u), 64);
+   test_modulus<T, R>(T(2u), 64);
+   BOOST_CHECK_THROW(boost::multiprecision::modular_context<T>(T(0u)), std::runtime_error);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int, cpp_int>(4096);
+   test<number<cpp_int_backend<1024, 1024, unsigned_magnitude, unchecked, void> >, cpp_int>(1024);
+   test<number<cpp_int_backend<512, 512, signed_magnitude, checked, void> >, cpp_int>(512);
+   test<number<cpp_int_backend<0, 2048, signed_magnitude, checked> >, cpp_int>(2048);
+   test<uint128_t, cpp_int>(128);
+#ifdef TEST_MPZ
+   test<mpz_int, mpz_int>(2048);
+#endif
+   //
+   // Values which can't be residues, with more limbs than m or negative, are rejected:
+   //
+   modular_context<cpp_int> cctx(cpp_int((cpp_int(1) << 100) + 277));
+   BOOST_CHECK_THROW(cctx.mulmod(cpp_int(1) << 1000, cpp_int(3)), std::runtime_error);
+   BOOST_CHECK_THROW(cctx.sqrmod(cpp_int(-3)), std::runtime_error);
+   BOOST_CHECK_THROW(cctx.from_residue(cpp_int(1) << 1000), std::runtime_error);
+   BOOST_CHECK_THROW(cctx.powm(cpp_int(1) << 1000, cpp_int(3)), std::runtime_error);
+   //
+   // Builtin types:
+   //
+   modular_context<boost::uint64_t> ctx(18446744073709551557uLL);
+   BOOST_CHECK_EQUAL(ctx.mulmod(18446744073709551556uLL, 18446744073709551556uLL), 1u);
+   BOOST_CHECK_EQUAL(ctx.powm(3, 1000), powm(static_cast<boost::uint64_t>(3u), 1000u, 18446744073709551557uLL));
+   modular_context<int> ictx(7);
+   BOOST_CHECK_EQUAL(ictx.to_residue(-3), 4);
+
+   return boost::report_errors();
+}
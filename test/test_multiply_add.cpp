@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2013 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+
+//
+// Tests the fused multiply-add and multiply-subtract of cpp_int and cpp_dec_float,
+// r += a * b and r -= a * b, which accumulate the product straight into r.  The
+// results are compared with the product formed in a temporary and then added,
+// for every combination of signs, for values which cancel, and for arguments which
+// alias the result.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include "test.hpp"
+
+static boost::random::mt19937 gen;
+
+template <class T>
+T generate_random_int(unsigned bits_wanted)
+{
+   T result = 0;
+   unsigned bits = 1 + gen() % bits_wanted;
+   for(unsigned i = 0; i < bits; i += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   // Runs of ones make the carries and borrows propagate a long way:
+   if(gen() & 1u)
+   {
+      result <<= 128;
+      result -= 1;
+   }
+   return (gen() & 1u) ? T(-result) : result;
+}
+
+template <class T>
+void test_int_values(const T& a, const T& b, const T& c)
+{
+   T p = a * b;
+   T r = c;
+   r += a * b;
+   BOOST_CHECK_EQUAL(r, T(c + p));
+   r = c;
+   r -= a * b;
+   BOOST_CHECK_EQUAL(r, T(c - p));
+   // The product and the accumulator cancel exactly:
+   r = p;
+   r -= a * b;
+   BOOST_CHECK_EQUAL(r, 0);
+   r = -p;
+   r += a * b;
+   BOOST_CHECK_EQUAL(r, 0);
+   // Single limb multipliers:
+   long long l = static_cast<long long>(gen()) * ((gen() & 1u) ? 1 : -1);
+   unsigned long long ul = gen();
+   r = c;
+   r += a * l;
+   BOOST_CHECK_EQUAL(r, T(c + T(a * l)));
+   r = c;
+   r -= l * a;
+   BOOST_CHECK_EQUAL(r, T(c - T(a * l)));
+   r = c;
+   r += a * ul;
+   BOOST_CHECK_EQUAL(r, T(c + T(a * ul)));
+   r = c;
+   r -= a * ul;
+   BOOST_CHECK_EQUAL(r, T(c - T(a * ul)));
+   // The accumulator aliases one of the arguments:
+   r = a;
+   r += r * b;
+   BOOST_CHECK_EQUAL(r, T(a + p));
+   r = b;
+   r -= a * r;
+   BOOST_CHECK_EQUAL(r, T(b - p));
+}
+
+template <class T>
+void test_int(unsigned max_bits)
+{
+   for(unsigned i = 0; i < 2000; ++i)
+   {
+      unsigned bits = (i % 3 == 0) ? max_bits / 20 : (i % 3 == 1) ? max_bits / 3 : max_bits;
+      T a = generate_random_int<T>(bits);
+      T b = generate_random_int<T>(bits);
+      T c = generate_random_int<T>(2 * bits);
+      test_int_values(a, b, c);
+      test_int_values(a, b, T(0));
+   }
+}
+
+template <class T>
+T generate_random_float()
+{
+   T result = 0;
+   unsigned n = 1 + gen() % (std::numeric_limits<T>::digits10 / 8 + 1);
+   for(unsigned i = 0; i < n; ++i)
+   {
+      result *= 100000000;
+      result += gen() % 100000000;
+   }
+   result = ldexp(result, static_cast<int>(gen() % 400) - 200);
+   return (gen() & 1u) ? T(-result) : result;
+}
+
+template <class T>
+void test_float_values(const T& a, const T& b, const T& c)
+{
+   //
+   // The reference result is computed in twice the precision, where the product is exact:
+   //
+   typedef boost::multiprecision::number<boost::multiprecision::cpp_dec_float<std::numeric_limits<T>::digits10 * 2 + 20>, boost::multiprecision::et_off> ref_type;
+   ref_type p = ref_type(a) * ref_type(b);
+   ref_type tol = ref_type(std::numeric_limits<T>::epsilon()) * 4 * (abs(ref_type(c)) + abs(p));
+   T r = c;
+   r += a * b;
+   BOOST_CHECK_LE(abs(ref_type(r) - (ref_type(c) + p)), tol);
+   r = c;
+   r -= a * b;
+   BOOST_CHECK_LE(abs(ref_type(r) - (ref_type(c) - p)), tol);
+}
+
+template <class T>
+void test_float_carry(const char* c, const char* a)
+{
+   T u(a), r(c), s(c);
+   s = -s;
+   T p = u * u;
+   T expect(r + p);
+   r += u * u;
+   BOOST_CHECK_EQUAL(r, expect);
+   expect = s - p;
+   s -= u * u;
+   BOOST_CHECK_EQUAL(s, expect);
+}
+
+template <class T>
+void test_float()
+{
+   for(unsigned i = 0; i < 20000; ++i)
+   {
+      T a = generate_random_float<T>();
+      T b = generate_random_float<T>();
+      T c = generate_random_float<T>();
+      test_float_values(a, b, c);
+      // Accumulators which nearly, or exactly, cancel the product, and which are smaller than it:
+      test_float_values(a, b, T(a * b * (1 + T(gen() % 3) / 1000000000)));
+      test_float_values(a, b, T(-a * b));
+      test_float_values(a, b, T(a * b / 3));
+   }
+   //
+   // Exact results:
+   //
+   T a(123456789), b(987654321), c("121932631112635269");
+   T r = c;
+   r -= a * b;
+   BOOST_CHECK_EQUAL(r, 0);
+   BOOST_CHECK(!(r.backend().isneg)());
+   r = 1;
+   r += a * b;
+   BOOST_CHECK_EQUAL(r, T("121932631112635270"));
+   r = 1;
+   r -= a * b;
+   BOOST_CHECK_EQUAL(r, T("-121932631112635268"));
+   // Leading elements near 10^8, where the carry out of the product and the accumulator
+   // together fill more than one element:
+   test_float_carry<T>("99999999.9", "99999999.99999999999999999999999999999999999999999");
+   test_float_carry<T>("99999999.9", "99999999.9999");
+   test_float_carry<T>("99999999.99999999", "99999999.99999999");
+   test_float_carry<T>("9999999999999999.9", "9999999999999999.99999999");
+   // Cancellation to exactly zero, and to less than min(), which is flushed to zero as it is
+   // by multiplication, while just above min() the result is exact:
+   r = T(a * b) - 1;
+   r += a * b;
+   r -= a * b;
+   r -= a * b;
+   BOOST_CHECK_EQUAL(r, -1);
+   T m = T((std::numeric_limits<T>::min)() * 1e10);
+   r = -m;
+   r += m * T(1);
+   BOOST_CHECK_EQUAL(r, 0);
+   BOOST_CHECK(!(r.backend().isneg)());
+   r = -m;
+   r += m * T(T(1) + T("1e-9"));
+   BOOST_CHECK_EQUAL(r, T(m * T("1e-9")));
+   BOOST_CHECK(r >= (std::numeric_limits<T>::min)());
+   r = m;
+   r -= m * T("1.000000000000001");
+   BOOST_CHECK_EQUAL(r, 0);
+   BOOST_CHECK(!(r.backend().isneg)());
+   // An accumulator of reduced precision only takes the product to that precision:
+   c = T(1) / 3;
+   a = T(2) / 7;
+   b = T(5) / 11;
+   r = c;
+   r.backend().precision(20);
+   r += a * b;
+   BOOST_CHECK_CLOSE_FRACTION(r, T(c + a * b), T(1e-18));
+   r = c;
+   r.backend().precision(20);
+   r -= a * b;
+   BOOST_CHECK_CLOSE_FRACTION(r, T(c - a * b), T(1e-18));
+   // Special values:
+   if(std::numeric_limits<T>::has_infinity)
+   {
+      r = std::numeric_limits<T>::infinity();
+      r -= a * b;
+      BOOST_CHECK_EQUAL(r, std::numeric_limits<T>::infinity());
+      r = 2;
+      r += a * std::numeric_limits<T>::infinity();
+      BOOST_CHECK_EQUAL(r, std::numeric_limits<T>::infinity());
+   }
+   r = (std::numeric_limits<T>::max)();
+   r += r * 2;
+   BOOST_CHECK_EQUAL(r, std::numeric_limits<T>::infinity());
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test_int<cpp_int>(4000);
+   test_int<checked_cpp_int>(4000);
+   test_int<int1024_t>(300);
+
+   test_float<cpp_dec_float_50>();
+   test_float<cpp_dec_float_100>();
+   test_float<number<cpp_dec_float<25> > >();
+   test_float<number<cpp_dec_float<50, long long, std::allocator<char> > > >();
+
+   return boost::report_errors();
+}
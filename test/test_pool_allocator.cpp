@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Check that cpp_int_pooled gives the same results as cpp_int, including for values larger
+// than the largest pooled block, that blocks are reused, and that blocks may be freed on a
+// different thread to the one which allocated them.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <vector>
+#include <list>
+#include "test.hpp"
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+#include <thread>
+#endif
+
+static boost::random::mt19937 gen;
+
+boost::multiprecision::cpp_int generate_random(unsigned bits_wanted)
+{
+   boost::multiprecision::cpp_int result = 0;
+   for(unsigned bits = 0; bits < bits_wanted; bits += 32)
+   {
+      result <<= 32;
+      result |= gen();
+   }
+   return result;
+}
+
+void test_values(const boost::multiprecision::cpp_int& a, const boost::multiprecision::cpp_int& b)
+{
+   using namespace boost::multiprecision;
+   cpp_int_pooled x(a), y(b);
+   BOOST_CHECK_EQUAL(cpp_int(x), a);
+   BOOST_CHECK_EQUAL(cpp_int(x + y), cpp_int(a + b));
+   BOOST_CHECK_EQUAL(cpp_int(x - y), cpp_int(a - b));
+   BOOST_CHECK_EQUAL(cpp_int(x * y), cpp_int(a * b));
+   BOOST_CHECK_EQUAL(cpp_int(x * x - y * y), cpp_int(a * a - b * b));
+   if(b != 0)
+   {
+      BOOST_CHECK_EQUAL(cpp_int(x / y), cpp_int(a / b));
+      BOOST_CHECK_EQUAL(cpp_int(x % y), cpp_int(a % b));
+   }
+   BOOST_CHECK_EQUAL(cpp_int(gcd(x, y)), cpp_int(gcd(a, b)));
+   BOOST_CHECK_EQUAL(cpp_int(x << 1000), cpp_int(a << 1000));
+   BOOST_CHECK_EQUAL(x.str(), a.str());
+   // Copies, moves and swaps between values of different capacities:
+   cpp_int_pooled z(x);
+   z = y;
+   BOOST_CHECK_EQUAL(cpp_int(z), b);
+   z = x * y;
+   z.swap(x);
+   BOOST_CHECK_EQUAL(cpp_int(x), cpp_int(a * b));
+   BOOST_CHECK_EQUAL(cpp_int(z), a);
+#ifndef BOOST_NO_CXX11_RVALUE_REFERENCES
+   cpp_int_pooled w(std::move(z));
+   BOOST_CHECK_EQUAL(cpp_int(w), a);
+   z = std::move(x);
+   BOOST_CHECK_EQUAL(cpp_int(z), cpp_int(a * b));
+#endif
+}
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+struct make_values
+{
+   std::vector<boost::multiprecision::cpp_int_pooled>* values;
+   void operator()()
+   {
+      for(unsigned i = 0; i < values->size(); ++i)
+      {
+         (*values)[i] = 1;
+         (*values)[i] <<= 64 * (i % 200);
+         (*values)[i] -= 1;
+      }
+   }
+};
+#endif
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   for(unsigned bits = 64; bits < 200000; bits = bits * 3 / 2)
+   {
+      for(unsigned i = 0; i < 3; ++i)
+      {
+         cpp_int a = generate_random(bits);
+         cpp_int b = generate_random(bits / 2 + gen() % bits);
+         test_values(a, b);
+         test_values(-a, b);
+         test_values(a, 0);
+      }
+   }
+   //
+   // The allocator meets the usual requirements, and recycles blocks:
+   //
+   std::vector<int, pool_allocator<int> > v;
+   std::list<double, pool_allocator<double> > l;
+   for(int i = 0; i < 10000; ++i)
+   {
+      v.push_back(i);
+      l.push_back(i);
+   }
+   BOOST_CHECK_EQUAL(v[9999], 9999);
+   BOOST_CHECK_EQUAL(l.back(), 9999);
+   BOOST_CHECK(pool_allocator<int>() == pool_allocator<double>());
+   pool_allocator<limb_type> alloc;
+   limb_type* p = alloc.allocate(10);
+   alloc.deallocate(p, 10);
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+   // Any request in the same size class gets the same block back:
+   limb_type* q = alloc.allocate(12);
+   BOOST_CHECK_EQUAL(p, q);
+   alloc.deallocate(q, 12);
+#endif
+   // Too large to pool:
+   p = alloc.allocate(BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK);
+   p[BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK - 1] = 0;
+   alloc.deallocate(p, BOOST_MP_POOL_ALLOCATOR_MAX_BLOCK);
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD)
+   //
+   // Values created on other threads, and destroyed on this one:
+   //
+   for(unsigned i = 0; i < 4; ++i)
+   {
+      std::vector<cpp_int_pooled> values(1000);
+      make_values f = { &values };
+      std::thread t(f);
+      t.join();
+      for(unsigned j = 0; j < values.size(); ++j)
+         BOOST_CHECK_EQUAL(cpp_int(values[j]), cpp_int((cpp_int(1) << (64 * (j % 200))) - 1));
+   }
+#endif
+
+   return boost::report_errors();
+}
@@ -0,0 +1,130 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Compare trial_division_sieve, and the trial division used by the primality tests, to
+// direct division by each prime, for sizes either side of where the remainder tree is used.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/multiprecision/miller_rabin.hpp>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/independent_bits.hpp>
+#include "test.hpp"
+
+template <class I>
+bool has_factor(const I& n, unsigned bound)
+{
+   using namespace boost::multiprecision;
+   if(bound >= 2 && !bit_test(n, 0) && (n != 2))
+      return true;
+   const std::vector<unsigned>& primes = boost::multiprecision::detail::sieve_primes();
+   for(unsigned i = 0; (i < primes.size()) && (primes[i] <= bound); ++i)
+   {
+      if((integer_modulus(n, primes[i]) == 0) && (n != primes[i]))
+         return true;
+   }
+   return false;
+}
+
+template <class I>
+void test_walk(const I& n, unsigned bound, unsigned step, unsigned count)
+{
+   using namespace boost::multiprecision;
+   boost::multiprecision::trial_division_sieve<I> sieve(n, bound);
+   BOOST_CHECK_EQUAL(sieve.bound(), bound);
+   I value(n);
+   for(unsigned i = 0; i < count; ++i)
+   {
+      BOOST_CHECK_EQUAL(sieve.value(), value);
+      BOOST_CHECK_EQUAL(sieve.has_small_factor(), has_factor(value, bound));
+      sieve += step;
+      value += step;
+   }
+   const std::vector<unsigned>& primes = boost::multiprecision::detail::sieve_primes();
+   for(unsigned i = 0; (i < primes.size()) && (primes[i] <= bound); ++i)
+      BOOST_CHECK_EQUAL(sieve.residue(i), integer_modulus(value, primes[i]));
+}
+
+template <class I>
+void test(unsigned max_bits)
+{
+   using namespace boost::multiprecision;
+
+   boost::random::independent_bits_engine<boost::random::mt19937, 64, boost::uint64_t> gen;
+
+   for(unsigned bits = 64; bits <= max_bits; bits *= 2)
+   {
+      for(unsigned i = 0; i < 20; ++i)
+      {
+         I n(gen());
+         while(msb(n) + 64 < bits)
+         {
+            // Two half shifts, so that a 64-bit I, which never gets here, builds warning free:
+            n <<= 32;
+            n <<= 32;
+            n |= gen();
+         }
+         n |= 1;
+         //
+         // check_small_factors against direct trial division, with a known factor near
+         // the limit used for this size:
+         //
+         unsigned limit = boost::multiprecision::detail::trial_division_limit(msb(n));
+         BOOST_CHECK_EQUAL(boost::multiprecision::detail::check_small_factors(n), !has_factor(n, limit));
+         const std::vector<unsigned>& primes = boost::multiprecision::detail::sieve_primes();
+         unsigned p = *(std::upper_bound(primes.begin(), primes.end(), limit) - 1 - i);
+         I m(n - integer_modulus(n, p));
+         if(!bit_test(m, 0))
+            m += p;
+         BOOST_CHECK_EQUAL(boost::multiprecision::detail::check_small_factors(m), !has_factor(m, limit));
+         BOOST_CHECK(!boost::multiprecision::detail::check_small_factors(m));
+         //
+         // The default bound is the one used by the primality tests:
+         //
+         trial_division_sieve<I> sieve(m);
+         BOOST_CHECK_EQUAL(sieve.bound(), limit);
+         BOOST_CHECK(sieve.has_small_factor());
+         sieve += 2 * p;
+         BOOST_CHECK(sieve.has_small_factor());
+         BOOST_CHECK_EQUAL(sieve.value(), I(m + 2 * p));
+         //
+         // Walks with various bounds and steps:
+         //
+         test_walk(n, BOOST_MP_TRIAL_DIVISION_BOUND, 2, 50);
+         test_walk(n, 227, 2, 50);
+         test_walk(n, 65535, 2, 10);
+         test_walk(I(n - 1), 1000, 1, 50);
+         test_walk(n, 5000, 70000, 10);
+      }
+   }
+   //
+   // Small values, which may themselves be one of the primes:
+   //
+   test_walk(I(0), 1000, 1, 2000);
+   test_walk(I(0), 2, 1, 10);
+   test_walk(I(0), 0, 1, 10);
+   test_walk(I(1), 65535, 2, 40000);
+   for(unsigned n = 229; n < 70000; n += 2)
+      BOOST_CHECK_EQUAL(boost::multiprecision::detail::check_small_factors(I(n)), !has_factor(I(n), boost::multiprecision::detail::trial_division_limit(msb(I(n)))));
+   BOOST_CHECK_THROW(trial_division_sieve<I>(I(1), 65536), std::domain_error);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_int>(8192);
+   test<boost::uint64_t>(64);
+   test<uint256_t>(256);
+   test<uint1024_t>(1024);
+   test<number<cpp_int_backend<2048, 2048, unsigned_magnitude, checked, void> > >(2048);
+   test<number<cpp_int_backend<>, et_off> >(4096);
+
+   return boost::report_errors();
+}
@@ -0,0 +1,170 @@
+///////////////////////////////////////////////////////////////
+//  Copyright 2012 John Maddock. Distributed under the Boost
+//  Software License, Version 1.0. (See accompanying file
+//  LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_
+//
+// Check that the functions which take their temporaries from a workspace give the same
+// results whether the workspace is fresh, full of stale values, or supplied by the caller,
+// and that every temporary is handed back.
+//
+
+#ifdef _MSC_VER
+#  define _SCL_SECURE_NO_WARNINGS
+#endif
+
+#include <boost/multiprecision/cpp_dec_float.hpp>
+#include <boost/multiprecision/cpp_bin_float.hpp>
+#include <boost/multiprecision/cpp_int.hpp>
+#include <vector>
+#include "test.hpp"
+
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) && defined(BOOST_MP_USING_THREAD_LOCAL)
+#include <thread>
+#endif
+
+template <class T>
+std::vector<T> evaluate(const std::vector<T>& args)
+{
+   std::vector<T> results;
+   for(unsigned i = 0; i < args.size(); ++i)
+   {
+      const T& x = args[i];
+      results.push_back(exp(x));
+      results.push_back(log(x));
+      results.push_back(pow(x, args[(i + 1) % args.size()]));
+      results.push_back(sin(x));
+      results.push_back(cos(x));
+      results.push_back(tan(x));
+      results.push_back(atan(x));
+      results.push_back(asin(x / 4));
+      results.push_back(sinh(x));
+      results.push_back(tanh(x));
+   }
+   return results;
+}
+
+template <class T>
+void check_equal(const std::vector<T>& a, const std::vector<T>& b)
+{
+   BOOST_CHECK_EQUAL(a.size(), b.size());
+   for(unsigned i = 0; i < a.size(); ++i)
+   {
+      // log and pow of the negative arguments are NaN:
+      if((boost::math::isnan)(a[i]))
+      {
+         BOOST_CHECK((boost::math::isnan)(b[i]));
+      }
+      else
+      {
+         BOOST_CHECK_EQUAL(a[i], b[i]);
+      }
+   }
+}
+
+template <class T>
+void test()
+{
+   typedef typename T::backend_type backend_type;
+
+   std::vector<T> args;
+   args.push_back(T(1) / 3);
+   args.push_back(T(2) / 7);
+   args.push_back(T(3));
+   args.push_back(T(11) / 4);
+   args.push_back(T(-5) / 8);
+   args.push_back(T(17));
+   args.push_back(T(-25) / 2);
+
+   std::vector<T> reference;
+   {
+      //
+      // With a fresh workspace of our own:
+      //
+      boost::multiprecision::workspace<backend_type> w;
+      boost::multiprecision::scoped_workspace<backend_type> guard(w);
+      reference = evaluate(args);
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+      BOOST_CHECK(w.size() > 0);
+#endif
+      BOOST_CHECK_EQUAL(w.in_use(), 0u);
+      //
+      // Again, now that every temporary holds some leftover value:
+      //
+      check_equal(evaluate(args), reference);
+      BOOST_CHECK_EQUAL(w.in_use(), 0u);
+      std::size_t n = w.size();
+      w.shrink();
+      BOOST_CHECK_EQUAL(w.size(), 0u);
+      w.reserve(n + 5);
+      BOOST_CHECK_EQUAL(w.size(), n + 5);
+      check_equal(evaluate(args), reference);
+      BOOST_CHECK_EQUAL(w.size(), n + 5);
+      //
+      // Nested, and restored afterwards:
+      //
+      {
+         boost::multiprecision::workspace<backend_type> w2;
+         boost::multiprecision::scoped_workspace<backend_type> guard2(w2);
+         check_equal(evaluate(args), reference);
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+         BOOST_CHECK(w2.size() > 0);
+#endif
+      }
+      w.shrink();
+      check_equal(evaluate(args), reference);
+#ifdef BOOST_MP_USING_THREAD_LOCAL
+      BOOST_CHECK(w.size() > 0);
+#endif
+   }
+   //
+   // With the thread's default workspace:
+   //
+   check_equal(evaluate(args), reference);
+   check_equal(evaluate(args), reference);
+#if !defined(BOOST_NO_CXX11_HDR_THREAD) && defined(BOOST_MP_USING_THREAD_LOCAL)
+   //
+   // And on other threads, each with a default workspace of its own:
+   //
+   std::vector<T> r1, r2;
+   std::thread t1([&]() { r1 = evaluate(args); r1 = evaluate(args); });
+   std::thread t2([&]() { r2 = evaluate(args); });
+   t1.join();
+   t2.join();
+   check_equal(r1, reference);
+   check_equal(r2, reference);
+#endif
+}
+
+template <class T>
+void test_powm()
+{
+   typedef typename T::backend_type backend_type;
+
+   boost::multiprecision::workspace<backend_type> w;
+   boost::multiprecision::scoped_workspace<backend_type> guard(w);
+   T m = 1000003u;
+   T b = 12345u;
+   T r = 1;
+   for(unsigned e = 0; e < 200; ++e)
+   {
+      BOOST_CHECK_EQUAL(T(powm(b, e, m)), r);
+      BOOST_CHECK_EQUAL(T(powm(b, T(e), m)), r);
+      r = (r * b) % m;
+   }
+   BOOST_CHECK_EQUAL(w.in_use(), 0u);
+}
+
+int main()
+{
+   using namespace boost::multiprecision;
+
+   test<cpp_dec_float_50>();
+   test<number<cpp_dec_float<100, boost::int32_t, std::allocator<void> > > >();
+   test<number<cpp_dec_float<50, boost::int32_t, pool_allocator<void> >, et_off> >();
+   test<cpp_bin_float_50>();
+   test<number<cpp_bin_float<200>, et_off> >();
+   test_powm<int128_t>();
+   test_powm<number<cpp_int_backend<64, 64, unsigned_magnitude, unchecked, void> > >();
+
+   return boost::report_errors();
+}